@@ -0,0 +1,575 @@
+// Local
+#include <Barcode.hpp>
+#include <BatchPricer.hpp>
+#include <Checkout.hpp>
+#include <Item.hpp>
+#include <PricingOverlay.hpp>
+#include <PricingScheme.hpp>
+#include <PricingTable.hpp>
+#include <ScanJournal.hpp>
+// Standard Library
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+///@brief Micro and macro benchmarks for the checkout classes.
+///
+/// Usage: bench [--items N] [--carts N] [--cart-size N] [--buy-x-get-y PERCENT]
+///              [--bundle PERCENT] [--threads N] [--seed N] [--json PATH]
+///              [--journal PATH]
+///
+/// Generates a synthetic catalog and synthetic carts, then reports for each benchmark
+/// the mean and percentile (over samples) time per operation, heap allocations per
+/// operation and throughput. With --json the results are also written as JSON so they
+/// can be compared between versions. With --journal the scans are also measured with a
+/// scan journal in the given file.
+
+// Allocation counting
+namespace
+{
+    /// Every heap allocation made by the process
+    std::atomic<std::uint64_t> g_NumberOfAllocations(0);
+} // namespace
+
+void *operator new(std::size_t i_Size)
+{
+    g_NumberOfAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *memory = std::malloc(i_Size ? i_Size : 1))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+void *operator new[](std::size_t i_Size)
+{
+    return operator new(i_Size);
+}
+/// std::pmr::new_delete_resource() allocates through the aligned overloads
+void *operator new(std::size_t i_Size, std::align_val_t i_Alignment)
+{
+    g_NumberOfAllocations.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t alignment = static_cast<std::size_t>(i_Alignment);
+    if (void *memory = std::aligned_alloc(alignment, (i_Size + alignment - 1) / alignment * alignment))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+void *operator new[](std::size_t i_Size, std::align_val_t i_Alignment)
+{
+    return operator new(i_Size, i_Alignment);
+}
+void operator delete(void *i_Memory) noexcept
+{
+    std::free(i_Memory);
+}
+void operator delete[](void *i_Memory) noexcept
+{
+    std::free(i_Memory);
+}
+void operator delete(void *i_Memory, std::size_t) noexcept
+{
+    std::free(i_Memory);
+}
+void operator delete[](void *i_Memory, std::size_t) noexcept
+{
+    std::free(i_Memory);
+}
+void operator delete(void *i_Memory, std::align_val_t) noexcept
+{
+    std::free(i_Memory);
+}
+void operator delete[](void *i_Memory, std::align_val_t) noexcept
+{
+    std::free(i_Memory);
+}
+void operator delete(void *i_Memory, std::size_t, std::align_val_t) noexcept
+{
+    std::free(i_Memory);
+}
+void operator delete[](void *i_Memory, std::size_t, std::align_val_t) noexcept
+{
+    std::free(i_Memory);
+}
+// End of allocation counting
+
+namespace
+{
+    ///@brief Size and shape of the generated data
+    struct Config
+    {
+        std::size_t numberOfItems = 100000;
+        std::size_t numberOfCarts = 20000;
+        std::size_t cartSize = 30;
+        int buyXGetYPercent = 10;
+        int bundlePercent = 10;
+        unsigned numberOfThreads = 0;
+        unsigned seed = 1983;
+        std::string jsonPath;
+        std::string journalPath;
+    };
+
+    ///@brief Result of one benchmark
+    struct Result
+    {
+        std::string name;
+        std::uint64_t numberOfOperations;
+        double meanNanoseconds;
+        double p50Nanoseconds;
+        double p90Nanoseconds;
+        double p99Nanoseconds;
+        double allocationsPerOperation;
+        double operationsPerSecond;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    ///@brief Runs i_Sample i_NumberOfSamples times. Each call does i_OperationsPerSample(i)
+    /// operations, percentiles are of the time per operation of each sample.
+    Result measure(
+        const std::string &i_Name,
+        const std::size_t i_NumberOfSamples,
+        const std::function<std::size_t(std::size_t)> &i_OperationsPerSample,
+        const std::function<void(std::size_t)> &i_Sample)
+    {
+        std::vector<double> nanosecondsPerOperation;
+        nanosecondsPerOperation.reserve(i_NumberOfSamples);
+        std::uint64_t numberOfOperations = 0;
+        double totalNanoseconds = 0;
+
+        const std::uint64_t allocationsBefore = g_NumberOfAllocations.load();
+        for (std::size_t sample = 0; sample < i_NumberOfSamples; ++sample)
+        {
+            const std::size_t operations = std::max<std::size_t>(1, i_OperationsPerSample(sample));
+            const Clock::time_point start = Clock::now();
+            i_Sample(sample);
+            const double nanoseconds = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            nanosecondsPerOperation.push_back(nanoseconds / operations);
+            numberOfOperations += operations;
+            totalNanoseconds += nanoseconds;
+        }
+        const std::uint64_t numberOfAllocations = g_NumberOfAllocations.load() - allocationsBefore;
+
+        std::sort(nanosecondsPerOperation.begin(), nanosecondsPerOperation.end());
+        auto percentile = [&](const double i_Fraction) {
+            return nanosecondsPerOperation[static_cast<std::size_t>(i_Fraction * (nanosecondsPerOperation.size() - 1))];
+        };
+        return Result{
+            i_Name,
+            numberOfOperations,
+            totalNanoseconds / numberOfOperations,
+            percentile(0.50),
+            percentile(0.90),
+            percentile(0.99),
+            static_cast<double>(numberOfAllocations) / numberOfOperations,
+            numberOfOperations / (totalNanoseconds / 1e9)};
+    }
+
+    ///@brief Generates a catalog with the configured mix of deals.
+    /// Bundles are made of neighbouring items.
+    PricingScheme generateCatalog(const Config &i_Config, std::vector<std::string> &o_Ids)
+    {
+        std::mt19937 random(i_Config.seed);
+        const int idWidth = std::max<int>(4, std::to_string(i_Config.numberOfItems).size());
+        o_Ids.clear();
+        for (std::size_t item = 0; item < i_Config.numberOfItems; ++item)
+        {
+            std::string id = std::to_string(item);
+            o_Ids.push_back(std::string(idWidth - id.size(), '0') + id);
+        }
+
+        /// Class 1 is taxed, class 0 isn't
+        PricingScheme ps;
+        ps.setTaxRate(TaxClass(1), TaxRate(925));
+        for (std::size_t item = 0; item < i_Config.numberOfItems; ++item)
+        {
+            const Money unitPrice(50 + random() % 5000);
+            const TaxClass tax(0 == random() % 4 ? 1 : 0);
+            const int deal = static_cast<int>(random() % 100);
+            if (deal < i_Config.bundlePercent && item + 1 < i_Config.numberOfItems)
+            {
+                const Money bundlePrice(unitPrice.getCents() + random() % 500);
+                ps.addItem(Item(o_Ids[item], unitPrice, {o_Ids[item + 1], bundlePrice}, tax));
+                ps.addItem(Item(o_Ids[item + 1], Money(50 + random() % 5000), {o_Ids[item], bundlePrice}, tax));
+                ++item;
+            }
+            else if (deal < i_Config.bundlePercent + i_Config.buyXGetYPercent)
+            {
+                ps.addItem(Item(o_Ids[item], unitPrice, tax, {1 + static_cast<int>(random() % 3), 1}));
+            }
+            else
+            {
+                ps.addItem(Item(o_Ids[item], unitPrice, tax));
+            }
+        }
+        return ps;
+    }
+
+    ///@brief Generates carts of around the configured size. Popular items (low IDs)
+    /// are picked more often, like in a real store.
+    std::vector<BatchPricer::Cart> generateCarts(const Config &i_Config, const std::vector<std::string> &i_Ids)
+    {
+        std::mt19937 random(i_Config.seed + 1);
+        std::geometric_distribution<std::size_t> popularity(20.0 / std::max<std::size_t>(20, i_Ids.size()));
+        std::uniform_int_distribution<std::size_t> cartSize(1, std::max<std::size_t>(1, 2 * i_Config.cartSize - 1));
+        std::vector<BatchPricer::Cart> carts(i_Config.numberOfCarts);
+        for (auto &cart : carts)
+        {
+            cart.resize(cartSize(random));
+            for (auto &id : cart)
+            {
+                id = i_Ids[popularity(random) % i_Ids.size()];
+            }
+        }
+        return carts;
+    }
+
+    void printResult(const Result &i_Result)
+    {
+        std::printf("%-28s %12.1f %10.1f %10.1f %10.1f %10.2f %14.0f\n",
+                    i_Result.name.c_str(),
+                    i_Result.meanNanoseconds,
+                    i_Result.p50Nanoseconds,
+                    i_Result.p90Nanoseconds,
+                    i_Result.p99Nanoseconds,
+                    i_Result.allocationsPerOperation,
+                    i_Result.operationsPerSecond);
+    }
+
+    void writeJson(const Config &i_Config, const std::vector<Result> &i_Results)
+    {
+        std::ofstream json(i_Config.jsonPath);
+        json << "{\n  \"config\": {"
+             << "\"items\": " << i_Config.numberOfItems
+             << ", \"carts\": " << i_Config.numberOfCarts
+             << ", \"cart_size\": " << i_Config.cartSize
+             << ", \"buy_x_get_y_percent\": " << i_Config.buyXGetYPercent
+             << ", \"bundle_percent\": " << i_Config.bundlePercent
+             << ", \"threads\": " << i_Config.numberOfThreads
+             << ", \"seed\": " << i_Config.seed << "},\n  \"results\": [\n";
+        for (std::size_t i = 0; i < i_Results.size(); ++i)
+        {
+            const Result &result = i_Results[i];
+            json << "    {\"name\": \"" << result.name << "\""
+                 << ", \"operations\": " << result.numberOfOperations
+                 << ", \"ns_per_op\": " << result.meanNanoseconds
+                 << ", \"p50_ns\": " << result.p50Nanoseconds
+                 << ", \"p90_ns\": " << result.p90Nanoseconds
+                 << ", \"p99_ns\": " << result.p99Nanoseconds
+                 << ", \"allocs_per_op\": " << result.allocationsPerOperation
+                 << ", \"ops_per_sec\": " << result.operationsPerSecond << "}"
+                 << (i + 1 < i_Results.size() ? ",\n" : "\n");
+        }
+        json << "  ]\n}\n";
+        if (!json)
+        {
+            throw std::runtime_error("Can't write " + i_Config.jsonPath);
+        }
+    }
+
+    ///@brief Parses the command line into o_Config
+    ///@return false if the command line is invalid
+    bool parseArguments(int argc, char *argv[], Config &o_Config)
+    {
+        for (int i = 1; i + 1 < argc; i += 2)
+        {
+            const std::string option = argv[i];
+            const std::string value = argv[i + 1];
+            if ("--items" == option)
+            {
+                o_Config.numberOfItems = std::stoul(value);
+            }
+            else if ("--carts" == option)
+            {
+                o_Config.numberOfCarts = std::stoul(value);
+            }
+            else if ("--cart-size" == option)
+            {
+                o_Config.cartSize = std::stoul(value);
+            }
+            else if ("--buy-x-get-y" == option)
+            {
+                o_Config.buyXGetYPercent = std::stoi(value);
+            }
+            else if ("--bundle" == option)
+            {
+                o_Config.bundlePercent = std::stoi(value);
+            }
+            else if ("--threads" == option)
+            {
+                o_Config.numberOfThreads = static_cast<unsigned>(std::stoul(value));
+            }
+            else if ("--seed" == option)
+            {
+                o_Config.seed = static_cast<unsigned>(std::stoul(value));
+            }
+            else if ("--json" == option)
+            {
+                o_Config.jsonPath = value;
+            }
+            else if ("--journal" == option)
+            {
+                o_Config.journalPath = value;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        return 0 == argc % 2 ? false : o_Config.numberOfItems > 0 && o_Config.numberOfCarts > 0;
+    }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Config config;
+    if (!parseArguments(argc, argv, config))
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--items N] [--carts N] [--cart-size N] [--buy-x-get-y PERCENT]"
+                     " [--bundle PERCENT] [--threads N] [--seed N] [--json PATH]"
+                     " [--journal PATH]"
+                  << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> ids;
+    const PricingScheme ps = generateCatalog(config, ids);
+    const std::vector<BatchPricer::Cart> carts = generateCarts(config, ids);
+    const auto table = std::make_shared<const PricingTable>(ps.compile());
+    const std::size_t numberOfRepeats = 10;
+
+    std::vector<Result> results;
+    std::size_t itemsPerSample = 1024;
+    const std::size_t numberOfAddSamples = (config.numberOfItems + itemsPerSample - 1) / itemsPerSample;
+    {
+        PricingScheme built;
+        const auto &items = ps.getItemMap();
+        auto next = items.begin();
+        results.push_back(measure(
+            "PricingScheme::addItem",
+            numberOfAddSamples,
+            [&](std::size_t i_Sample) { return std::min(itemsPerSample, config.numberOfItems - i_Sample * itemsPerSample); },
+            [&](std::size_t) {
+                for (std::size_t i = 0; i < itemsPerSample && items.end() != next; ++i, ++next)
+                {
+                    built.addItem(next->second);
+                }
+            }));
+    }
+    results.push_back(measure(
+        "PricingScheme copy",
+        numberOfRepeats,
+        [](std::size_t) { return 1; },
+        [&](std::size_t) {
+            PricingScheme copy(ps);
+            (void)copy;
+        }));
+    results.push_back(measure(
+        "PricingScheme::compile",
+        numberOfRepeats,
+        [](std::size_t) { return 1; },
+        [&](std::size_t) { (void)ps.compile(); }));
+    {
+        /// The same # of items with EAN-13 IDs, looked up by ID and by barcode
+        PricingScheme gtinScheme;
+        std::vector<std::string> gtins;
+        std::vector<std::uint64_t> keys;
+        for (std::size_t item = 0; item < config.numberOfItems; ++item)
+        {
+            std::string digits = std::to_string(item);
+            digits = "400" + std::string(9 - digits.size(), '0') + digits;
+            gtins.push_back(digits + Barcode::computeCheckDigit(digits));
+            keys.push_back(std::stoull(gtins.back()));
+            gtinScheme.addItem(Item(gtins.back(), Money(100), TaxClass()));
+        }
+        std::shared_ptr<const PricingTable> gtinTable;
+        results.push_back(measure(
+            "compile (EAN-13 IDs)",
+            1,
+            [](std::size_t) { return 1; },
+            [&](std::size_t) { gtinTable = std::make_shared<const PricingTable>(gtinScheme.compile()); }));
+        const std::size_t lookupsPerSample = 1000;
+        std::mt19937 random(config.seed);
+        volatile PricingTable::Index found = 0;
+        results.push_back(measure(
+            "PricingTable::find (EAN-13)",
+            carts.size(),
+            [&](std::size_t) { return lookupsPerSample; },
+            [&](std::size_t) {
+                for (std::size_t i = 0; i < lookupsPerSample; ++i)
+                {
+                    found = gtinTable->find(gtins[random() % gtins.size()]);
+                }
+            }));
+        results.push_back(measure(
+            "PricingTable::findBarcode",
+            carts.size(),
+            [&](std::size_t) { return lookupsPerSample; },
+            [&](std::size_t) {
+                for (std::size_t i = 0; i < lookupsPerSample; ++i)
+                {
+                    found = gtinTable->findBarcode(keys[random() % keys.size()]);
+                }
+            }));
+    }
+    results.push_back(measure(
+        "Checkout::scan",
+        carts.size(),
+        [&](std::size_t i_Cart) { return carts[i_Cart].size(); },
+        [&](std::size_t i_Cart) {
+            Checkout c(table);
+            for (const auto &id : carts[i_Cart])
+            {
+                c.scan(id);
+            }
+        }));
+    {
+        const std::size_t callsPerSample = 100;
+        Checkout c(table);
+        std::size_t nextCart = 0;
+        volatile int total = 0;
+        results.push_back(measure(
+            "Checkout::getTotal",
+            carts.size(),
+            [&](std::size_t) { return callsPerSample; },
+            [&](std::size_t) {
+                for (std::size_t i = 0; i < callsPerSample; ++i)
+                {
+                    total = c.getTotal();
+                }
+                c.scan(carts[nextCart++ % carts.size()][0]);
+            }));
+    }
+    results.push_back(measure(
+        "Checkout (whole cart)",
+        carts.size(),
+        [](std::size_t) { return 1; },
+        [&](std::size_t i_Cart) {
+            Checkout c(table);
+            for (const auto &id : carts[i_Cart])
+            {
+                c.scan(id);
+            }
+            volatile int total = c.getTotal();
+            (void)total;
+        }));
+    {
+        /// Member prices of a customer for a few dozen items, layered over the catalog
+        PricingOverlay overlay;
+        for (std::size_t item = 0; item < 32; ++item)
+        {
+            const auto &cart = carts[item % carts.size()];
+            overlay.setUnitPrice(cart[item % cart.size()], Money(99));
+        }
+        results.push_back(measure(
+            "PricingOverlay::compile",
+            carts.size(),
+            [](std::size_t) { return 1; },
+            [&](std::size_t) { (void)overlay.compile(*table); }));
+    }
+    {
+        std::pmr::unsynchronized_pool_resource lanePool;
+        Checkout c(table, &lanePool);
+        results.push_back(measure(
+            "Checkout (pooled, reset)",
+            carts.size(),
+            [](std::size_t) { return 1; },
+            [&](std::size_t i_Cart) {
+                c.reset();
+                for (const auto &id : carts[i_Cart])
+                {
+                    c.scan(id);
+                }
+                volatile int total = c.getTotal();
+                (void)total;
+            }));
+    }
+    if (!config.journalPath.empty())
+    {
+        /// Same lane loop with and without the journal, so the difference is its overhead
+        std::pmr::unsynchronized_pool_resource lanePool;
+        ScanJournal journal(config.journalPath, 4 * config.cartSize);
+        for (ScanJournal *scanJournal : {static_cast<ScanJournal *>(nullptr), &journal})
+        {
+            Checkout c(table, &lanePool);
+            c.setJournal(scanJournal);
+            results.push_back(measure(
+                scanJournal ? "Checkout::scan (journaled)" : "Checkout::scan (pooled)",
+                carts.size(),
+                [&](std::size_t i_Cart) { return carts[i_Cart].size(); },
+                [&](std::size_t i_Cart) {
+                    c.reset();
+                    for (const auto &id : carts[i_Cart])
+                    {
+                        c.scan(id);
+                    }
+                }));
+        }
+        journal.commit();
+    }
+    {
+        const std::size_t callsPerSample = 10;
+        std::vector<std::unique_ptr<Checkout>> scanned;
+        for (const auto &cart : carts)
+        {
+            scanned.emplace_back(new Checkout(table));
+            for (const auto &id : cart)
+            {
+                scanned.back()->scan(id);
+            }
+        }
+        static char receipt[64 * 1024];
+        volatile std::size_t length = 0;
+        results.push_back(measure(
+            "Checkout::writeReceipt",
+            scanned.size(),
+            [&](std::size_t) { return callsPerSample; },
+            [&](std::size_t i_Cart) {
+                for (std::size_t i = 0; i < callsPerSample; ++i)
+                {
+                    length = scanned[i_Cart]->writeReceipt(receipt, sizeof(receipt));
+                }
+            }));
+    }
+    {
+        BatchPricer pricer(table, config.numberOfThreads);
+        results.push_back(measure(
+            "BatchPricer::priceAll (cart)",
+            numberOfRepeats,
+            [&](std::size_t) { return carts.size(); },
+            [&](std::size_t) { (void)pricer.priceAll(carts); }));
+        BatchPricer::PromotionReport report;
+        results.push_back(measure(
+            "BatchPricer::analyzeAll",
+            numberOfRepeats,
+            [&](std::size_t) { return carts.size(); },
+            [&](std::size_t) { pricer.analyzeAll(carts, report); }));
+    }
+
+    std::printf("%zu items, %zu carts of ~%zu items, %d%% Buy X Get Y, %d%% bundles\n\n",
+                config.numberOfItems, config.numberOfCarts, config.cartSize, config.buyXGetYPercent, config.bundlePercent);
+    std::printf("%-28s %12s %10s %10s %10s %10s %14s\n", "benchmark", "ns/op", "p50", "p90", "p99", "allocs/op", "ops/s");
+    for (const auto &result : results)
+    {
+        printResult(result);
+    }
+    if (!config.jsonPath.empty())
+    {
+        writeJson(config, results);
+        std::printf("\nWrote %s\n", config.jsonPath.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,251 @@
+// Local
+#include <CatalogBackend.hpp>
+#include <Checkout.hpp>
+#include <PricingScheme.hpp>
+#include <PricingTable.hpp>
+// Standard Library
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#pragma once
+
+///@brief Coroutine that works on carts of an AsyncCheckoutLoop, e.g., scans one cart with
+///       co_await AsyncCheckout::scan() and reads its total
+///
+/// e.g.,
+///     CheckoutTask priceCart(AsyncCheckoutLoop &io_Loop, std::vector<std::string> i_Cart, int &o_Total)
+///     {
+///         AsyncCheckout checkout(io_Loop);
+///         for (const auto &id : i_Cart)
+///         {
+///             co_await checkout.scan(id);
+///         }
+///         o_Total = checkout.getTotal();
+///     }
+///@remarks The task starts when it is spawned on a loop (see AsyncCheckoutLoop::spawn)
+/// and only awaits scans of that loop's checkouts.
+class CheckoutTask
+{
+
+public:
+    struct promise_type
+    {
+        /// What the task threw, rethrown by AsyncCheckoutLoop::run
+        std::exception_ptr exception;
+
+        CheckoutTask get_return_object()
+        {
+            return CheckoutTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+        std::suspend_always final_suspend() noexcept
+        {
+            return {};
+        }
+        void return_void()
+        {
+        }
+        void unhandled_exception()
+        {
+            exception = std::current_exception();
+        }
+    };
+    using Handle = std::coroutine_handle<promise_type>;
+
+    CheckoutTask(CheckoutTask &&io_Task) noexcept;
+    CheckoutTask(const CheckoutTask &) = delete;
+    CheckoutTask &operator=(const CheckoutTask &) = delete;
+    ///@post Destroys the coroutine, unless it was spawned
+    virtual ~CheckoutTask();
+
+private:
+    friend class AsyncCheckoutLoop;
+
+    explicit CheckoutTask(Handle i_Handle);
+
+    /// Coroutine of the task, null once it was handed over to a loop
+    Handle m_Handle;
+};
+
+///@brief Runs the checkouts of a lane (or of a few lanes) that don't hold the full catalog:
+///       items are fetched from a store-level CatalogBackend the first time they are
+///       scanned, and kept in a local catalog for the next scans.
+///
+///       The loop runs CheckoutTask coroutines on the calling thread. A scan of an item
+///       that isn't in the local catalog suspends its task instead of blocking the thread,
+///       so the other carts keep being scanned. The misses of all tasks are coalesced into
+///       batched requests: once no task can go on (or a batch is full), every ID still
+///       missing is requested with one fetch, each ID once however many carts wait for it.
+///       When the batch arrives, its items are added to the local catalog and the tasks
+///       that were waiting for them resume.
+///@remarks Not thread safe: many carts are in flight on one thread. To use more threads,
+/// run one loop per thread (they can share the backend).
+///@remarks Adding a batch to the local catalog compiles it again (see PricingScheme::compile),
+/// which takes time proportional to the # of items fetched so far.
+class AsyncCheckoutLoop
+{
+
+public:
+    ///@param io_Backend Must outlive the loop
+    ///@param i_MaxBatchSize # of IDs at which a batch is sent even if tasks could go on
+    explicit AsyncCheckoutLoop(CatalogBackend &io_Backend, const std::size_t i_MaxBatchSize = 64);
+    ///@post Waits for the batches in flight, and destroys the tasks that haven't finished
+    virtual ~AsyncCheckoutLoop();
+
+    AsyncCheckoutLoop(const AsyncCheckoutLoop &) = delete;
+    AsyncCheckoutLoop &operator=(const AsyncCheckoutLoop &) = delete;
+
+    ///@brief Adds a task to run, it starts on the next run()
+    void spawn(CheckoutTask i_Task);
+
+    ///@brief Runs the tasks until every one of them has finished
+    ///@throws What a task threw (the other tasks are left suspended, and run() can be
+    ///        called again to go on with them), or std::runtime_error if tasks are left
+    ///        waiting for something other than this loop's scans
+    void run();
+
+    ///@brief Local catalog: every item fetched so far (shared, never null)
+    std::shared_ptr<const PricingTable> snapshot() const
+    {
+        return m_Table;
+    }
+
+    ///@brief # of batches (fetches) sent to the backend so far
+    std::size_t getNumberOfBatches() const
+    {
+        return m_NumberOfBatches;
+    }
+
+private:
+    friend class AsyncCheckout;
+
+    ///@brief Result of a fetch, handed over from the backend's thread
+    struct Completion
+    {
+        std::vector<std::string> ids;
+        std::vector<std::optional<Item>> items;
+        std::vector<std::pair<TaxClass, TaxRate>> taxRates;
+    };
+
+    ///@brief Moves a checkout to the latest local catalog, repricing only the lines of the
+    /// items that changed since its table (e.g., bundles whose partner just arrived)
+    void refresh(Checkout &io_Checkout) const;
+
+    ///@brief Indicates if a scan of the ID can be applied without fetching: the item is in
+    /// the local catalog, or the backend doesn't have it
+    bool isResolved(const std::string &i_ID) const;
+
+    ///@brief Suspends a task until the item with the given ID has been fetched
+    void await(const std::string &i_ID, CheckoutTask::Handle i_Handle);
+
+    ///@brief Sends every pending ID to the backend as one batch
+    void flush();
+
+    ///@brief Adds the items of a finished batch to the local catalog and resumes the
+    /// tasks that were waiting for them
+    void complete(Completion &io_Completion);
+
+    ///@brief Destroys a finished task
+    ///@throws What the task threw
+    void finish(CheckoutTask::Handle i_Handle);
+
+    CatalogBackend &m_Backend;
+    const std::size_t m_MaxBatchSize;
+
+    /// Items fetched so far, and the table compiled from them
+    PricingScheme m_Cache;
+    std::shared_ptr<const PricingTable> m_Table;
+    /// IDs the backend doesn't have
+    std::set<std::string> m_Unknown;
+    /// Cached items with a bundle whose partner isn't cached yet (key=partner ID), compiled
+    /// again once the partner arrives
+    std::multimap<std::string, std::string> m_BundleReferences;
+
+    /// Tasks that can be resumed
+    std::deque<CheckoutTask::Handle> m_Ready;
+    /// # of tasks spawned that haven't finished
+    std::size_t m_NumberOfTasks;
+    /// Tasks waiting for each ID that is pending or in flight
+    std::map<std::string, std::vector<CheckoutTask::Handle>> m_Waiters;
+    /// IDs not requested yet
+    std::vector<std::string> m_Pending;
+    std::size_t m_NumberOfBatches;
+
+    /// Guards the fields below, which the backend's callbacks write
+    std::mutex m_Mutex;
+    std::condition_variable m_Completed;
+    std::vector<Completion> m_Completions;
+    /// # of batches sent whose callback hasn't been called yet
+    std::size_t m_NumberInFlight;
+};
+
+///@brief Checkout of one cart run by an AsyncCheckoutLoop, whose scans are awaited
+///       (co_await checkout.scan(id)) so a lookup that has to go to the backend suspends
+///       the cart instead of the lane.
+class AsyncCheckout
+{
+
+public:
+    ///@brief Awaitable scan, see AsyncCheckout::scan
+    class ScanAwaiter
+    {
+
+    public:
+        ///@brief Applies the scan right away if the item doesn't have to be fetched
+        bool await_ready();
+        ///@brief Waits for the item to be fetched
+        void await_suspend(CheckoutTask::Handle i_Handle);
+        ///@brief Applies the scan once the item has been fetched
+        void await_resume();
+
+    private:
+        friend class AsyncCheckout;
+
+        ScanAwaiter(AsyncCheckout &io_Checkout, std::string i_ID, const int i_Quantity, const int i_Grams);
+
+        ///@brief Helper function to scan the item into the checkout
+        void apply();
+
+        AsyncCheckout &m_Checkout;
+        const std::string m_ID;
+        const int m_Quantity;
+        const int m_Grams;
+        bool m_IsApplied;
+    };
+
+    explicit AsyncCheckout(AsyncCheckoutLoop &io_Loop);
+    virtual ~AsyncCheckout();
+
+    ///@brief Adds the given quantity of an item to the cart, fetching the item first if
+    /// it isn't in the local catalog (see Checkout::scan)
+    ///@remarks IDs that the backend doesn't have are ignored
+    ScanAwaiter scan(std::string i_ID, const int i_Quantity = 1);
+    ///@brief Adds a weighed amount of an item to the cart (see Checkout::scanWeight)
+    ScanAwaiter scanWeight(std::string i_ID, const int i_Grams);
+
+    ///@brief Gets the total cost of the items scanned so far (see Checkout::getTotal)
+    int getTotal();
+
+    ///@brief Checkout the scans are applied to, e.g., to write a receipt
+    const Checkout &getCheckout() const
+    {
+        return m_Checkout;
+    }
+
+private:
+    AsyncCheckoutLoop &m_Loop;
+    Checkout m_Checkout;
+};
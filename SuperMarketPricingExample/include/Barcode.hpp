@@ -0,0 +1,81 @@
+// Standard Library
+#include <array>
+#include <cstdint>
+#include <string_view>
+#pragma once
+
+///@brief A scanned GTIN/EAN barcode (GTIN-8, UPC-A, EAN-13 or GTIN-14), decoded without
+///       allocating.
+///
+///       Every GTIN is a number of at most 14 digits, so a barcode is looked up by its
+///       numeric value (see PricingTable::findBarcode), which is the same for the GTIN-14
+///       form with leading zeros.
+///
+///       EAN-13 codes with a GS1 prefix from 20 to 29 are restricted circulation numbers
+///       that stores print themselves, e.g., on produce. Depending on the prefix (see
+///       PrefixRules) the code carries a weight or a price:
+///
+///           2P IIIII VVVVV C    P = prefix, I = item, V = value, C = check digit
+///
+///       The item is then looked up by the code with the value and check digit set to
+///       0 (2PIIIII000000), which is the ID of the item in the catalog.
+class Barcode
+{
+
+public:
+    ///@brief What a restricted circulation number carries in its value digits
+    enum class Embedded
+    {
+        NONE,   ///< Nothing, the code is looked up as is
+        WEIGHT, ///< Weight in grams
+        PRICE   ///< Price in cents
+    };
+
+    ///@brief Kind of value for each prefix 20 + i
+    using PrefixRules = std::array<Embedded, 10>;
+    ///@brief 20 for store codes without a value, 21-24 for prices and 25-29 for weights
+    static constexpr PrefixRules DEFAULT_RULES = {
+        Embedded::NONE, Embedded::PRICE, Embedded::PRICE, Embedded::PRICE, Embedded::PRICE,
+        Embedded::WEIGHT, Embedded::WEIGHT, Embedded::WEIGHT, Embedded::WEIGHT, Embedded::WEIGHT};
+
+    ///@brief Decodes the digits sent by a scanner
+    ///@return Invalid barcode (isValid() == false) if the text isn't 8, 12, 13 or 14 digits
+    /// or the check digit is wrong
+    static Barcode parse(std::string_view i_Digits, const PrefixRules &i_Rules = DEFAULT_RULES);
+
+    ///@brief Numeric value of an item ID that is a GTIN (8, 12, 13 or 14 digits), as used
+    /// by the barcode index. The check digit isn't verified.
+    ///@return false if the ID isn't a GTIN
+    static bool toKey(std::string_view i_ID, std::uint64_t &o_Key);
+
+    ///@brief GS1 check digit of the digits of a GTIN that come before it (from the right,
+    /// the digits are weighted 3, 1, 3, ...), e.g., to print a label
+    static char computeCheckDigit(std::string_view i_Digits);
+
+    bool isValid() const
+    {
+        return m_IsValid;
+    }
+    ///@brief Key of the item in the barcode index (see toKey)
+    std::uint64_t getItemKey() const
+    {
+        return m_ItemKey;
+    }
+    Embedded getEmbedded() const
+    {
+        return m_Embedded;
+    }
+    ///@brief Grams or cents, 0 if nothing is embedded
+    int getValue() const
+    {
+        return m_Value;
+    }
+
+private:
+    Barcode(const bool i_IsValid, const std::uint64_t i_ItemKey, const Embedded i_Embedded, const int i_Value);
+
+    bool m_IsValid;
+    std::uint64_t m_ItemKey;
+    Embedded m_Embedded;
+    int m_Value;
+};
@@ -0,0 +1,165 @@
+// Local
+#include <Money.hpp>
+#include <PricingTable.hpp>
+#include <Promotion.hpp>
+#include <ThreadPool.hpp>
+// Standard Library
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#pragma once
+
+///@brief Prices large batches of carts (e.g., a day of receipts being replayed to audit
+///       promotions or to test catalog changes) against one shared pricing snapshot,
+///       using all cores.
+///       Lines without deals are priced with one multiplication, lines with deals go
+///       through PricingTable::describeLine, and the taxable amount of every tax class of
+///       a whole chunk of carts is then taxed in one pass of the vectorized LineKernel.
+///       Totals are the same as scanning each cart into its own Checkout set to the
+///       same time (see setTime).
+class BatchPricer
+{
+
+public:
+    /// Item IDs scanned for one cart, in any order
+    using Cart = std::vector<std::string>;
+
+    ///@brief Outcome of the deals of many lines (see PricingTable::LineDetails), summed
+    ///@remarks Amounts in cents, before tax
+    struct DealSummary
+    {
+        /// # of lines, i.e., of carts with the item
+        std::uint64_t numberOfLines = 0;
+        std::uint64_t numberOfUnits = 0;
+        /// # of units given out free by Buy X Get Y
+        std::uint64_t numberOfFreeUnits = 0;
+        /// # of bundles completed: per item, the bundles the item is in (so a bundle counts
+        /// for both items), per promotion, each bundle once
+        std::uint64_t numberOfBundles = 0;
+        /// Revenue discounted by Buy X Get Y and by bundles
+        std::int64_t freeSavings = 0;
+        std::int64_t bundleSavings = 0;
+        /// What the lines cost
+        std::int64_t revenue = 0;
+
+        DealSummary &operator+=(const DealSummary &i_Other)
+        {
+            numberOfLines += i_Other.numberOfLines;
+            numberOfUnits += i_Other.numberOfUnits;
+            numberOfFreeUnits += i_Other.numberOfFreeUnits;
+            numberOfBundles += i_Other.numberOfBundles;
+            freeSavings += i_Other.freeSavings;
+            bundleSavings += i_Other.bundleSavings;
+            revenue += i_Other.revenue;
+            return *this;
+        }
+    };
+
+    ///@brief Promotion analytics of the carts analyzed so far (see analyzeAll)
+    struct PromotionReport
+    {
+        std::uint64_t numberOfCarts = 0;
+        /// By item index of the pricing table
+        std::vector<DealSummary> items;
+        /// By PromotionKind
+        std::array<DealSummary, 3> promotions = {};
+    };
+
+    ///@param i_NumberOfThreads # of threads to price with (0 == one per hardware thread)
+    BatchPricer(std::shared_ptr<const PricingTable> i_PricingTable, const unsigned i_NumberOfThreads = 0);
+    virtual ~BatchPricer();
+
+    ///@brief Prices every cart in the batch
+    ///@return Total of each cart, in the same order as i_Carts
+    std::vector<Money> priceAll(const std::vector<Cart> &i_Carts);
+
+    ///@brief Sets the time carts are priced at, so the deals scheduled for that time apply
+    /// (see Checkout::setTime), e.g., the time of the transactions of the next batch
+    ///@param i_Time Seconds since the epoch (see PromotionWindow)
+    ///@pre No batch is being priced
+    void setTime(const std::int64_t i_Time)
+    {
+        m_Time = i_Time;
+    }
+    ///@brief Time carts are priced at, the time the pricer was created unless setTime()
+    /// was called
+    std::int64_t getTime() const
+    {
+        return m_Time;
+    }
+
+    ///@brief Prices a single cart on the calling thread
+    Money priceCart(const Cart &i_Cart) const;
+
+    ///@brief Adds the deal outcomes of every line of every cart in the batch to a report,
+    ///       per item and per kind of promotion, e.g., to replay months of transactions
+    ///       batch by batch into the same report
+    ///@remarks Each worker sums its lines into its own accumulators, which are merged
+    /// into io_Report once the batch is done, so workers don't share any cache line. Only
+    /// the items in the batch's carts are merged, so a batch costs O(lines), not
+    /// O(workers * catalog size).
+    ///@throws std::runtime_error if io_Report was filled from a table of another size
+    void analyzeAll(const std::vector<Cart> &i_Carts, PromotionReport &io_Report);
+
+private:
+    ///@brief Per-worker buffers, reused from cart to cart so pricing doesn't allocate
+    ///@remarks Cache line aligned so workers don't write to each other's lines
+    struct alignas(64) Scratch
+    {
+        /// Indices of the scanned items
+        std::vector<PricingTable::Index> scans;
+        /// Lines of the cart (key=Item index, value=# of item), sorted by index
+        std::vector<std::pair<PricingTable::Index, int>> lines;
+
+        /// Taxable amount of each tax class of all carts in the chunk, as parallel arrays
+        /// for LineKernel (a quantity of 1 each), and the amounts with tax it returns
+        std::vector<std::int32_t> taxableAmount;
+        std::vector<std::int32_t> taxRate;
+        std::vector<std::int32_t> taxQuantity;
+        std::vector<std::int64_t> taxedAmount;
+        /// Position in the chunk of the cart each taxable amount belongs to
+        std::vector<std::size_t> taxCart;
+
+        /// Deal outcomes of the lines this worker analyzed (see analyzeAll), by item index
+        /// and by PromotionKind
+        std::vector<DealSummary> itemSummaries;
+        /// Items whose summary is in use, so a batch merges and zeroes only those rather
+        /// than the whole catalog
+        std::vector<PricingTable::Index> touchedItems;
+        std::array<DealSummary, 3> promotionSummaries;
+        std::uint64_t numberOfCarts = 0;
+    };
+
+    ///@brief Helper function to price a chunk of consecutive carts with the given buffers
+    ///@param o_Totals Receives the total of each cart in the chunk
+    void priceChunk(const Cart *i_Carts, const std::size_t i_NumberOfCarts, Money *o_Totals, Scratch &io_Scratch) const;
+    ///@brief Helper function to add the deal outcomes of a chunk of consecutive carts
+    /// to the summaries of the given buffers
+    void analyzeChunk(const Cart *i_Carts, const std::size_t i_NumberOfCarts, Scratch &io_Scratch) const;
+    ///@brief Helper function to fill io_Scratch.lines with the lines of a cart
+    void collectLines(const Cart &i_Cart, Scratch &io_Scratch) const;
+    ///@brief Helper function to tell lines priced as the unit price * quantity from
+    /// lines whose deal applies
+    ///@param i_Index Item of the line
+    ///@param i_Deal Deal of the line's item at the pricing time (see PricingTable::findDeal)
+    ///@param o_NumberOfPartner # of units of the bundle partner in the cart, 0 if the
+    ///       partner doesn't have the bundle too (see PricingTable::findBundlePartner)
+    bool isSimpleLine(
+        const PricingTable::Index i_Index,
+        const PricingTable::Index i_Deal,
+        const Scratch &i_Scratch,
+        int &o_NumberOfPartner) const;
+
+    /// Compiled Pricing Scheme shared by all carts in the batch
+    std::shared_ptr<const PricingTable> m_PricingTable;
+    /// Seconds since the epoch
+    std::int64_t m_Time;
+
+    ThreadPool m_ThreadPool;
+
+    /// One set of buffers per worker of m_ThreadPool
+    std::vector<Scratch> m_Scratch;
+};
@@ -0,0 +1,44 @@
+// Local
+#include <PricingScheme.hpp>
+#include <PricingTable.hpp>
+// Standard Library
+#include <atomic>
+#include <memory>
+#pragma once
+
+///@brief Publishes compiled pricing tables to checkout lanes as shared, immutable,
+///       versioned snapshots (RCU-style).
+///       Lanes take the current snapshot when a transaction starts and keep it until the
+///       transaction ends, so a writer can publish new prices at any time without
+///       affecting carts that are already in flight. Old snapshots are freed when the
+///       last Checkout using them goes away.
+///@remarks Thread safe. Publishing and taking a snapshot each take a short internal
+///         lock around the pointer copy and reference count update (std::atomic of a
+///         shared_ptr isn't lock-free in libstdc++), never while a table is compiled.
+class Catalog
+{
+
+public:
+    Catalog();
+    ///@brief Creates a catalog and publishes the given pricing scheme as its first snapshot
+    explicit Catalog(const PricingScheme &i_PricingScheme);
+    virtual ~Catalog();
+
+    Catalog(const Catalog &) = delete;
+    Catalog &operator=(const Catalog &) = delete;
+
+    ///@brief Compiles the pricing scheme and makes it the current snapshot
+    ///@post Checkouts created after this call see the new prices, existing ones don't
+    void publish(const PricingScheme &i_PricingScheme);
+
+    ///@brief Makes an already compiled table the current snapshot
+    void publish(std::shared_ptr<const PricingTable> i_PricingTable);
+
+    ///@brief Used by lanes to get the current prices without copying them
+    ///@return Current snapshot (never null, an empty table before the first publish)
+    std::shared_ptr<const PricingTable> snapshot() const;
+
+private:
+    /// Current snapshot
+    std::atomic<std::shared_ptr<const PricingTable>> m_Current;
+};
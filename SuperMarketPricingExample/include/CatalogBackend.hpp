@@ -0,0 +1,97 @@
+// Local
+#include <Item.hpp>
+#include <Money.hpp>
+#include <PricingScheme.hpp>
+// Standard Library
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#pragma once
+
+///@brief Store-level catalog service that lanes without the full catalog fetch prices
+///       from (e.g., an RPC client). Requests are asynchronous and carry a batch of IDs,
+///       so one round trip prices many lookups (see AsyncCheckoutLoop).
+class CatalogBackend
+{
+
+public:
+    ///@brief Receives the result of a fetch: one entry per requested ID, in the same order,
+    /// std::nullopt for IDs the catalog doesn't have, and the rate of the tax class of each
+    /// item found
+    using Callback = std::function<void(std::vector<std::optional<Item>> i_Items, std::vector<std::pair<TaxClass, TaxRate>> i_TaxRates)>;
+
+    virtual ~CatalogBackend();
+
+    ///@brief Starts fetching the items with the given IDs and returns without waiting
+    ///@param i_Done Called exactly once, on any thread, when the items have arrived
+    ///@remarks Called from several threads at once
+    virtual void fetch(std::vector<std::string> i_IDs, Callback i_Done) = 0;
+};
+
+///@brief In-process CatalogBackend for tests and benchmarks: serves the items of a
+///       pricing scheme after an injected latency, from a background thread.
+class FakeCatalogBackend : public CatalogBackend
+{
+
+public:
+    ///@param i_Latency Time from a fetch() to its callback, whatever the batch size
+    FakeCatalogBackend(const PricingScheme &i_PricingScheme, const std::chrono::microseconds i_Latency);
+    ///@post Callbacks of the fetches still in progress are called before it returns
+    virtual ~FakeCatalogBackend();
+
+    FakeCatalogBackend(const FakeCatalogBackend &) = delete;
+    FakeCatalogBackend &operator=(const FakeCatalogBackend &) = delete;
+
+    void fetch(std::vector<std::string> i_IDs, Callback i_Done) override;
+
+    ///@brief # of fetch() calls (round trips) so far
+    std::size_t getNumberOfRequests() const
+    {
+        return m_NumberOfRequests.load();
+    }
+    ///@brief # of IDs requested so far, over all fetches
+    std::size_t getNumberOfIdsRequested() const
+    {
+        return m_NumberOfIdsRequested.load();
+    }
+
+private:
+    ///@brief A fetch waiting for its latency to pass
+    struct Request
+    {
+        std::chrono::steady_clock::time_point due;
+        std::vector<std::string> ids;
+        Callback done;
+    };
+
+    ///@brief Loop of the background thread: answers each request once it is due
+    void serve();
+
+    /// Items of the catalog (key=ID)
+    const std::map<std::string, Item> m_Items;
+    const std::chrono::microseconds m_Latency;
+    /// By class ID
+    std::array<TaxRate, TaxClass::COUNT> m_TaxRates;
+
+    std::atomic<std::size_t> m_NumberOfRequests;
+    std::atomic<std::size_t> m_NumberOfIdsRequested;
+
+    /// Guards the fields below
+    std::mutex m_Mutex;
+    std::condition_variable m_RequestReady;
+    /// Requests in the order they are due (the latency is the same for all)
+    std::vector<Request> m_Requests;
+    bool m_Stop;
+
+    std::thread m_Thread;
+};
@@ -0,0 +1,28 @@
+// Local
+#include <PricingTable.hpp>
+// Standard Library
+#include <memory>
+#include <string>
+#pragma once
+
+///@brief Reads and writes compiled catalogs as binary files.
+///       The file is the PricingTable's binary image as is (versioned header, checksum,
+///       8-byte aligned arrays), so loading a catalog is a memory mapping plus a header
+///       check: there is no parsing and no per-item allocation, and lane processes on one
+///       host share the same physical pages.
+class CatalogFile
+{
+
+public:
+    ///@brief Writes a compiled catalog to a file
+    ///@remarks The catalog is written to a temporary file that is stored on the disk and
+    /// then renamed over i_Path, so a lane starting up never sees a half-written catalog,
+    /// even after a crash
+    ///@throws std::runtime_error if the file can't be written
+    static void write(const PricingTable &i_PricingTable, const std::string &i_Path);
+
+    ///@brief Maps a catalog file and serves lookups straight from the mapping
+    ///@param i_VerifyChecksum Set to false to skip reading every page up front
+    ///@throws std::runtime_error if the file can't be mapped or isn't a valid catalog
+    static std::shared_ptr<const PricingTable> load(const std::string &i_Path, const bool i_VerifyChecksum = true);
+};
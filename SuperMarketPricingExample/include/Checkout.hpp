@@ -1,42 +1,207 @@
 // Local
+#include <Barcode.hpp>
+#include <PricingOverlay.hpp>
 #include <PricingScheme.hpp>
+#include <PricingTable.hpp>
+#include <Receipt.hpp>
+#include <ScanJournal.hpp>
 // Standard Library
+#include <cstddef>
+#include <cstdint>
 #include <map>
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #pragma once
 
 ///@brief This class emulates a checkout process in a Grocery store.
+///@remarks A lane can keep one Checkout for all of its customers: reset() empties the
+/// cart between transactions, and giving the checkout a lane-local memory resource
+/// (e.g., std::pmr::unsynchronized_pool_resource) lets the cart reuse its nodes instead
+/// of going back to the shared global heap for every customer.
 class Checkout
 {
 
 public:
-    Checkout(const PricingScheme &i_PricingScheme);
+    ///@brief Creates a checkout with its own compiled copy of the pricing scheme
+    ///@param i_Memory Resource the cart allocates from, must outlive the checkout
+    Checkout(const PricingScheme &i_PricingScheme,
+             std::pmr::memory_resource *i_Memory = std::pmr::get_default_resource());
+    ///@brief Creates a checkout that shares a compiled pricing snapshot (see Catalog)
+    ///@param i_Memory Resource the cart allocates from, must outlive the checkout
+    ///@remarks The checkout keeps the snapshot alive and keeps using it even if newer
+    ///         prices are published while the transaction is in progress
+    Checkout(std::shared_ptr<const PricingTable> i_PricingTable,
+             std::pmr::memory_resource *i_Memory = std::pmr::get_default_resource());
     virtual ~Checkout();
 
+    ///@brief Empties the cart so the checkout can be reused for the next transaction
+    ///@post getTotal() == 0, getTime() is the current time
+    ///@remarks The cart's memory goes back to the checkout's memory resource
+    void reset();
+    ///@brief Empties the cart and switches to another pricing snapshot (e.g., the latest
+    /// one published to a Catalog) for the next transaction
+    void reset(std::shared_ptr<const PricingTable> i_PricingTable);
+
+    ///@brief Moves the open cart to a newer table of the same PricingScheme and reprices
+    /// only the lines of the given items (and their bundle partners)
+    ///@param i_Changed Items changed since getVersion(), see PricingScheme::getChangesSince
+    ///@pre i_PricingTable was compiled from the same PricingScheme as the current table
+    ///     (so items have the same indices)
+    ///@remarks Takes time proportional to the # of changes, not to the size of the cart.
+    /// A change of tax rates changes no line: the cart is taxed at the new table's rates.
+    ///@remarks The line of an item removed from the scheme is dropped (with its bundle
+    /// partner repriced without it), so the cart is what scanning it against the new
+    /// table would give, as when it is recovered from its journal: the lane can no longer
+    /// sell the item, rather than selling it for nothing.
+    void update(std::shared_ptr<const PricingTable> i_PricingTable, const std::vector<PricingTable::Index> &i_Changed);
+    ///@brief Moves the open cart to a newer table of the same PricingScheme and reprices
+    /// every line (e.g., when the change journal doesn't go back far enough). Lines of
+    /// removed items are dropped, as with update(i_PricingTable, i_Changed).
+    void update(std::shared_ptr<const PricingTable> i_PricingTable);
+
+    ///@brief Layers a customer's prices over the cart's table (e.g., when they tap their
+    /// loyalty card, before or during the transaction) and reprices only the lines of
+    /// the items the overlay overrides
+    ///@remarks Takes time proportional to the size of the overlay, not of the catalog or
+    /// of the cart (see PricingOverlay::compile).
+    ///@remarks reset() keeps the overlay: the next customer's transaction starts with
+    /// reset(i_PricingTable), e.g., with the catalog's current snapshot.
+    void applyOverlay(const PricingOverlay &i_Overlay);
+
+    ///@brief Records every scan in a write-ahead journal from now on, so the cart can be
+    /// recovered if the process dies (nullptr stops journaling)
+    ///@param io_Journal Must outlive the checkout (or the next setJournal() call), and only
+    ///       one checkout may write to it
+    ///@remarks Starts a new transaction in the journal with the lines already in the cart.
+    /// reset() starts a new transaction.
+    void setJournal(ScanJournal *io_Journal);
+    ///@brief Replaces the cart with the scans of the transaction that was open in the
+    /// journal (see ScanJournal::getRecovered) and keeps journaling to it
+    ///@pre The journal was written by a checkout priced from the same PricingScheme
+    ///     (so items have the same indices)
+    ///@remarks Scans of items that aren't in the current table (or were removed from the
+    /// scheme) are dropped
+    void recover(ScanJournal &io_Journal);
+
+    ///@brief Sets the time the cart is priced at, e.g., the lane's clock before each scan,
+    /// so the deals scheduled for that time apply (see PricingScheme::schedulePromotion)
+    ///@param i_Time Seconds since the epoch (see PromotionWindow)
+    ///@remarks The whole cart is priced with the deals in effect at the time of its latest
+    /// scan. Lines are only repriced when a scheduled deal starts or ends between the old
+    /// and the new time (see PricingTable::getScheduleSegment), otherwise this takes
+    /// constant time.
+    void setTime(const std::int64_t i_Time);
+    ///@brief Time the cart is priced at: the time set by the latest setTime(), or the time
+    /// the checkout was created or last reset() if setTime() wasn't called since
+    std::int64_t getTime() const
+    {
+        return m_Time;
+    }
+
+    ///@brief Version of the PricingScheme the cart is priced with
+    std::uint64_t getVersion() const
+    {
+        return m_PricingTable->getVersion();
+    }
+
     ///@brief Adds an item with the given ID to the virtual cart
-    void scan(const std::string &i_ID);
+    ///@remarks IDs that aren't in the pricing scheme are ignored (they have no price)
+    ///@remarks The ID is only used for the lookup, it isn't copied
+    void scan(std::string_view i_ID);
+
+    ///@brief Adds the given quantity of an item to the virtual cart (e.g., from a bulk
+    /// entry device), same as calling scan(i_ID) i_Quantity times
+    ///@remarks A quantity of 0 or less is ignored (a cart never holds a negative quantity)
+    void scan(std::string_view i_ID, const int i_Quantity);
 
-    ///@brief Used once all items are scanned to calculate total cost
-    ///@return Total cost of items in cart in cents (rounds to nearest cent)
-    int getTotal();
+    ///@brief Adds a weighed amount of an item to the virtual cart (e.g., from a scale)
+    ///@remarks A weight of 0 or less is ignored
+    ///@remarks The unit price of a weighed item is its price per kilogram. Deals do not
+    /// apply to weighed amounts.
+    void scanWeight(std::string_view i_ID, const int i_Grams);
+
+    ///@brief Adds the item with the given barcode to the virtual cart, looked up in the
+    /// table's barcode index (see PricingTable::findBarcode) without allocating
+    ///@param i_Barcode Digits sent by the scanner (see Barcode::parse)
+    ///@remarks A code with an embedded weight adds that weight (like scanWeight()). A code
+    /// with an embedded price adds the price divided by the unit price as a quantity, so
+    /// such items are catalogued with a unit price of 0.01. Invalid codes and codes that
+    /// aren't in the table are ignored.
+    void scanBarcode(std::string_view i_Barcode, const Barcode::PrefixRules &i_Rules = Barcode::DEFAULT_RULES);
+
+    ///@brief Gets the total cost of the items scanned so far
+    ///@return Total cost of items in cart in cents
+    ///@remarks Tax is rounded to the nearest cent once per tax class (see
+    /// PricingTable::computeTax)
+    ///@remarks The subtotal and the taxable amount of each class are kept up to date by
+    /// scan(), so this takes constant time (one multiplication per tax class in the cart)
+    /// and can be called any number of times (e.g., after every scan)
+    int getTotal() const;
+
+    ///@brief Streams an itemized receipt of the cart (quantities, free items, bundle
+    /// savings, tax per class and the total) to a sink, without allocating
+    ///@remarks The amounts on the receipt add up to getTotal() (see PricingTable::LineDetails)
+    void writeReceipt(ReceiptSink &io_Sink) const;
+    ///@brief Writes an itemized receipt into a caller-provided buffer, without allocating
+    ///@return Length of the whole receipt. If that isn't less than i_Size, the receipt
+    ///        was truncated (like std::snprintf). The text is null terminated if i_Size > 0.
+    std::size_t writeReceipt(char *o_Buffer, const std::size_t i_Size) const;
 
 private:
-    ///@brief Helper function to encapsulate logic for calculating the cost of all the items
-    /// in the cart
-    void calculateTotal();
-    ///@brief Helper function to encapsulate logic for calculating the Buy X, Get Y price
-    /// scheme.
-    ///@remarks Function is recursive
-    void processBuyXGetY(double &io_Sum, const Item &i_Item, int &io_NumberOf);
+    ///@brief A line of the virtual cart (all units of one item)
+    struct Line
+    {
+        /// # of item in cart
+        int quantity;
+        /// Weight of item in cart in grams (for items sold by weight)
+        int grams;
+        /// Cost of the line before tax (see PricingTable::priceLine)
+        Money subtotal;
+        /// Part of the subtotal taxed at the item's tax class
+        Money taxableCost;
+        /// Tax class the taxable cost was added to
+        TaxClass taxClass;
+    };
+
+    ///@brief Helper function to reprice the line of the given item (and its bundle partner)
+    /// after its quantity changed, and to apply the difference to the running totals
+    void updateLine(const PricingTable::Index i_Index, Line &io_Line);
+    ///@brief Helper function to reprice one line with the given deal of its item and
+    /// apply the difference to the running subtotal and taxable amounts
+    void setLineCost(const PricingTable::Index i_Index, const PricingTable::Index i_Deal, Line &io_Line, const int i_NumberOfPartner);
+    ///@brief Helper function to reprice every line of the cart, and drop the lines of
+    /// removed items
+    void updateLines();
+    ///@brief Helper function to take a line out of the cart and its running totals
+    ///@return Line after the removed one
+    std::pmr::map<PricingTable::Index, Line>::iterator removeLine(std::pmr::map<PricingTable::Index, Line>::iterator i_Line);
 
-    /// Tracks cumulative cost while total is being calculated
-    double m_Total;
+    ///@brief Helper function to add a scan to the journal (if any) before it is applied
+    ///@throws std::runtime_error if the journal has no room for the cart
+    void journalScan(const PricingTable::Index i_Index, const ScanJournal::Kind i_Kind, const int i_Amount);
 
-    /// Pricing Scheme that describes the cost of items
-    PricingScheme m_PricingScheme;
+    /// Running total of all lines in the cart, before tax
+    Money m_Subtotal;
+    /// Running taxable amount of the cart in each tax class
+    PricingTable::TaxableAmounts m_Taxable;
+
+    /// Compiled Pricing Scheme that describes the cost of items (shared, never null)
+    std::shared_ptr<const PricingTable> m_PricingTable;
+
+    /// Time the cart is priced at, in seconds since the epoch
+    std::int64_t m_Time;
+    /// Period around m_Time during which the deals in effect don't change
+    std::pair<std::int64_t, std::int64_t> m_ScheduleSegment;
 
     /// virtual cart to track items
-    /// key=Item ID, value=# of item in cart
-    std::map<std::string, int> m_Cart;
+    /// key=Item index in m_PricingTable, value=line of the item
+    std::pmr::map<PricingTable::Index, Line> m_Cart;
+
+    /// Write-ahead journal of the scans, nullptr if the cart isn't journaled
+    ScanJournal *m_Journal;
 };
\ No newline at end of file
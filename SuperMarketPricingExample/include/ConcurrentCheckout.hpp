@@ -0,0 +1,99 @@
+// Local
+#include <Money.hpp>
+#include <PricingTable.hpp>
+// Standard Library
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <utility>
+#pragma once
+
+///@brief Cart of one transaction that several devices scan into at the same time
+///       (e.g., a scan-as-you-shop handheld and the lane scanner, or several packers).
+///       Scans only add to per-item counts, so each scanning thread adds to its own
+///       shard of the counts under a lock that nobody else normally takes. getTotal()
+///       locks every shard at once, merges the counts and prices the merged lines, so
+///       the total is always that of a consistent set of scans and is the same as
+///       scanning everything into one Checkout set to the same time (see setTime).
+///@remarks Thread safe
+class ConcurrentCheckout
+{
+
+public:
+    ///@param i_NumberOfShards 0 == one per hardware thread
+    explicit ConcurrentCheckout(std::shared_ptr<const PricingTable> i_PricingTable, const unsigned i_NumberOfShards = 0);
+    virtual ~ConcurrentCheckout();
+
+    ConcurrentCheckout(const ConcurrentCheckout &) = delete;
+    ConcurrentCheckout &operator=(const ConcurrentCheckout &) = delete;
+
+    ///@brief Same as Checkout::scan(), callable from any number of threads at once
+    void scan(std::string_view i_ID);
+    ///@brief Same as Checkout::scan(), a quantity of 0 or less is ignored
+    void scan(std::string_view i_ID, const int i_Quantity);
+    ///@brief Same as Checkout::scanWeight(), a weight of 0 or less is ignored
+    void scanWeight(std::string_view i_ID, const int i_Grams);
+
+    ///@brief Gets the total cost of the items scanned so far
+    ///@return Total cost of items in cart in cents
+    ///@remarks Includes every scan that returned before the call. Takes time proportional
+    /// to the # of lines, unless nothing was scanned since the last call.
+    int getTotal() const;
+
+    ///@brief Empties the cart for the next transaction
+    ///@pre No thread is scanning
+    ///@post getTime() is the current time
+    void reset();
+
+    ///@brief Sets the time the cart is priced at, so the deals scheduled for that time
+    /// apply (see Checkout::setTime), callable from any thread
+    ///@param i_Time Seconds since the epoch (see PromotionWindow)
+    void setTime(const std::int64_t i_Time);
+    ///@brief Time the cart is priced at: the time set by the latest setTime(), or the time
+    /// the checkout was created or last reset() if setTime() wasn't called since
+    std::int64_t getTime() const;
+
+private:
+    ///@brief Counts of one item scanned by one shard
+    struct Counts
+    {
+        int quantity;
+        int grams;
+    };
+
+    ///@brief Part of the cart, used by the threads that map to it
+    ///@remarks Cache line aligned so threads on different shards don't share lines
+    struct alignas(64) Shard
+    {
+        std::mutex mutex;
+        /// key=Item index, value=counts scanned into this shard
+        std::map<PricingTable::Index, Counts> lines;
+        /// Incremented by every scan into this shard
+        std::uint64_t numberOfScans;
+    };
+
+    ///@brief Helper function to add to the counts of an item in the calling thread's shard
+    void add(std::string_view i_ID, const int i_Quantity, const int i_Grams);
+
+    /// Compiled Pricing Scheme that describes the cost of items (shared, never null)
+    std::shared_ptr<const PricingTable> m_PricingTable;
+
+    const unsigned m_NumberOfShards;
+    std::unique_ptr<Shard[]> m_Shards;
+
+    /// Guards the fields below (and orders getTotal() calls)
+    mutable std::mutex m_TotalMutex;
+    /// Seconds since the epoch
+    std::int64_t m_Time;
+    /// Period around m_Time during which the deal of every item stays the same (see
+    /// PricingTable::getScheduleSegment)
+    std::pair<std::int64_t, std::int64_t> m_ScheduleSegment;
+    /// Set when the cached total was priced with other deals
+    mutable bool m_IsTotalStale;
+    /// Total of the cart after m_NumberOfScansPriced scans
+    mutable Money m_Total;
+    mutable std::uint64_t m_NumberOfScansPriced;
+};
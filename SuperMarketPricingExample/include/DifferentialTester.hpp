@@ -0,0 +1,137 @@
+// Local
+#include <Item.hpp>
+#include <Money.hpp>
+#include <PricingScheme.hpp>
+#include <Promotion.hpp>
+// Standard Library
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#pragma once
+
+///@brief Randomized differential testing of the pricing engines.
+///
+///       Generates random catalogs and carts (reproducible from a seed), prices each cart
+///       with a deliberately simple reference implementation of the Checkout semantics
+///       (see priceReference) and with every registered engine, and reports the carts
+///       where an engine disagrees. Cases run in parallel on all cores. A failing case is
+///       shrunk to a minimal reproduction: as few scans and items, as small quantities
+///       and as few promotions as still make the engine disagree.
+class DifferentialTester
+{
+
+public:
+    ///@brief One scan of a cart: a quantity or a weight of an item
+    struct Scan
+    {
+        std::string id;
+        /// # of units, 0 for a weighed scan
+        int quantity;
+        /// Weight in grams, 0 for a scan of units
+        int grams;
+    };
+
+    ///@brief A deal scheduled for an item (see PricingScheme::schedulePromotion)
+    struct ScheduledDeal
+    {
+        std::string id;
+        Promotion promotion;
+        PromotionWindow window;
+    };
+
+    ///@brief A catalog (items in the order they are added, the rate of each tax class and
+    /// the scheduled deals) and the scans of one cart, priced at a given time
+    struct Case
+    {
+        std::vector<Item> items;
+        std::vector<Scan> scans;
+        /// By class ID, classes past the end are untaxed
+        std::vector<TaxRate> taxRates;
+        std::vector<ScheduledDeal> schedules;
+        /// Seconds since the epoch (see Checkout::setTime)
+        std::int64_t time = 0;
+    };
+
+    ///@brief Prices a case, in cents
+    ///@return std::nullopt if the engine can't price this case (e.g., weighed items)
+    using Engine = std::function<std::optional<std::int64_t>(const Case &i_Case)>;
+
+    ///@brief Shape of the generated cases
+    struct Options
+    {
+        std::uint64_t seed = 1983;
+        std::size_t numberOfCases = 10000;
+        /// 0 == one per hardware thread
+        unsigned numberOfThreads = 0;
+        std::size_t maxItems = 12;
+        std::size_t maxScans = 40;
+        /// # of failing cases kept (and shrunk)
+        std::size_t maxFailures = 10;
+    };
+
+    ///@brief A case where an engine disagrees with the reference
+    struct Failure
+    {
+        std::string engine;
+        /// Case # of the run (generate(seed, caseNumber) reproduces it)
+        std::uint64_t caseNumber;
+        /// Smallest version of the case found that still fails
+        Case shrunk;
+        std::int64_t expected;
+        std::int64_t actual;
+        /// What the engine threw, if it did
+        std::string error;
+    };
+
+    struct Report
+    {
+        std::size_t numberOfCases;
+        /// # of engine results compared with the reference
+        std::size_t numberOfComparisons;
+        std::vector<Failure> failures;
+    };
+
+    explicit DifferentialTester(const Options &i_Options);
+    virtual ~DifferentialTester();
+
+    ///@brief Adds an engine to compare against the reference
+    ///@remarks The engine is called from several threads at once
+    void addEngine(const std::string &i_Name, Engine i_Engine);
+    ///@brief Adds the engines of this library (Checkout, incl. reset and delta repricing,
+    /// ConcurrentCheckout, BatchPricer and PromotionEngine without deals), each set to
+    /// the case's time
+    void addDefaultEngines();
+
+    ///@brief Runs every case against every engine, then shrinks the failures
+    Report run() const;
+
+    ///@brief Generates case i_CaseNumber of a run with the given options
+    static Case generate(const Options &i_Options, const std::uint64_t i_CaseNumber);
+
+    ///@brief Prices a case the straightforward way, from the items as given: with the
+    /// deal scheduled for the case's time if there is one, unit by unit for Buy X Get Y,
+    /// by looking up the partner's line for bundles, and tax once per tax class
+    static std::int64_t priceReference(const Case &i_Case);
+
+    ///@brief Pricing scheme with the items, tax rates and scheduled deals of a case
+    static PricingScheme makeScheme(const Case &i_Case);
+
+    ///@brief Readable form of a case, e.g., to paste into a test
+    static std::string describe(const Case &i_Case);
+
+private:
+    ///@brief Compares an engine with the reference price (io_Failure.expected) of a case
+    ///@return true if they agree (or the engine can't price the case), else io_Failure
+    /// holds the case and what the engine returned or threw
+    static bool check(const Engine &i_Engine, const Case &i_Case, std::size_t &io_NumberOfComparisons, Failure &io_Failure);
+
+    ///@brief Shrinks a failing case as long as the engine keeps failing on it
+    static Failure shrink(const Engine &i_Engine, Failure i_Failure);
+
+    const Options m_Options;
+    std::vector<std::pair<std::string, Engine>> m_Engines;
+};
@@ -1,3 +1,6 @@
+// Local
+#include <Money.hpp>
+#include <Promotion.hpp>
 // Standard Library
 #include <string>
 #include <utility>
@@ -10,17 +13,27 @@ class Item
 {
 
 public:
+    ///@remarks {0, 0} means no deal (SimplePrice)
+    ///@throws std::runtime_error if it is a deal but not a valid one (see BuyXGetY::isValid)
     Item(
         const std::string &i_Id,
-        const double i_UnitPrice,
-        const double i_Tax = 0,
+        const Money i_UnitPrice,
+        const TaxClass i_TaxClass = TaxClass(),
         const std::pair<int, int> &i_BuyXGetY = {0, 0});
 
+    ///@remarks An empty partner ID means no deal (SimplePrice)
     Item(
         const std::string &i_Id,
-        const double i_UnitPrice,
-        const std::pair<std::string, double> &i_Bundle = {std::string(), 0},
-        const double i_Tax = 0);
+        const Money i_UnitPrice,
+        const std::pair<std::string, Money> &i_Bundle = {std::string(), Money()},
+        const TaxClass i_TaxClass = TaxClass());
+
+    ///@throws std::runtime_error if the promotion is a BuyXGetY that isn't valid
+    Item(
+        const std::string &i_Id,
+        const Money i_UnitPrice,
+        const Promotion &i_Promotion,
+        const TaxClass i_TaxClass = TaxClass());
 
     Item(const Item &i_Item);
     Item();
@@ -29,41 +42,35 @@ public:
 
     void operator=(const Item &i_Item);
 
-    std::string getId() const
+    const std::string &getId() const
     {
         return m_Id;
     }
-    double getUnitPrice() const
+    Money getUnitPrice() const
     {
         return m_UnitPrice;
     }
 
-    double getTax() const
+    ///@brief Tax class of the item, its rate is in the PricingScheme's tax table
+    TaxClass getTaxClass() const
     {
-        return m_Tax;
+        return m_TaxClass;
     }
-    std::pair<int, int> getBuyXGetY() const
+    const Promotion &getPromotion() const
     {
-        return m_BuyXGetY;
-    }
-    std::pair<std::string, double> getBundle() const
-    {
-        return m_Bundle;
+        return m_Promotion;
     }
 
 private:
     /// 4-digit numerical ID
     const std::string m_Id;
 
-    /// Price of individual item before tax (e.g., $2.49 == 2.49)
-    const double m_UnitPrice;
-
-    /// Tax to be added onto item (e.g., 9.25% == 0.0925)
-    const double m_Tax;
+    /// Price of individual item before tax (e.g., $2.49 == Money(249))
+    const Money m_UnitPrice;
 
-    /// Buy X (.first), Get Y free (.second)
-    const std::pair<int, int> m_BuyXGetY;
+    /// Tax class of the item (e.g., TaxClass(1) for alcohol, taxed at 9.25% by the scheme)
+    const TaxClass m_TaxClass;
 
-    /// Buying this item and item #xxxx (.first) for $y.yy (.second)
-    const std::pair<std::string, double> m_Bundle;
+    /// Deal on the item (e.g., BuyXGetY{2, 1}, or Bundle{"4900", Money(499)})
+    const Promotion m_Promotion;
 };
\ No newline at end of file
@@ -0,0 +1,51 @@
+// Standard Library
+#include <cstddef>
+#include <cstdint>
+#pragma once
+
+///@brief Vectorized pricing of many amounts with tax, i.e. unitPrice * quantity + tax
+///       rounded once (see TaxRate::taxOn), e.g., the taxable amount of every tax class
+///       of a batch of carts with a quantity of 1 (see BatchPricer).
+///       Uses AVX2 when the CPU supports it (checked once at runtime) and a scalar loop
+///       otherwise. Both give exactly the same result.
+class LineKernel
+{
+
+public:
+    ///@brief Checks if a line is small enough for the kernel to price exactly
+    ///@remarks True for any line under roughly $17 million before tax. Bigger lines
+    /// have to be priced with PricingTable::priceLine.
+    static bool fits(const std::int64_t i_UnitPriceCents, const std::int64_t i_Quantity, const std::int32_t i_TaxBasisPoints)
+    {
+        return i_UnitPriceCents >= 0 && i_Quantity >= 0 && i_TaxBasisPoints >= 0 && i_TaxBasisPoints <= MAX_TAX_BASIS_POINTS &&
+               i_UnitPriceCents <= INT32_MAX && i_Quantity <= INT32_MAX &&
+               i_UnitPriceCents * i_Quantity <= MAX_LINE_CENTS;
+    }
+
+    ///@brief Prices i_Count lines given as parallel arrays
+    ///@pre fits() is true for every line
+    ///@param o_Cost Receives the cost (incl. tax) of each line in cents
+    static void priceLines(
+        const std::int32_t *i_UnitPriceCents,
+        const std::int32_t *i_TaxBasisPoints,
+        const std::int32_t *i_Quantity,
+        const std::size_t i_Count,
+        std::int64_t *o_Cost);
+
+    ///@brief Indicates if priceLines() uses the vectorized (AVX2) code path
+    static bool isVectorized();
+
+private:
+    /// Limits that keep every intermediate value of the vectorized path exactly
+    /// representable as a double (see LineKernel.cpp)
+    static constexpr std::int64_t MAX_LINE_CENTS = (std::int64_t(1) << 44) / 10000;
+    static constexpr std::int32_t MAX_TAX_BASIS_POINTS = 10000;
+
+    ///@brief Scalar fallback, same arithmetic as Money/TaxRate
+    static void priceLinesScalar(
+        const std::int32_t *i_UnitPriceCents,
+        const std::int32_t *i_TaxBasisPoints,
+        const std::int32_t *i_Quantity,
+        const std::size_t i_Count,
+        std::int64_t *o_Cost);
+};
@@ -0,0 +1,56 @@
+// Standard Library
+#include <cstddef>
+#include <string>
+#pragma once
+
+///@brief Memory mapping of a whole file.
+///       Pages are loaded on demand and shared by every process that maps the same file.
+class MappedFile
+{
+
+public:
+    ///@brief Maps an existing file read-only
+    ///@throws std::runtime_error if the file can't be opened or mapped
+    explicit MappedFile(const std::string &i_Path);
+    ///@brief Maps a file read-write, creating it if needed and growing it to at least
+    /// i_Size bytes. The disk space is allocated up front, so writing to the mapping
+    /// never has to extend the file.
+    ///@remarks Writes are visible to other processes (and survive a crash of this one)
+    /// as soon as they are made, and reach the disk when sync() is called
+    ///@throws std::runtime_error if the file can't be opened, grown or mapped
+    MappedFile(const std::string &i_Path, const std::size_t i_Size);
+    virtual ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ///@brief Start of the mapping (page aligned), nullptr for an empty file
+    const void *data() const
+    {
+        return m_Data;
+    }
+    ///@pre The file was mapped read-write
+    void *data()
+    {
+        return m_Data;
+    }
+    std::size_t size() const
+    {
+        return m_Size;
+    }
+
+    ///@brief Writes the changed pages of [i_Offset, i_Offset + i_Length) to the disk and
+    /// waits until they are stored
+    ///@pre The file was mapped read-write
+    ///@throws std::runtime_error if the pages can't be written
+    void sync(const std::size_t i_Offset, const std::size_t i_Length);
+
+private:
+    void *m_Data;
+    std::size_t m_Size;
+#ifdef _WIN32
+    /// Windows handles of the open file and of the mapping
+    void *m_File;
+    void *m_Mapping;
+#endif
+};
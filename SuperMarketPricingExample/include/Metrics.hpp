@@ -0,0 +1,196 @@
+// Standard Library
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#pragma once
+
+///@brief Optional instrumentation of the checkout: event counters and latency histograms.
+///       Each thread records into its own shard (single writer, no locked instructions),
+///       and the shards are only merged when a snapshot is taken, so lanes running on
+///       different threads never contend on the same cache lines.
+///@remarks Recording is off until setEnabled(true) is called, and then costs one relaxed
+/// load per call site. Building with -DSMP_DISABLE_METRICS removes the call sites entirely.
+class Metrics
+{
+
+public:
+    ///@brief Events that are counted
+    enum Counter
+    {
+        SCANS,                    ///< Checkout::scan() and scanWeight() calls
+        LOOKUPS,                  ///< Item lookups in the catalog
+        LOOKUP_MISSES,            ///< Lookups of IDs that aren't in the catalog
+        BUNDLE_MATCHES,           ///< Checkout repricings of a pair of lines that complete at
+                                  ///< least one bundle
+        BUY_X_GET_Y_APPLICATIONS, ///< Checkout line repricings where at least one Buy X Get Y
+                                  ///< deal applied
+        CATALOG_UPDATES,          ///< Changes to a PricingScheme, one per item added, updated or
+                                  ///< removed, tax rate set, or deal scheduled or cleared
+                                  ///< (applyDelta() counts each change of the delta)
+        NUMBER_OF_COUNTERS
+    };
+
+    ///@brief Operations whose latency is recorded
+    enum Timer
+    {
+        SCAN,      ///< Checkout::scan() and scanWeight()
+        GET_TOTAL, ///< Checkout::getTotal()
+        COMPILE,   ///< PricingScheme::compile()
+        NUMBER_OF_TIMERS
+    };
+
+    ///@brief HDR-style histogram of durations in nanoseconds.
+    ///       Buckets are log-linear: every power of two is split into SUB_BUCKETS linear
+    ///       buckets, so any recorded value is known to within 1/SUB_BUCKETS (~6%) over the
+    ///       whole 64-bit range, with a fixed, small number of buckets.
+    class Histogram
+    {
+
+    public:
+        static constexpr unsigned SUB_BUCKET_BITS = 4;
+        static constexpr std::size_t SUB_BUCKETS = std::size_t(1) << SUB_BUCKET_BITS;
+        static constexpr std::size_t NUMBER_OF_BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+        Histogram();
+        virtual ~Histogram();
+
+        void record(const std::uint64_t i_Value);
+        ///@brief Adds the counts of i_Other to this histogram
+        void merge(const Histogram &i_Other);
+
+        std::uint64_t getCount() const
+        {
+            return m_Count;
+        }
+        std::uint64_t getSum() const
+        {
+            return m_Sum;
+        }
+        std::uint64_t getMax() const
+        {
+            return m_Max;
+        }
+
+        ///@brief Value below which i_Fraction of the recorded values are
+        ///@param i_Fraction in [0, 1], e.g., 0.99 for the 99th percentile
+        ///@return Highest value of the matching bucket (capped at getMax()), 0 if empty
+        std::uint64_t getPercentile(const double i_Fraction) const;
+
+        ///@brief Bucket that a value is counted in
+        static std::size_t getBucket(const std::uint64_t i_Value);
+        ///@brief Lowest and highest value counted in a bucket
+        static std::uint64_t getBucketLowest(const std::size_t i_Bucket);
+        static std::uint64_t getBucketHighest(const std::size_t i_Bucket);
+
+    private:
+        friend class Metrics;
+
+        std::array<std::uint64_t, NUMBER_OF_BUCKETS> m_Buckets;
+        std::uint64_t m_Count;
+        std::uint64_t m_Sum;
+        std::uint64_t m_Max;
+    };
+
+    ///@brief Merged values of every thread at one point in time
+    struct Snapshot
+    {
+        std::array<std::uint64_t, NUMBER_OF_COUNTERS> counters;
+        std::array<Histogram, NUMBER_OF_TIMERS> timers;
+
+        std::uint64_t get(const Counter i_Counter) const
+        {
+            return counters[i_Counter];
+        }
+        const Histogram &get(const Timer i_Timer) const
+        {
+            return timers[i_Timer];
+        }
+    };
+
+    ///@brief Records the duration of the enclosing scope
+    class ScopedTimer
+    {
+
+    public:
+        explicit ScopedTimer(const Timer i_Timer)
+            : m_Timer(i_Timer),
+              m_Enabled(isEnabled())
+        {
+            if (m_Enabled)
+            {
+                m_Start = std::chrono::steady_clock::now();
+            }
+        }
+        ~ScopedTimer()
+        {
+            if (m_Enabled)
+            {
+                record(m_Timer, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now() - m_Start)
+                                    .count());
+            }
+        }
+
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+    private:
+        const Timer m_Timer;
+        const bool m_Enabled;
+        std::chrono::steady_clock::time_point m_Start;
+    };
+
+    ///@brief Turns recording on or off for all threads
+    static void setEnabled(const bool i_Enabled);
+    static bool isEnabled()
+    {
+        return s_Enabled.load(std::memory_order_relaxed);
+    }
+
+    ///@brief Adds i_Amount to a counter of the calling thread (if recording is on)
+    static void count(const Counter i_Counter, const std::uint64_t i_Amount = 1)
+    {
+        if (isEnabled())
+        {
+            add(i_Counter, i_Amount);
+        }
+    }
+
+    ///@brief Records a duration in nanoseconds for the calling thread (even if recording is off)
+    static void record(const Timer i_Timer, const std::int64_t i_Nanoseconds);
+
+    ///@brief Merges the shards of all threads (including threads that have exited)
+    ///@remarks Safe to call while other threads are recording; their most recent events
+    /// may or may not be included
+    static Snapshot snapshot();
+
+    ///@brief Clears all counters and histograms
+    ///@pre No other thread is recording (events recorded concurrently may survive)
+    static void reset();
+
+    ///@brief Formats a snapshot in the Prometheus text exposition format.
+    ///       Counters become `supermarket_<name>_total` counters and timers become
+    ///       `supermarket_<name>_duration_nanoseconds` summaries (p50, p90, p99, p999).
+    static std::string exportText(const Snapshot &i_Snapshot);
+
+    static const char *getName(const Counter i_Counter);
+    static const char *getName(const Timer i_Timer);
+
+private:
+    ///@brief Adds to a counter of the calling thread's shard
+    static void add(const Counter i_Counter, const std::uint64_t i_Amount);
+
+    static std::atomic<bool> s_Enabled;
+};
+
+/// Call sites, so that instrumentation can be compiled out with -DSMP_DISABLE_METRICS
+#ifdef SMP_DISABLE_METRICS
+#define SMP_METRICS_COUNT(counter) ((void)0)
+#define SMP_METRICS_TIME(timer) ((void)0)
+#else
+#define SMP_METRICS_COUNT(counter) Metrics::count(Metrics::counter)
+#define SMP_METRICS_TIME(timer) const Metrics::ScopedTimer metricsTimer(Metrics::timer)
+#endif
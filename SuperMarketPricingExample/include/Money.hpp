@@ -0,0 +1,162 @@
+// Standard Library
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#pragma once
+
+///@brief Fixed-point amount of money, stored as a whole number of cents.
+///       Only integer arithmetic is used, so totals are exact and deterministic.
+class Money
+{
+
+public:
+    constexpr Money()
+        : m_Cents(0)
+    {
+    }
+    constexpr explicit Money(const std::int64_t i_Cents)
+        : m_Cents(i_Cents)
+    {
+    }
+
+    ///@brief Converts a dollar amount (e.g., $2.49 == 2.49) to Money
+    ///@remarks Rounds to the nearest cent. Meant for loading data, not for pricing.
+    static Money fromDollars(const double i_Dollars);
+
+    constexpr std::int64_t getCents() const
+    {
+        return m_Cents;
+    }
+
+    constexpr Money operator+(const Money i_Other) const
+    {
+        return Money(m_Cents + i_Other.m_Cents);
+    }
+    constexpr Money operator-(const Money i_Other) const
+    {
+        return Money(m_Cents - i_Other.m_Cents);
+    }
+    constexpr Money operator*(const std::int64_t i_Factor) const
+    {
+        return Money(m_Cents * i_Factor);
+    }
+    Money &operator+=(const Money i_Other)
+    {
+        m_Cents += i_Other.m_Cents;
+        return *this;
+    }
+    Money &operator-=(const Money i_Other)
+    {
+        m_Cents -= i_Other.m_Cents;
+        return *this;
+    }
+    constexpr bool operator==(const Money i_Other) const
+    {
+        return m_Cents == i_Other.m_Cents;
+    }
+    constexpr bool operator!=(const Money i_Other) const
+    {
+        return m_Cents != i_Other.m_Cents;
+    }
+    constexpr bool operator<(const Money i_Other) const
+    {
+        return m_Cents < i_Other.m_Cents;
+    }
+
+    ///@brief Scales the amount by i_Numerator / i_Denominator
+    ///@remarks Rounds half away from zero to the nearest cent (e.g., price per kg * grams / 1000)
+    constexpr Money scale(const std::int64_t i_Numerator, const std::int64_t i_Denominator) const
+    {
+        const std::int64_t product = m_Cents * i_Numerator;
+        const std::int64_t half = i_Denominator / 2;
+        return Money((product >= 0 ? product + half : product - half) / i_Denominator);
+    }
+
+private:
+    std::int64_t m_Cents;
+};
+
+///@brief Writes the amount in dollars (e.g., 2.49)
+std::ostream &operator<<(std::ostream &io_Stream, const Money i_Money);
+
+///@brief Tax rate stored as a whole number of basis points (e.g., 9.25% == 925)
+class TaxRate
+{
+
+public:
+    constexpr TaxRate()
+        : m_BasisPoints(0)
+    {
+    }
+    constexpr explicit TaxRate(const std::int32_t i_BasisPoints)
+        : m_BasisPoints(i_BasisPoints)
+    {
+    }
+
+    constexpr std::int32_t getBasisPoints() const
+    {
+        return m_BasisPoints;
+    }
+
+    ///@brief Calculates the tax owed on an amount
+    ///@remarks Rounds half away from zero to the nearest cent. Tax is rounded once per
+    /// tax class of a cart, not per line or unit.
+    constexpr Money taxOn(const Money i_Amount) const
+    {
+        return i_Amount.scale(m_BasisPoints, 10000);
+    }
+
+    constexpr bool operator==(const TaxRate i_Other) const
+    {
+        return m_BasisPoints == i_Other.m_BasisPoints;
+    }
+    constexpr bool operator!=(const TaxRate i_Other) const
+    {
+        return m_BasisPoints != i_Other.m_BasisPoints;
+    }
+
+private:
+    std::int32_t m_BasisPoints;
+};
+
+///@brief Writes the rate in percent (e.g., 9.25%)
+std::ostream &operator<<(std::ostream &io_Stream, const TaxRate i_TaxRate);
+
+///@brief Tax class of an item (e.g., groceries, alcohol). Items only reference their
+///       class, and the rate of each class is set once in the tax table of the
+///       PricingScheme (see PricingScheme::setTaxRate), so a rate change doesn't
+///       touch the items.
+///@remarks Class 0 is the default, and its rate is 0 unless the scheme sets one
+class TaxClass
+{
+
+public:
+    /// # of tax classes of a scheme, IDs go from 0 to COUNT - 1
+    static constexpr std::size_t COUNT = 16;
+
+    constexpr TaxClass()
+        : m_Id(0)
+    {
+    }
+    constexpr explicit TaxClass(const std::uint8_t i_Id)
+        : m_Id(i_Id)
+    {
+    }
+
+    constexpr std::uint8_t getId() const
+    {
+        return m_Id;
+    }
+
+    constexpr bool operator==(const TaxClass i_Other) const
+    {
+        return m_Id == i_Other.m_Id;
+    }
+    constexpr bool operator!=(const TaxClass i_Other) const
+    {
+        return m_Id != i_Other.m_Id;
+    }
+
+private:
+    std::uint8_t m_Id;
+};
@@ -0,0 +1,52 @@
+// Local
+#include <Money.hpp>
+#include <PricingTable.hpp>
+#include <Promotion.hpp>
+// Standard Library
+#include <map>
+#include <string>
+#include <vector>
+#pragma once
+
+///@brief Prices of a few items for one customer (e.g., member prices and personal
+///       coupons), layered over a shared base table instead of copying the catalog.
+///       compile() resolves the overlay against a base table into a table that shares
+///       the base's image: items the overlay doesn't touch are read from the image, so
+///       an overlay costs time and memory proportional to its own size, not the catalog's.
+///@remarks A bundle coupon is set on both items of the pair, like a Bundle of an Item.
+class PricingOverlay
+{
+
+public:
+    PricingOverlay();
+    virtual ~PricingOverlay();
+
+    ///@brief Overrides the unit price of an item (e.g., its member price)
+    void setUnitPrice(const std::string &i_ID, const Money i_UnitPrice);
+
+    ///@brief Overrides the deal of an item (e.g., a personal coupon), SimplePrice removes it
+    ///@throws std::runtime_error if it is a BuyXGetY that isn't valid (see BuyXGetY::isValid)
+    ///@remarks Deals scheduled for the item (see PricingScheme::schedulePromotion) still
+    /// apply while they are in effect
+    void setPromotion(const std::string &i_ID, const Promotion &i_Promotion);
+
+    ///@brief # of items the overlay overrides
+    std::size_t size() const;
+
+    ///@brief Layers the overlay over a base table (which may itself carry an overlay)
+    ///@return Table with the base's image and items, and the overlay's prices and deals
+    ///        for the items it overrides. Items that aren't in the base are ignored.
+    ///@remarks Takes O(k log k) for k overridden items (one lookup per item and per
+    /// bundle partner), nothing is proportional to the size of the base
+    PricingTable compile(const PricingTable &i_Base) const;
+    ///@brief Same as compile(i_Base), and lists the items whose prices changed, e.g., to
+    /// move an open cart to the overlay (see Checkout::update)
+    ///@param o_Changed Receives the index of every item the overlay overrides
+    PricingTable compile(const PricingTable &i_Base, std::vector<PricingTable::Index> &o_Changed) const;
+
+private:
+    /// Overridden unit prices (key=ID)
+    std::map<std::string, Money> m_UnitPrices;
+    /// Overridden deals (key=ID)
+    std::map<std::string, Promotion> m_Promotions;
+};
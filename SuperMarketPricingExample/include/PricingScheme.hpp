@@ -1,8 +1,13 @@
 // Local
 #include <Item.hpp>
+#include <PricingTable.hpp>
 // Standard Library
+#include <array>
+#include <cstdint>
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 #pragma once
 
 ///@brief Class for storing the pricing schemes of supermarket items (e.g., unit price, tax, deals)
@@ -10,30 +15,166 @@
 /// - Do not have to account for overflow
 /// - Expect non-contradicting items with valid entries and no duplicates (assume data comes from db and scanner only scans valid items)
 /// - Bundle and BuyXGetY are mutually exclusive deals (i.e., an item can't have both)
-/// - Bundle Deals only support pairs of items (e.g., chips and salsa, but not toothbrush, floss, and toothpaste)
+/// - Bundle Deals only support pairs of items (e.g., chips and salsa, but not toothbrush, floss, and toothpaste).
+///   Both items of the pair have the bundle, with each other: a bundle the partner doesn't
+///   have (at the time of the cart) is priced as SimplePrice.
 /// - A Bundle is not taxed
 /// - Free items are not taxed
+/// - Items reference a tax class, whose rate is in the scheme's tax table. The taxable
+///   amount of a cart is added up per class and each class is taxed (and rounded) once.
 /// - There is no limit on the # of times a customer can receive a given deal
+/// - An item can have deals scheduled for windows of time (happy hours, weekday or
+///   date-ranged deals), which replace its own deal while they are in effect. The windows
+///   of an item's scheduled deals don't overlap. A scheduled bundle is scheduled for both
+///   items of the pair, with the same window (it is only in effect while both have it).
 /// .
+/// Deals over more than two items, or that overlap (mix and match, meal deals, an item
+/// eligible for several deals), are DealRules priced by a PromotionEngine on top of
+/// the items' own deals.
 class PricingScheme
 {
 
 public:
+    ///@brief Batch of changes that is published as one version (see applyDelta)
+    struct Delta
+    {
+        /// Items to add, or to update if their ID is already in the scheme
+        std::vector<Item> items;
+        /// IDs of items to remove
+        std::vector<std::string> removedIds;
+        /// New rates of tax classes
+        std::vector<std::pair<TaxClass, TaxRate>> taxRates;
+    };
+
     PricingScheme();
     virtual ~PricingScheme();
 
     ///@brief Adds an item's pricing scheme to the inventory
     ///@post Overwrites pricing scheme if item already exists
+    ///@post Increments the version of the pricing scheme
+    ///@throws std::runtime_error if the item's tax class isn't below TaxClass::COUNT
     void addItem(const Item &i_Item);
 
-    std::map<std::string, Item> getItemMap()
+    ///@brief Removes an item from the inventory
+    ///@post Increments the version of the pricing scheme, unless the item wasn't there
+    ///@post The deals scheduled for the item are removed too
+    void removeItem(const std::string &i_ID);
+
+    ///@brief Sets the rate of every item of a tax class (e.g., when a jurisdiction
+    /// changes its rate), without touching the items
+    ///@post Increments the version of the pricing scheme. No item is changed (see
+    ///      getChangesSince): lines are priced before tax, so an open cart moved to the
+    ///      new table (see Checkout::update) is taxed at the new rate without repricing.
+    ///@throws std::runtime_error if the class isn't below TaxClass::COUNT
+    void setTaxRate(const TaxClass i_TaxClass, const TaxRate i_TaxRate);
+
+    ///@return Rate of the tax class, 0 if it was never set
+    TaxRate getTaxRate(const TaxClass i_TaxClass) const
+    {
+        return i_TaxClass.getId() < TaxClass::COUNT ? m_TaxRates[i_TaxClass.getId()] : TaxRate();
+    }
+
+    ///@brief Schedules a deal of an item for a window of time. While the window is in
+    /// effect, the deal replaces the item's own promotion (see PricingTable::findDeal).
+    ///@post Increments the version of the pricing scheme. The item counts as changed (see
+    ///      getChangesSince).
+    ///@throws std::runtime_error if the item isn't in the scheme, the deal is a BuyXGetY
+    ///        that isn't valid, the window is empty or repeats more than MAX_OCCURRENCES
+    ///        times or more often than it lasts, or it overlaps a window already scheduled
+    ///        for the item
+    ///@remarks Deals are scheduled ahead of time: a deal starting or ending doesn't change
+    /// the scheme, so nothing is rebuilt or redistributed when it does.
+    void schedulePromotion(const std::string &i_ID, const Promotion &i_Promotion, const PromotionWindow &i_Window);
+
+    ///@brief Removes every deal scheduled for an item
+    ///@post Increments the version of the pricing scheme, unless the item had none
+    void clearSchedule(const std::string &i_ID);
+
+    /// Most occurrences a window can have (e.g., a daily deal for 179 years)
+    static constexpr std::int64_t MAX_OCCURRENCES = 65536;
+
+    ///@brief Applies a batch of adds, updates, removals and tax rates as a single new version
+    ///@post Increments the version of the pricing scheme once, unless the batch is empty
+    ///@throws std::runtime_error if a tax class isn't below TaxClass::COUNT (the batch is
+    ///        then not applied)
+    void applyDelta(const Delta &i_Delta);
+
+    ///@brief Looks up which items changed after a version, e.g., so open carts priced
+    /// with a table of that version can reprice only those lines (see Checkout::update)
+    ///@param o_Changed Receives the index of every item added, updated or removed after
+    ///       i_Version, without duplicates
+    ///@return false if the journal doesn't go back to i_Version (see trimJournal), in
+    ///        which case everything has to be considered changed
+    ///@remarks Takes time proportional to the # of changes, not to the catalog size
+    bool getChangesSince(const std::uint64_t i_Version, std::vector<PricingTable::Index> &o_Changed) const;
+
+    ///@brief Forgets the changes up to and including i_Version, once no open cart is
+    /// older than that
+    void trimJournal(const std::uint64_t i_Version);
+
+    const std::map<std::string, Item> &getItemMap() const
     {
         return m_ItemMap;
     }
 
+    ///@brief Version of the pricing scheme, incremented on every change
+    std::uint64_t getVersion() const
+    {
+        return m_Version;
+    }
+
+    ///@brief Resolves the pricing scheme into a dense, index-based table for checkout
+    ///@remarks Item IDs (including bundle partners) are resolved once here instead of
+    ///         on every cart line.
+    ///@remarks Items are indexed in the order they were first added, and keep their
+    ///         index for the life of the scheme (a removed item leaves an index that
+    ///         find() never returns), so cart lines can be carried over from one table
+    ///         of the scheme to the next.
+    ///@remarks The table is stamped with the current version of the pricing scheme
+    ///@remarks Scheduled deals are compiled into an interval index of each item's
+    ///         windows, so the deal in effect at a given time is found with a binary
+    ///         search (see PricingTable::findDeal)
+    ///@remarks Items whose ID is a GTIN (8, 12, 13 or 14 digits) are also indexed by their
+    ///         number in a minimal perfect hash (see PricingTable::findBarcode), which
+    ///         takes around half a microsecond per item to build
+    PricingTable compile() const;
+
 private:
+    ///@brief Helper function to check that a tax class is in the tax table
+    ///@throws std::runtime_error if it isn't
+    static void checkTaxClass(const TaxClass i_TaxClass);
+
+    ///@brief Helper function to check that a window can be scheduled for an item
+    ///@throws std::runtime_error if it can't (see schedulePromotion)
+    static void checkWindow(const std::vector<std::pair<PromotionWindow, Promotion>> &i_Schedule, const PromotionWindow &i_Window);
+    ///@brief Helper function to add or update an item as part of version i_Version
+    void setItem(const Item &i_Item, const std::uint64_t i_Version);
+    ///@brief Helper function to remove an item as part of version i_Version
+    ///@return false if the item wasn't in the inventory
+    bool eraseItem(const std::string &i_ID, const std::uint64_t i_Version);
+
     ///Map to lookup Item's pricing scheme based on its ID.
     ///Note: Could an unordered map if this gets too big, but
     /// would use more memory.
     std::map<std::string, Item> m_ItemMap;
+
+    /// Incremented every time the pricing scheme changes
+    std::uint64_t m_Version;
+
+    /// Deals scheduled for each item, in the order they were scheduled (key=ID)
+    std::map<std::string, std::vector<std::pair<PromotionWindow, Promotion>>> m_Schedules;
+
+    /// Rate of each tax class, by class ID
+    std::array<TaxRate, TaxClass::COUNT> m_TaxRates;
+
+    /// Index of every item ever added, removed ones included (key=ID)
+    std::map<std::string, PricingTable::Index> m_Indices;
+    /// ID of every index
+    std::vector<std::string> m_Ids;
+
+    /// Change journal: (version, index of the item changed in that version), in
+    /// version order
+    std::vector<std::pair<std::uint64_t, PricingTable::Index>> m_Journal;
+    /// Changes after this version are all in the journal
+    std::uint64_t m_JournalStart;
 };
\ No newline at end of file
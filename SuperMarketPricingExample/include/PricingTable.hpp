@@ -0,0 +1,527 @@
+// Local
+#include <Money.hpp>
+#include <Promotion.hpp>
+// Standard Library
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+#pragma once
+
+///@brief Dense, index-based form of a PricingScheme (see PricingScheme::compile()).
+///       Every item ID is interned to a small integer index and the pricing data is laid
+///       out as parallel arrays (structure-of-arrays), so pricing a cart line is a few
+///       array reads instead of string-keyed map lookups.
+///       All of the data lives in one contiguous, position-independent binary image
+///       (header + arrays), which is also the on-disk catalog format (see CatalogFile).
+///       A table can therefore be served straight from a memory-mapped file, and
+///       copying a table only copies a reference to its image.
+///       Deals scheduled for windows of time are compiled into the image too, as a sorted
+///       interval index per item, so the deal in effect at any time is found without
+///       rebuilding or redistributing the table when a deal starts or ends.
+///       A table can also carry a few overridden items (see PricingOverlay), e.g., the
+///       member prices of one customer, on top of a shared image: lookups of the other
+///       items fall through to the image.
+class PricingTable
+{
+
+public:
+    /// Position of an item in the table's arrays
+    using Index = std::uint32_t;
+
+    /// Returned by find() for IDs that aren't in the table, and used as the bundle
+    /// partner of items that don't have a bundle deal
+    static constexpr Index NO_INDEX = UINT32_MAX;
+
+    PricingTable();
+    virtual ~PricingTable();
+
+    ///@brief Looks up the index of the item with the given ID
+    ///@return Index of the item, or NO_INDEX if the item isn't in the table
+    Index find(std::string_view i_ID) const;
+
+    ///@brief Looks up the index of the item whose ID is the given GTIN (see Barcode::toKey)
+    ///@return Index of the item, or NO_INDEX if no item has that GTIN
+    ///@remarks The barcode index is a minimal perfect hash of the GTINs of the catalog, so
+    /// a lookup hashes the number, reads one displacement and probes exactly one slot
+    /// (~1% of the keys go through a remapping entry first)
+    Index findBarcode(const std::uint64_t i_Key) const;
+
+    ///@brief Creates a table over an existing binary image (e.g., a memory-mapped file)
+    ///@param i_Storage Keeps the image alive for as long as the table (or a copy) exists
+    ///@param i_VerifyChecksum Set to false to skip the checksum (e.g., image was just built)
+    ///@throws std::runtime_error if the image is not a valid catalog of this format version.
+    ///        Every index in the image (tax classes, deals, bundle partners, ID offsets,
+    ///        slots and barcode entries) is bounds-checked even if the checksum is skipped,
+    ///        so a corrupt image is rejected rather than read out of bounds. Without the
+    ///        checksum, a corrupt price is not detected.
+    static PricingTable fromImage(
+        std::shared_ptr<const void> i_Storage,
+        const void *i_Image,
+        const std::size_t i_ImageSize,
+        const bool i_VerifyChecksum = true);
+
+    ///@brief Binary image of the table, i_ImageSize bytes long (see fromImage)
+    ///@remarks Overridden items (see PricingOverlay) aren't part of the image
+    const void *getImage() const
+    {
+        return m_Header;
+    }
+    std::size_t getImageSize() const
+    {
+        return m_Header->imageSize;
+    }
+
+    ///@brief Number of items in the table, including items removed from the scheme
+    /// (they keep their index, see PricingScheme::compile)
+    std::size_t size() const
+    {
+        return m_Header->numberOfItems;
+    }
+
+    ///@brief Version of the PricingScheme this table was compiled from
+    std::uint64_t getVersion() const
+    {
+        return m_Header->catalogVersion;
+    }
+
+    ///@brief Whether an item was removed from the scheme: it keeps its index (and ID) but
+    /// find() no longer returns it
+    bool isRemoved(const Index i_Index) const
+    {
+        return find(getId(i_Index)) != i_Index;
+    }
+
+    std::string_view getId(const Index i_Index) const
+    {
+        return std::string_view(
+            m_IdChars + m_IdOffsets[i_Index],
+            m_IdOffsets[i_Index + 1] - m_IdOffsets[i_Index]);
+    }
+    Money getUnitPrice(const Index i_Index) const
+    {
+        const Override *row = findOverride(i_Index);
+        return Money(row ? row->unitPrice : m_UnitPrice[i_Index]);
+    }
+    TaxClass getTaxClass(const Index i_Index) const
+    {
+        return TaxClass(m_TaxClass[i_Index]);
+    }
+    ///@brief Rate of a tax class in the scheme's tax table (see PricingScheme::setTaxRate)
+    TaxRate getTaxRate(const TaxClass i_TaxClass) const
+    {
+        return TaxRate(m_TaxRates[i_TaxClass.getId()]);
+    }
+    ///@brief Rate of the item's tax class
+    TaxRate getTax(const Index i_Index) const
+    {
+        return getTaxRate(getTaxClass(i_Index));
+    }
+
+    ///@brief Taxable amount of a cart in each tax class (see LineDetails::taxableCost),
+    /// by class ID
+    using TaxableAmounts = std::array<Money, TaxClass::COUNT>;
+
+    ///@brief Calculates the tax of a cart from its taxable amount in each class
+    ///@remarks Tax is rounded to the nearest cent once per class (see TaxRate::taxOn),
+    /// so there is one multiplication per class that the cart has items of
+    Money computeTax(const TaxableAmounts &i_Taxable) const
+    {
+        Money tax;
+        for (std::size_t taxClass = 0; taxClass < TaxClass::COUNT; ++taxClass)
+        {
+            if (Money(0) != i_Taxable[taxClass])
+            {
+                tax += TaxRate(m_TaxRates[taxClass]).taxOn(i_Taxable[taxClass]);
+            }
+        }
+        return tax;
+    }
+
+    ///@brief Looks up the deal of an item in effect at a given time
+    ///@param i_Time Seconds since the epoch (see PromotionWindow)
+    ///@return Deal to pass to the promotion getters (e.g., visitPromotion, describeLine):
+    ///        a scheduled deal whose window contains i_Time, or i_Index (the item's own
+    ///        promotion) if there is none
+    ///@remarks Binary search of the item's windows, so O(log n) in the # of windows
+    /// scheduled for the item. Items without scheduled deals only read two offsets.
+    Index findDeal(const Index i_Index, const std::int64_t i_Time) const
+    {
+        const std::int64_t *begin = m_ScheduleStart + m_ScheduleOffsets[i_Index];
+        const std::int64_t *end = m_ScheduleStart + m_ScheduleOffsets[i_Index + 1];
+        if (begin == end)
+        {
+            return i_Index;
+        }
+        return findScheduledDeal(i_Index, begin, end, i_Time);
+    }
+
+    ///@brief Period around a time during which no scheduled deal starts or ends, so
+    /// findDeal() returns the same deal for every item throughout
+    ///@return [start, end), INT64_MIN and INT64_MAX if unbounded
+    ///@remarks Binary search of the start and end times of every scheduled window
+    std::pair<std::int64_t, std::int64_t> getScheduleSegment(const std::int64_t i_Time) const;
+
+    ///@brief Compiled form of a Bundle, with the partner resolved to its index
+    struct BundleDeal
+    {
+        Index partner;
+        Money price;
+    };
+
+    ///@remarks The promotion getters take the index of an item, for its own promotion,
+    ///         or a deal found with findDeal()
+    ///@remarks A bundle whose partner isn't in the table is compiled as SimplePrice,
+    ///         since it can never be completed
+    PromotionKind getPromotionKind(const Index i_Index) const
+    {
+        const Override *row = findOverride(i_Index);
+        return static_cast<PromotionKind>(row ? row->promotionKind : m_PromotionKind[i_Index]);
+    }
+
+    ///@brief Calls i_Visitor with the item's promotion as a SimplePrice, BuyXGetY or
+    /// BundleDeal, and returns what it returns. The visitor is resolved at compile time
+    /// (e.g., an Overloaded of lambdas), so this is a switch on the kind, with nothing
+    /// allocated and no virtual calls.
+    template <typename Visitor>
+    decltype(auto) visitPromotion(const Index i_Index, Visitor &&i_Visitor) const
+    {
+        const Override *row = findOverride(i_Index);
+        switch (static_cast<PromotionKind>(row ? row->promotionKind : m_PromotionKind[i_Index]))
+        {
+        case PromotionKind::BUY_X_GET_Y:
+            return i_Visitor(row ? BuyXGetY{row->buyX, row->getY} : BuyXGetY{m_BuyX[i_Index], m_GetY[i_Index]});
+        case PromotionKind::BUNDLE:
+            return i_Visitor(row ? BundleDeal{row->bundlePartner, Money(row->bundlePrice)}
+                                 : BundleDeal{m_BundlePartner[i_Index], Money(m_BundlePrice[i_Index])});
+        default:
+            return i_Visitor(SimplePrice());
+        }
+    }
+
+    bool hasBuyXGetY(const Index i_Index) const
+    {
+        return PromotionKind::BUY_X_GET_Y == getPromotionKind(i_Index);
+    }
+    bool hasBundle(const Index i_Index) const
+    {
+        return PromotionKind::BUNDLE == getPromotionKind(i_Index);
+    }
+    ///@return Index of the bundle partner, or NO_INDEX if the item has no bundle deal
+    Index getBundlePartner(const Index i_Index) const
+    {
+        const Override *row = findOverride(i_Index);
+        return row ? row->bundlePartner : m_BundlePartner[i_Index];
+    }
+    Money getBundlePrice(const Index i_Index) const
+    {
+        const Override *row = findOverride(i_Index);
+        return Money(row ? row->bundlePrice : m_BundlePrice[i_Index]);
+    }
+    ///@brief Looks up the partner a bundle of an item is completed with at a given time.
+    /// A bundle is only in effect while the partner's deal is a bundle with the item too:
+    /// a one-sided bundle is priced as SimplePrice, like one whose partner isn't in the
+    /// table, so a line only ever depends on the line of its own partner.
+    ///@param i_Deal Deal of the item at i_Time (see findDeal)
+    ///@return Index of the partner, or NO_INDEX if i_Deal isn't a bundle or the partner's
+    ///        deal at i_Time isn't a bundle with the item
+    Index findBundlePartner(const Index i_Index, const Index i_Deal, const std::int64_t i_Time) const
+    {
+        const Index partner = hasBundle(i_Deal) ? getBundlePartner(i_Deal) : NO_INDEX;
+        if (NO_INDEX == partner)
+        {
+            return NO_INDEX;
+        }
+        const Index partnerDeal = findDeal(partner, i_Time);
+        return hasBundle(partnerDeal) && i_Index == getBundlePartner(partnerDeal) ? partner : NO_INDEX;
+    }
+
+    ///@brief # of items whose prices are overridden (see PricingOverlay), 0 for a table
+    /// that is just its image
+    std::size_t getNumberOfOverrides() const
+    {
+        return m_Overrides ? m_Overrides->size() : 0;
+    }
+
+    ///@brief Calculates the cost (incl. deals, before tax) of an item's line in a cart
+    ///@param i_NumberOf # of units of the item in the cart
+    ///@param i_Grams Weighed amount of the item in the cart (price is per kg, no deals)
+    ///@param i_NumberOfPartner # of units of the item's bundle partner in the cart
+    ///       (ignored if the item has no bundle deal, 0 if the partner doesn't have the
+    ///       bundle too, see findBundlePartner)
+    ///@remarks For a bundle, the bundle price is charged to the line of the item with the
+    /// lower index and each line pays for its own unbundled units, so the cost of a pair of
+    /// lines is the sum of priceLine() for both.
+    ///@remarks The weighed amount is rounded to the nearest cent. Tax isn't part of the
+    /// line: the taxable part of every line (see describeLine) is added up per tax class,
+    /// and each class is taxed once for the cart (see computeTax).
+    Money priceLine(const Index i_Index, const int i_NumberOf, const int i_Grams, const int i_NumberOfPartner) const
+    {
+        return describeLine(i_Index, i_NumberOf, i_Grams, i_NumberOfPartner).total;
+    }
+
+    ///@brief How the cost of a line (see priceLine) is made up, e.g., for a receipt.
+    ///       total == unitsCost + weightCost - freeSavings - bundleSavings
+    ///       for a line that isn't in a bundle. For a bundle, bundleSavings (on the
+    ///       line the bundle is charged to) also covers the partner's bundled units, so
+    ///       the identity holds for the sum of both lines.
+    struct LineDetails
+    {
+        /// # of units free thanks to Buy X Get Y
+        int numberOfFreeUnits;
+        /// # of bundles completed with the partner's line
+        int numberOfBundles;
+        /// Unit price * # of units, before any deal
+        Money unitsCost;
+        /// Price of the weighed amount
+        Money weightCost;
+        /// Unit price of the free units
+        Money freeSavings;
+        /// Unit prices of both items of the bundles charged to this line - bundle price
+        Money bundleSavings;
+        /// Part of the total that is taxed at the item's tax class: the units and weight
+        /// paid at the unit price (free units and bundle prices aren't taxed)
+        Money taxableCost;
+        /// Same as priceLine()
+        Money total;
+    };
+
+    ///@brief Breaks down the cost of a line the same way priceLine() calculates it
+    LineDetails describeLine(const Index i_Index, const int i_NumberOf, const int i_Grams, const int i_NumberOfPartner) const
+    {
+        return describeLine(i_Index, i_Index, i_NumberOf, i_Grams, i_NumberOfPartner);
+    }
+    ///@brief Breaks down the cost of a line with a given deal of the item, e.g., the one
+    /// in effect at the time of the cart (see findDeal)
+    ///@param i_NumberOfPartner # of units of the deal's bundle partner in the cart, 0 if
+    ///       the bundle isn't in effect (see findBundlePartner)
+    LineDetails describeLine(
+        const Index i_Index,
+        const Index i_Deal,
+        const int i_NumberOf,
+        const int i_Grams,
+        const int i_NumberOfPartner) const;
+
+    ///@brief Helper function to encapsulate logic for the Buy X, Get Y price scheme
+    ///@return # of units that have to be paid for out of i_NumberOf units
+    ///@remarks Closed form, so it takes the same time for any quantity
+    static int countPaidUnits(const BuyXGetY &i_Deal, const int i_NumberOf);
+
+private:
+    friend class PricingScheme;
+    friend class PricingOverlay;
+
+    ///@brief Pricing data of an item that replaces the item's data in the image (see
+    /// PricingOverlay), same meaning as the arrays of the image
+    struct Override
+    {
+        Index index;
+        std::int32_t promotionKind;
+        std::int64_t unitPrice;
+        std::int32_t buyX;
+        std::int32_t getY;
+        Index bundlePartner;
+        std::int64_t bundlePrice;
+    };
+
+    ///@brief Looks up the override of an item
+    ///@return nullptr if the item (or deal) isn't overridden
+    const Override *findOverride(const Index i_Index) const
+    {
+        return m_Overrides ? searchOverrides(i_Index) : nullptr;
+    }
+    ///@brief Helper function for findOverride() to binary search the overrides
+    const Override *searchOverrides(const Index i_Index) const;
+
+    ///@brief Pricing data of one item, used to build a table (see Item)
+    struct Entry
+    {
+        std::string_view id;
+        Money unitPrice;
+        TaxClass taxClass;
+        /// nullptr for an item that was removed: it keeps its index but can't be found
+        /// and is priced at 0
+        const Promotion *promotion;
+        /// Deals scheduled for the item and their windows, nullptr if there are none
+        const std::vector<std::pair<PromotionWindow, Promotion>> *schedule;
+    };
+
+    ///@brief Arrays of the binary image, in the order they are laid out
+    enum Section
+    {
+        UNIT_PRICE,          ///< int64 cents, one per item
+        TAX_CLASS,           ///< uint8 class ID, one per item
+        PROMOTION_KIND,      ///< int32 PromotionKind, one per item + numberOfScheduledDeals
+        BUY_X,               ///< int32, one per item + numberOfScheduledDeals
+        GET_Y,               ///< int32, one per item + numberOfScheduledDeals
+        BUNDLE_PARTNER,      ///< uint32 index, one per item + numberOfScheduledDeals
+        BUNDLE_PRICE,        ///< int64 cents, one per item + numberOfScheduledDeals
+        ID_OFFSETS,          ///< uint32, one per item + 1
+        SLOTS,               ///< uint32 index, numberOfSlots
+        ID_CHARS,            ///< char, idCharsSize
+        BARCODE_PILOTS,      ///< uint32 displacement, numberOfBarcodeBuckets
+        BARCODE_KEYS,        ///< uint64 GTIN, numberOfBarcodes
+        BARCODE_ITEMS,       ///< uint32 index, numberOfBarcodes
+        BARCODE_REMAP,       ///< uint32 slot, numberOfBarcodePositions - numberOfBarcodes
+        TAX_RATES,           ///< int32 basis points, one per tax class (TaxClass::COUNT)
+        SCHEDULE_OFFSETS,    ///< uint32, one per item + 1
+        SCHEDULE_START,      ///< int64 seconds, numberOfDealWindows
+        SCHEDULE_END,        ///< int64 seconds, numberOfDealWindows
+        SCHEDULE_DEAL,       ///< uint32 deal, numberOfDealWindows
+        SCHEDULE_BOUNDARIES, ///< int64 seconds, numberOfScheduleBoundaries
+        NUMBER_OF_SECTIONS
+    };
+
+    ///@brief Start of the binary image. All fields are in native byte order.
+    struct Header
+    {
+        /// FORMAT_MAGIC
+        char magic[8];
+        /// BYTE_ORDER_MARK as written by the machine that built the image
+        std::uint32_t byteOrderMark;
+        /// FORMAT_VERSION
+        std::uint32_t formatVersion;
+        /// Version of the PricingScheme the image was compiled from
+        std::uint64_t catalogVersion;
+        std::uint64_t numberOfItems;
+        std::uint64_t numberOfSlots;
+        std::uint64_t idCharsSize;
+        /// # of items whose ID is a GTIN, and # of buckets, positions and seed of their
+        /// perfect hash
+        std::uint64_t numberOfBarcodes;
+        std::uint64_t numberOfBarcodeBuckets;
+        std::uint64_t numberOfBarcodePositions;
+        std::uint64_t barcodeSeed;
+        /// # of scheduled deals (their promotions follow the items' own), # of windows
+        /// they are in effect, and # of distinct start and end times of those windows
+        std::uint64_t numberOfScheduledDeals;
+        std::uint64_t numberOfDealWindows;
+        std::uint64_t numberOfScheduleBoundaries;
+        /// Size of the whole image (header included), a multiple of 8 bytes
+        std::uint64_t imageSize;
+        /// Checksum of everything after the header (see computeChecksum)
+        std::uint64_t checksum;
+        /// Offset of each Section from the start of the image, 8-byte aligned
+        std::uint64_t sectionOffset[NUMBER_OF_SECTIONS];
+    };
+
+    static constexpr char FORMAT_MAGIC[8] = {'S', 'M', 'P', 'C', 'T', 'L', 'G', '\0'};
+    static constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+    static constexpr std::uint32_t FORMAT_VERSION = 5;
+
+    ///@brief Builds a table and its binary image from the given items and tax table
+    ///@pre IDs are unique
+    ///@post Item i of i_Entries has index i
+    static PricingTable build(
+        const std::uint64_t i_Version,
+        const std::vector<Entry> &i_Entries,
+        const std::array<TaxRate, TaxClass::COUNT> &i_TaxRates);
+
+    ///@brief One window of a scheduled deal, used to build a table
+    struct DealWindow
+    {
+        std::int64_t start;
+        std::int64_t end;
+        /// Item the deal is scheduled for
+        Index index;
+        Index deal;
+    };
+
+    ///@brief Fills the interval index of the scheduled deals (windows of each item)
+    ///@param i_Windows Every window of every scheduled deal, sorted by item then start
+    static void buildSchedule(
+        const std::vector<DealWindow> &i_Windows,
+        const Header &i_Header,
+        std::uint32_t *o_Offsets,
+        std::int64_t *o_Start,
+        std::int64_t *o_End,
+        Index *o_Deals);
+
+    ///@brief Helper function for findDeal() to search the windows of an item
+    ///@pre [i_Begin, i_End) are the start times of the item's windows, not empty
+    Index findScheduledDeal(const Index i_Index, const std::int64_t *i_Begin, const std::int64_t *i_End, const std::int64_t i_Time) const;
+
+    ///@brief Size in bytes of a section of a table with the given dimensions
+    static std::uint64_t getSectionSize(const Section i_Section, const Header &i_Header);
+
+    ///@brief Checksum of the image after the header (64-bit FNV-1a over 8-byte words)
+    static std::uint64_t computeChecksum(const Header &i_Header);
+
+    ///@brief Hash used for the ID lookup table (32-bit FNV-1a)
+    static std::uint32_t hashId(std::string_view i_ID);
+
+    ///@brief Fills the barcode sections with a minimal perfect hash of the given GTINs
+    ///       (hash and displace): keys are hashed into buckets of ~3, and the buckets,
+    ///       largest first, each get the smallest displacement (pilot) that moves all of
+    ///       their keys to free positions. There are ~1% more positions than keys, so the
+    ///       last buckets still find free positions quickly; the few keys at positions past
+    ///       the last slot are then remapped to the slots left free, so every slot is used.
+    ///@param i_Barcodes GTIN and index of each item, GTINs unique
+    ///@return Seed of the hash (another seed is tried if a bucket can't be placed)
+    static std::uint64_t buildBarcodeIndex(
+        const std::vector<std::pair<std::uint64_t, Index>> &i_Barcodes,
+        const Header &i_Header,
+        std::uint32_t *o_Pilots,
+        std::uint64_t *o_Keys,
+        Index *o_Items,
+        std::uint32_t *o_Remap);
+    ///@brief Hash of a GTIN, bucket of a hash and slot of a hash with a given pilot
+    static std::uint64_t hashBarcode(const std::uint64_t i_Key, const std::uint64_t i_Seed);
+    static std::uint64_t getBarcodeBucket(const std::uint64_t i_Hash, const std::uint64_t i_NumberOfBuckets);
+    static std::uint64_t getBarcodePosition(const std::uint64_t i_Hash, const std::uint32_t i_Pilot, const std::uint64_t i_NumberOfPositions);
+
+    ///@brief Creates a table over a binary image that has already been validated
+    PricingTable(std::shared_ptr<const void> i_Storage, const Header *i_Header);
+
+    /// Keeps the binary image alive
+    std::shared_ptr<const void> m_Storage;
+    const Header *m_Header;
+
+    /// Items whose pricing data isn't the image's, sorted by index. nullptr if there are
+    /// none, so the tables that are just an image only test a pointer.
+    std::shared_ptr<const std::vector<Override>> m_Overrides;
+
+    /// All item IDs back to back. ID of item i is [m_IdOffsets[i], m_IdOffsets[i + 1])
+    const char *m_IdChars;
+    const std::uint32_t *m_IdOffsets;
+
+    /// Open-addressing (linear probing) hash table of indices, size is a power of two.
+    /// Empty slots hold NO_INDEX.
+    const Index *m_Slots;
+
+    /// Minimal perfect hash of the GTIN item IDs (see buildBarcodeIndex): the GTIN and
+    /// the index of the item in each slot, the pilot of each bucket and the slot of each
+    /// position past the last slot
+    const std::uint32_t *m_BarcodePilots;
+    const std::uint64_t *m_BarcodeKeys;
+    const Index *m_BarcodeItems;
+    const std::uint32_t *m_BarcodeRemap;
+
+    /// Pricing data, one entry per item (see Item for the meaning of each field).
+    /// The promotion fields that don't apply to an item's kind are 0 (NO_INDEX for
+    /// the bundle partner). The promotion fields of the scheduled deals follow those
+    /// of the items, deal d is at d.
+    const std::int64_t *m_UnitPrice;
+    const std::uint8_t *m_TaxClass;
+    const std::int32_t *m_PromotionKind;
+    const std::int32_t *m_BuyX;
+    const std::int32_t *m_GetY;
+    const Index *m_BundlePartner;
+    const std::int64_t *m_BundlePrice;
+
+    /// Rate of each tax class, by class ID
+    const std::int32_t *m_TaxRates;
+
+    /// Interval index of the scheduled deals: the windows of item i are
+    /// [m_ScheduleOffsets[i], m_ScheduleOffsets[i + 1]), sorted by start time and
+    /// disjoint, each with the deal in effect during it. The start and end times of all
+    /// windows, sorted and without duplicates, are the boundaries of the schedule.
+    const std::uint32_t *m_ScheduleOffsets;
+    const std::int64_t *m_ScheduleStart;
+    const std::int64_t *m_ScheduleEnd;
+    const Index *m_ScheduleDeal;
+    const std::int64_t *m_ScheduleBoundaries;
+};
@@ -0,0 +1,107 @@
+// Local
+#include <Money.hpp>
+// Standard Library
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <variant>
+#pragma once
+
+///@brief No deal, every unit is paid at the unit price
+struct SimplePrice
+{
+};
+
+///@brief Buy X, get Y free
+struct BuyXGetY
+{
+    int buyX;
+    int getY;
+
+    ///@return Whether units can be counted off in groups of buyX paid and getY free
+    ///        (i.e., buyX > 0 and getY >= 0)
+    bool isValid() const
+    {
+        return buyX > 0 && getY >= 0;
+    }
+};
+
+///@brief Buying this item together with another item (partnerId) costs price for both
+///@remarks Only in effect while the partner has a bundle with this item too: a bundle
+/// the partner doesn't name back is priced as SimplePrice (see PricingTable::findBundlePartner)
+struct Bundle
+{
+    std::string partnerId;
+    Money price;
+};
+
+///@brief Deal that applies to an item. The set of kinds is closed, so code handling
+/// promotions dispatches with std::visit (or PricingTable::visitPromotion) and the
+/// compiler checks that every kind is handled.
+///@remarks To add a kind, add its type here and to PromotionKind (same position), then
+/// handle it in every visitor.
+using Promotion = std::variant<SimplePrice, BuyXGetY, Bundle>;
+
+///@brief Checks that a deal of an item can be priced
+///@param i_ID Item the deal is for, named in the error
+///@throws std::runtime_error if it is a BuyXGetY that isn't valid (see BuyXGetY::isValid)
+void validatePromotion(const std::string &i_ID, const Promotion &i_Promotion);
+
+///@brief When a scheduled deal is in effect (see PricingScheme::schedulePromotion), in
+///       seconds since the epoch (Unix time): from start (included) to end (excluded),
+///       and again every period seconds, for as long as occurrences start before until.
+///
+/// e.g., a happy hour every day of June: {June 1st 17:00, June 1st 19:00, 86400, July 1st}
+/// with the times of the store's time zone converted to Unix time
+struct PromotionWindow
+{
+    std::int64_t start;
+    std::int64_t end;
+    /// Seconds from one occurrence to the next (e.g., 604800 for weekly), 0 == only once
+    std::int64_t period = 0;
+    /// No occurrence starts at or after this time (ignored if period is 0)
+    std::int64_t until = 0;
+
+    ///@brief Current time of the system clock, in seconds since the epoch
+    static std::int64_t getCurrentTime()
+    {
+        return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    ///@brief # of times the window occurs
+    ///@pre start < end, and until > start if period isn't 0
+    std::int64_t getNumberOfOccurrences() const
+    {
+        return 0 == period ? 1 : (until - start + period - 1) / period;
+    }
+
+    ///@brief Calls i_Visitor(start, end) for every occurrence, in order
+    template <typename Visitor>
+    void forEachOccurrence(Visitor &&i_Visitor) const
+    {
+        const std::int64_t numberOfOccurrences = getNumberOfOccurrences();
+        for (std::int64_t occurrence = 0; occurrence < numberOfOccurrences; ++occurrence)
+        {
+            i_Visitor(start + occurrence * period, end + occurrence * period);
+        }
+    }
+};
+
+///@brief Kind of a Promotion, as stored in a compiled PricingTable
+///@remarks Values are the alternative indices of Promotion
+enum class PromotionKind : std::int32_t
+{
+    SIMPLE_PRICE = 0,
+    BUY_X_GET_Y = 1,
+    BUNDLE = 2
+};
+
+///@brief Builds a visitor out of lambdas, e.g.,
+///     std::visit(Overloaded{[](const SimplePrice &) {...}, [](const BuyXGetY &) {...}, ...}, promotion)
+template <typename... Handlers>
+struct Overloaded : Handlers...
+{
+    using Handlers::operator()...;
+};
+template <typename... Handlers>
+Overloaded(Handlers...) -> Overloaded<Handlers...>;
@@ -0,0 +1,118 @@
+// Local
+#include <Money.hpp>
+#include <PricingTable.hpp>
+// Standard Library
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#pragma once
+
+///@brief A deal over several items that can overlap with other deals, e.g.,
+///       - mix and match: any 3 of {A, B, C} for $10 (one slot, quantity 3)
+///       - meal deal: a main, a drink and a snack for $5 (three slots, quantity 1 each)
+///@remarks Like a Bundle, the deal price is not taxed
+struct DealRule
+{
+    ///@brief Part of a deal: i_Quantity units, each of any of the eligible items
+    struct Slot
+    {
+        std::vector<std::string> eligibleIds;
+        int quantity;
+    };
+
+    std::string name;
+    std::vector<Slot> slots;
+    /// Price of all units of one application of the deal
+    Money price;
+};
+
+///@brief Finds the customer-optimal set of non-conflicting deals for a cart.
+///       Units can be used by at most one deal; units that aren't used by a deal are
+///       priced as usual (PricingTable::describeLine, so item promotions, including the
+///       ones scheduled for the pricing time, and tax still apply).
+///
+///       The search is a branch and bound over deal applications: rules are applied in a
+///       fixed order and the units of repeated applications in non-decreasing order, so
+///       every set of deals is visited once, and a branch is cut as soon as a lower bound
+///       of its cost (deal prices so far + cheapest possible price of every remaining unit)
+///       can't beat the best set found. The greedy assignment (repeatedly take the deal that
+///       saves the most) is the starting point, so when the time budget runs out the result
+///       is never worse than greedy.
+class PromotionEngine
+{
+
+public:
+    ///@brief One application of a deal
+    struct AppliedDeal
+    {
+        /// Position of the rule in the engine's rules
+        std::size_t rule;
+        /// Item of every unit used, slot by slot
+        std::vector<PricingTable::Index> items;
+    };
+
+    ///@brief Pricing of one cart
+    struct Result
+    {
+        Money total;
+        std::vector<AppliedDeal> deals;
+        /// False if the time budget ran out before the search was complete
+        bool isOptimal;
+        /// # of search nodes visited
+        std::size_t numberOfNodes;
+    };
+
+    ///@param i_Rules Eligible IDs that aren't in the table are ignored
+    ///@throws std::runtime_error if a rule has no slots or a slot has no units
+    PromotionEngine(std::shared_ptr<const PricingTable> i_PricingTable, const std::vector<DealRule> &i_Rules);
+    virtual ~PromotionEngine();
+
+    ///@brief Prices a cart with the best deals that can be found within the time budget
+    ///@param i_Cart Item IDs scanned, in any order (unknown IDs are ignored)
+    ///@param i_Budget Time the search may take. 0 == greedy assignment only.
+    Result price(const std::vector<std::string> &i_Cart, const std::chrono::microseconds i_Budget = std::chrono::microseconds(1000)) const;
+
+    const std::vector<DealRule> &getRules() const
+    {
+        return m_Rules;
+    }
+
+    ///@brief Sets the time carts are priced at, so the item deals scheduled for that time
+    /// apply (see Checkout::setTime)
+    ///@param i_Time Seconds since the epoch (see PromotionWindow)
+    ///@pre No cart is being priced
+    void setTime(const std::int64_t i_Time)
+    {
+        m_Time = i_Time;
+    }
+    ///@brief Time carts are priced at, the time the engine was created unless setTime()
+    /// was called
+    std::int64_t getTime() const
+    {
+        return m_Time;
+    }
+
+private:
+    ///@brief Search state for one cart (see PromotionEngine.cpp)
+    class Search;
+
+    ///@brief Rule resolved against the table
+    struct CompiledRule
+    {
+        /// Eligible items of each slot, most expensive first
+        std::vector<std::vector<PricingTable::Index>> eligible;
+        std::vector<int> quantity;
+        Money price;
+        /// Deal price divided by its # of units, rounded down
+        Money pricePerUnit;
+    };
+
+    std::shared_ptr<const PricingTable> m_PricingTable;
+    std::vector<DealRule> m_Rules;
+    std::vector<CompiledRule> m_CompiledRules;
+    /// Seconds since the epoch
+    std::int64_t m_Time;
+};
@@ -0,0 +1,88 @@
+// Local
+#include <Money.hpp>
+#include <PricingTable.hpp>
+// Standard Library
+#include <cstddef>
+#include <string_view>
+#pragma once
+
+///@brief Destination of receipt text, e.g., a printer driver or a socket
+class ReceiptSink
+{
+
+public:
+    virtual ~ReceiptSink();
+
+    ///@brief Receives the next piece of the receipt (one row, new line included)
+    ///@remarks The text is only valid during the call
+    virtual void write(std::string_view i_Text) = 0;
+};
+
+///@brief Sink that writes into a fixed, caller-provided buffer
+class BufferReceiptSink : public ReceiptSink
+{
+
+public:
+    BufferReceiptSink(char *o_Buffer, const std::size_t i_Size);
+    virtual ~BufferReceiptSink();
+
+    void write(std::string_view i_Text) override;
+
+    ///@brief # of chars written so far, or that would have been written if the buffer
+    /// was big enough (like std::snprintf)
+    std::size_t getLength() const
+    {
+        return m_Length;
+    }
+
+private:
+    char *const m_Buffer;
+    const std::size_t m_Size;
+    std::size_t m_Length;
+};
+
+///@brief Formats the rows of an itemized receipt, one fixed-width row at a time, into a
+///       ReceiptSink. Rows are built in a buffer on the stack, so nothing is allocated.
+///
+/// e.g.,
+///     1983 x4 @ 1.99                      7.96
+///       Buy 2 Get 1 Free (1 free)        -1.99
+///     0923 x1 @ 15.49                    15.49
+///     Tax 9.25% on 15.49                  1.43
+///     ----------------------------------------
+///     TOTAL                              22.89
+class ReceiptFormatter
+{
+
+public:
+    /// # of chars in a row, not counting the new line
+    static constexpr std::size_t WIDTH = 40;
+
+    explicit ReceiptFormatter(ReceiptSink &io_Sink);
+    virtual ~ReceiptFormatter();
+
+    ///@brief Writes the rows of one cart line
+    ///@param i_Deal Deal the line is priced with (see PricingTable::findDeal)
+    ///@param i_Details See PricingTable::describeLine
+    void addLine(
+        const PricingTable &i_Table,
+        const PricingTable::Index i_Index,
+        const PricingTable::Index i_Deal,
+        const int i_NumberOf,
+        const int i_Grams,
+        const PricingTable::LineDetails &i_Details);
+
+    ///@brief Writes the tax row of one tax class, i.e., its rate, the taxable amount of the
+    /// cart in that class and the tax on it
+    void addTax(const TaxRate i_TaxRate, const Money i_Taxable);
+
+    ///@brief Writes the separator and the total row
+    void addTotal(const Money i_Total);
+
+private:
+    ///@brief Helper function to write a row with a label on the left and (unless
+    /// i_HasAmount is false) an amount on the right
+    void writeRow(std::string_view i_Label, const Money i_Amount, const bool i_HasAmount = true);
+
+    ReceiptSink &m_Sink;
+};
@@ -0,0 +1,150 @@
+// Local
+#include <MappedFile.hpp>
+#include <PricingTable.hpp>
+// Standard Library
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#pragma once
+
+///@brief Write-ahead journal of the scans of one lane, so that the cart of a lane whose
+///       process dies can be rebuilt (see Checkout::recover).
+///
+///       The journal is a preallocated file mapped into memory: a header followed by
+///       fixed-size records, one per scan. Appending a record is a few stores into the
+///       mapping (no system call), and since the pages belong to the file they survive a
+///       crash of the process. Getting them to the disk (to survive a crash of the host)
+///       is group committed: a background thread syncs everything appended so far every
+///       commit interval, and commit() waits for the next sync.
+///
+///       Each transaction (customer) starts over at the first record. A record holds the
+///       number of its transaction and a checksum, so recovery reads the records of the
+///       current transaction up to the first one that is stale or was torn by a crash.
+///@remarks Records hold item indices, not IDs: the cart must be recovered against a table
+/// compiled from the same PricingScheme (or a catalog file written from it).
+class ScanJournal
+{
+
+public:
+    ///@brief What a record adds to a line of the cart
+    enum class Kind : std::uint16_t
+    {
+        UNITS = 1,
+        GRAMS = 2
+    };
+
+    ///@brief One scan of the journal
+    struct Entry
+    {
+        PricingTable::Index index;
+        Kind kind;
+        /// # of units or grams
+        std::int32_t amount;
+    };
+
+    static constexpr std::uint32_t FORMAT_VERSION = 1;
+    static constexpr std::size_t HEADER_SIZE = 64;
+    static constexpr std::size_t RECORD_SIZE = 16;
+
+    ///@brief Opens (or creates) the journal file and reads the transaction that was open
+    ///@param i_Capacity # of records the file has room for. A transaction with more scans
+    ///       is compacted to one record per line by the checkout.
+    ///@param i_CommitInterval Time between syncs of the background thread
+    ///       (0 == no thread, every commit() syncs)
+    ///@throws std::runtime_error if the file can't be mapped or is from another format, or
+    ///        if it exists and isn't a journal (it is left untouched)
+    explicit ScanJournal(const std::string &i_Path,
+                         const std::size_t i_Capacity = 65536,
+                         const std::chrono::milliseconds i_CommitInterval = std::chrono::milliseconds(2));
+    ///@remarks Syncs the records appended since the last sync
+    virtual ~ScanJournal();
+
+    ScanJournal(const ScanJournal &) = delete;
+    ScanJournal &operator=(const ScanJournal &) = delete;
+
+    ///@brief Scans of the transaction that was open when the journal was opened
+    const std::vector<Entry> &getRecovered() const
+    {
+        return m_Recovered;
+    }
+
+    ///@brief Starts a new, empty transaction (the previous one can no longer be recovered)
+    void begin();
+
+    ///@brief Adds a scan to the open transaction
+    ///@return false if the journal is full (nothing was added)
+    ///@remarks Makes no system call and doesn't allocate
+    bool append(const PricingTable::Index i_Index, const Kind i_Kind, const std::int32_t i_Amount)
+    {
+        const std::size_t position = m_Position.load(std::memory_order_relaxed);
+        if (position == m_Capacity)
+        {
+            return false;
+        }
+        writeRecord(position, Entry{i_Index, i_Kind, i_Amount});
+        m_Position.store(position + 1, std::memory_order_release);
+        m_NumberOfAppended.store(m_NumberOfAppended.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        return true;
+    }
+
+    ///@brief Waits until every record appended so far is on the disk
+    ///@throws std::runtime_error if the file couldn't be synced
+    void commit();
+
+    std::size_t getCapacity() const
+    {
+        return m_Capacity;
+    }
+    ///@brief # of records in the open transaction
+    std::size_t size() const
+    {
+        return m_Position.load(std::memory_order_relaxed);
+    }
+    ///@brief # of times the file was synced (each sync commits every record appended before it)
+    std::uint64_t getNumberOfSyncs() const
+    {
+        return m_NumberOfSyncs.load(std::memory_order_relaxed);
+    }
+
+private:
+    ///@brief Stores a record at the given position of the open transaction
+    void writeRecord(const std::size_t i_Position, const Entry &i_Entry);
+    ///@brief Reads the record at the given position
+    ///@return false if it isn't a valid record of the open transaction
+    bool readRecord(const std::size_t i_Position, Entry &o_Entry) const;
+
+    ///@brief Syncs the header and the records of the open transaction
+    ///@return # of records appended up to the sync
+    std::uint64_t sync();
+    ///@brief Loop of the background thread
+    void commitLoop();
+
+    MappedFile m_File;
+    unsigned char *m_Records;
+    std::size_t m_Capacity;
+    /// Number of the open transaction (also stored in the header)
+    std::uint32_t m_Transaction;
+    /// # of records in the open transaction
+    std::atomic<std::size_t> m_Position;
+    /// # of records appended since the journal was opened
+    std::atomic<std::uint64_t> m_NumberOfAppended;
+    std::atomic<std::uint64_t> m_NumberOfSyncs;
+    std::vector<Entry> m_Recovered;
+
+    /// Group commit: guards m_NumberOfDurable, m_IsCommitRequested, m_IsStopping and m_IsFailed
+    const std::chrono::milliseconds m_CommitInterval;
+    std::mutex m_Mutex;
+    std::condition_variable m_Wakeup;
+    std::condition_variable m_Committed;
+    std::uint64_t m_NumberOfDurable;
+    bool m_IsCommitRequested;
+    bool m_IsStopping;
+    bool m_IsFailed;
+    std::thread m_Thread;
+};
@@ -0,0 +1,77 @@
+// Local
+#include <Checkout.hpp>
+#include <PricingTable.hpp>
+// Standard Library
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+#pragma once
+
+///@brief Streams append-only scanner logs into carts, e.g., for end-of-day reconciliation.
+///       The log is read in large chunks and parsed in place into std::string_view
+///       tokens, so scan events aren't copied into strings. Memory use is bounded by the
+///       chunk size plus one open cart per lane, whatever the size of the log.
+///
+/// Log format, one scan event per line:
+///     lane,transaction,sku,quantity,timestamp
+/// e.g., "03,000912,1983,1,1700000000123", with the timestamp in milliseconds since the
+/// epoch. Carts are priced with the deals scheduled for the time of their scans (see
+/// Checkout::setTime). Events of one transaction are consecutive
+/// for its lane, but lanes can be interleaved. A transaction ends when its lane starts
+/// another transaction or at the end of the log.
+class ScanLogReader
+{
+
+public:
+    ///@brief Called once per transaction, after its last scan event has been read
+    ///@remarks The views are only valid during the call
+    using CartHandler = std::function<void(std::string_view i_Lane, std::string_view i_Transaction, Checkout &io_Checkout)>;
+
+    ///@brief Counts of what was read from a log
+    struct Statistics
+    {
+        std::size_t numberOfEvents;
+        std::size_t numberOfCarts;
+        /// Lines that couldn't be parsed, they are skipped
+        std::size_t numberOfMalformedLines;
+    };
+
+    ///@param i_ChunkSize Size of the read buffer. Lines longer than this are malformed.
+    ScanLogReader(std::shared_ptr<const PricingTable> i_PricingTable, const std::size_t i_ChunkSize = 1 << 20);
+    virtual ~ScanLogReader();
+
+    ///@brief Reads a whole log file and passes every transaction to i_Handler
+    ///@throws std::runtime_error if the file can't be read
+    Statistics read(const std::string &i_Path, const CartHandler &i_Handler);
+
+private:
+    ///@brief Transaction in progress on a lane
+    struct OpenCart
+    {
+        /// Copy of the transaction ID, since the read buffer gets reused
+        std::string transaction;
+        /// Lane-local pool for the cart, so a lane's transactions reuse the same nodes
+        std::unique_ptr<std::pmr::unsynchronized_pool_resource> memory;
+        /// Reset and reused for every transaction of the lane
+        std::unique_ptr<Checkout> checkout;
+        bool isOpen;
+    };
+
+    ///@brief Helper function to parse one line and add its scan to the lane's cart
+    ///@return false if the line is malformed
+    bool processLine(std::string_view i_Line, const CartHandler &i_Handler, Statistics &io_Statistics);
+
+    /// Compiled Pricing Scheme used for every cart
+    std::shared_ptr<const PricingTable> m_PricingTable;
+
+    std::vector<char> m_Buffer;
+
+    /// Open transactions (key=lane). std::less<> allows lookups by std::string_view.
+    std::map<std::string, OpenCart, std::less<>> m_OpenCarts;
+};
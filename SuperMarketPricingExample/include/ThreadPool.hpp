@@ -0,0 +1,80 @@
+// Standard Library
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#pragma once
+
+///@brief Fixed-size pool of worker threads for data-parallel loops.
+///       Each worker starts on its own contiguous slice of the index range and, once that
+///       is done, steals chunks from the slices of the other workers, so uneven work
+///       (e.g., a few huge carts) doesn't leave threads idle.
+class ThreadPool
+{
+
+public:
+    ///@brief Task run on a chunk [i_Begin, i_End) of the index range by worker i_Worker
+    ///@remarks i_Worker is in [0, size()), so callers can keep per-worker scratch data
+    using Task = std::function<void(std::size_t i_Begin, std::size_t i_End, unsigned i_Worker)>;
+
+    ///@param i_NumberOfThreads Total # of threads including the calling thread
+    ///       (0 == one per hardware thread)
+    explicit ThreadPool(const unsigned i_NumberOfThreads = 0);
+    virtual ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    ///@brief # of workers, including the thread calling parallelFor()
+    unsigned size() const
+    {
+        return m_NumberOfWorkers;
+    }
+
+    ///@brief Runs i_Task over the index range [0, i_Count) in chunks of i_ChunkSize
+    ///@post Returns once every index has been processed
+    ///@remarks If a task throws, the remaining chunks are skipped and the first exception
+    /// is rethrown here. Calls from different threads are serialized.
+    void parallelFor(const std::size_t i_Count, const std::size_t i_ChunkSize, const Task &i_Task);
+
+private:
+    ///@brief Part of the index range owned by one worker
+    struct alignas(64) Slice
+    {
+        std::atomic<std::size_t> next;
+        std::size_t end;
+    };
+
+    ///@brief Loop run by each pool thread
+    void workerLoop(const unsigned i_Worker);
+    ///@brief Processes the worker's own slice and then steals from the others
+    void runSlices(const unsigned i_Worker);
+
+    const unsigned m_NumberOfWorkers;
+    std::vector<std::thread> m_Threads;
+    std::unique_ptr<Slice[]> m_Slices;
+
+    /// Serializes calls to parallelFor()
+    std::mutex m_CallMutex;
+
+    /// Guards the fields below
+    std::mutex m_Mutex;
+    std::condition_variable m_WorkReady;
+    std::condition_variable m_WorkDone;
+    /// Incremented for every parallelFor() so workers know there is new work
+    std::size_t m_Generation;
+    /// # of pool threads still working on the current parallelFor()
+    unsigned m_NumberRunning;
+    bool m_Stop;
+    std::exception_ptr m_Exception;
+
+    /// Current loop, only valid during parallelFor()
+    const Task *m_Task;
+    std::size_t m_ChunkSize;
+    std::atomic<bool> m_Failed;
+};
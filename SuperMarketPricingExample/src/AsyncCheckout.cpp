@@ -0,0 +1,307 @@
+// Local
+#include "AsyncCheckout.hpp"
+// Standard Library
+#include <stdexcept>
+#include <variant>
+
+CheckoutTask::CheckoutTask(Handle i_Handle)
+    : m_Handle(i_Handle)
+{
+}
+
+CheckoutTask::CheckoutTask(CheckoutTask &&io_Task) noexcept
+    : m_Handle(io_Task.m_Handle)
+{
+    io_Task.m_Handle = nullptr;
+}
+
+CheckoutTask::~CheckoutTask()
+{
+    if (m_Handle)
+    {
+        m_Handle.destroy();
+    }
+}
+
+AsyncCheckoutLoop::AsyncCheckoutLoop(CatalogBackend &io_Backend, const std::size_t i_MaxBatchSize)
+    : m_Backend(io_Backend),
+      m_MaxBatchSize(0 == i_MaxBatchSize ? 1 : i_MaxBatchSize),
+      m_Cache(),
+      m_Table(std::make_shared<const PricingTable>(m_Cache.compile())),
+      m_NumberOfTasks(0),
+      m_NumberOfBatches(0),
+      m_NumberInFlight(0)
+{
+}
+
+AsyncCheckoutLoop::~AsyncCheckoutLoop()
+{
+    {
+        /// The backend's callbacks refer to this loop
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Completed.wait(lock, [&] { return 0 == m_NumberInFlight; });
+    }
+    /// Every unfinished task is either ready or waiting for exactly one ID
+    for (const auto handle : m_Ready)
+    {
+        handle.destroy();
+    }
+    for (const auto &waiters : m_Waiters)
+    {
+        for (const auto handle : waiters.second)
+        {
+            handle.destroy();
+        }
+    }
+}
+
+void AsyncCheckoutLoop::spawn(CheckoutTask i_Task)
+{
+    if (!i_Task.m_Handle)
+    {
+        return;
+    }
+    m_Ready.push_back(i_Task.m_Handle);
+    i_Task.m_Handle = nullptr;
+    ++m_NumberOfTasks;
+}
+
+void AsyncCheckoutLoop::run()
+{
+    while (0 != m_NumberOfTasks)
+    {
+        while (!m_Ready.empty())
+        {
+            const CheckoutTask::Handle handle = m_Ready.front();
+            m_Ready.pop_front();
+            handle.resume();
+            if (handle.done())
+            {
+                finish(handle);
+            }
+            if (m_Pending.size() >= m_MaxBatchSize)
+            {
+                flush();
+            }
+        }
+        if (0 == m_NumberOfTasks)
+        {
+            break;
+        }
+        if (!m_Pending.empty())
+        {
+            flush();
+        }
+
+        std::vector<Completion> completions;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Completed.wait(lock, [&] { return !m_Completions.empty() || 0 == m_NumberInFlight; });
+            completions.swap(m_Completions);
+        }
+        if (completions.empty())
+        {
+            throw std::runtime_error("Checkout tasks are suspended on something other than a scan of this loop");
+        }
+        for (auto &completion : completions)
+        {
+            complete(completion);
+        }
+    }
+}
+
+void AsyncCheckoutLoop::refresh(Checkout &io_Checkout) const
+{
+    if (io_Checkout.getVersion() == m_Table->getVersion())
+    {
+        return;
+    }
+    std::vector<PricingTable::Index> changed;
+    if (m_Cache.getChangesSince(io_Checkout.getVersion(), changed))
+    {
+        io_Checkout.update(m_Table, changed);
+    }
+    else
+    {
+        io_Checkout.update(m_Table);
+    }
+}
+
+bool AsyncCheckoutLoop::isResolved(const std::string &i_ID) const
+{
+    return PricingTable::NO_INDEX != m_Table->find(i_ID) || 0 != m_Unknown.count(i_ID);
+}
+
+void AsyncCheckoutLoop::await(const std::string &i_ID, CheckoutTask::Handle i_Handle)
+{
+    auto waiters = m_Waiters.find(i_ID);
+    if (m_Waiters.end() == waiters)
+    {
+        waiters = m_Waiters.emplace(i_ID, std::vector<CheckoutTask::Handle>()).first;
+        m_Pending.push_back(i_ID);
+    }
+    waiters->second.push_back(i_Handle);
+}
+
+void AsyncCheckoutLoop::flush()
+{
+    std::vector<std::string> ids;
+    ids.swap(m_Pending);
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        ++m_NumberInFlight;
+    }
+    ++m_NumberOfBatches;
+
+    /// The callback may run before fetch() returns, on this thread or another one
+    m_Backend.fetch(ids, [this, ids](std::vector<std::optional<Item>> i_Items, std::vector<std::pair<TaxClass, TaxRate>> i_TaxRates) {
+        /// Notified under the lock: once the count is 0 the loop may be destroyed, so the
+        /// condition variable can't be touched after the lock is released
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Completions.push_back({ids, std::move(i_Items), std::move(i_TaxRates)});
+        --m_NumberInFlight;
+        m_Completed.notify_all();
+    });
+}
+
+void AsyncCheckoutLoop::complete(Completion &io_Completion)
+{
+    PricingScheme::Delta delta;
+    delta.taxRates = io_Completion.taxRates;
+    std::set<std::string> fetched;
+    for (std::size_t i = 0; i < io_Completion.ids.size(); ++i)
+    {
+        if (i < io_Completion.items.size() && io_Completion.items[i])
+        {
+            fetched.insert(io_Completion.items[i]->getId());
+            delta.items.push_back(*io_Completion.items[i]);
+        }
+        else
+        {
+            m_Unknown.insert(io_Completion.ids[i]);
+        }
+    }
+
+    /// A bundle is priced from its partner's index, which only exists once the partner is
+    /// cached: items whose partner just arrived are compiled again, so that the carts
+    /// holding them are repriced (see refresh)
+    std::vector<Item> referencing;
+    for (const Item &item : delta.items)
+    {
+        const auto references = m_BundleReferences.equal_range(item.getId());
+        for (auto it = references.first; references.second != it; ++it)
+        {
+            if (0 == fetched.count(it->second))
+            {
+                referencing.push_back(m_Cache.getItemMap().at(it->second));
+            }
+        }
+        m_BundleReferences.erase(references.first, references.second);
+
+        if (const auto *bundle = std::get_if<Bundle>(&item.getPromotion()))
+        {
+            if (0 == m_Cache.getItemMap().count(bundle->partnerId) && 0 == fetched.count(bundle->partnerId))
+            {
+                m_BundleReferences.emplace(bundle->partnerId, item.getId());
+            }
+        }
+    }
+    delta.items.insert(delta.items.end(), referencing.begin(), referencing.end());
+
+    m_Cache.applyDelta(delta);
+    m_Table = std::make_shared<const PricingTable>(m_Cache.compile());
+
+    for (const auto &id : io_Completion.ids)
+    {
+        const auto waiters = m_Waiters.find(id);
+        if (m_Waiters.end() == waiters)
+        {
+            continue;
+        }
+        m_Ready.insert(m_Ready.end(), waiters->second.begin(), waiters->second.end());
+        m_Waiters.erase(waiters);
+    }
+}
+
+void AsyncCheckoutLoop::finish(CheckoutTask::Handle i_Handle)
+{
+    const std::exception_ptr exception = i_Handle.promise().exception;
+    i_Handle.destroy();
+    --m_NumberOfTasks;
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+}
+
+AsyncCheckout::ScanAwaiter::ScanAwaiter(AsyncCheckout &io_Checkout, std::string i_ID, const int i_Quantity, const int i_Grams)
+    : m_Checkout(io_Checkout),
+      m_ID(std::move(i_ID)),
+      m_Quantity(i_Quantity),
+      m_Grams(i_Grams),
+      m_IsApplied(false)
+{
+}
+
+bool AsyncCheckout::ScanAwaiter::await_ready()
+{
+    if (!m_Checkout.m_Loop.isResolved(m_ID))
+    {
+        return false;
+    }
+    apply();
+    return true;
+}
+
+void AsyncCheckout::ScanAwaiter::await_suspend(CheckoutTask::Handle i_Handle)
+{
+    m_Checkout.m_Loop.await(m_ID, i_Handle);
+}
+
+void AsyncCheckout::ScanAwaiter::await_resume()
+{
+    if (!m_IsApplied)
+    {
+        apply();
+    }
+}
+
+void AsyncCheckout::ScanAwaiter::apply()
+{
+    m_Checkout.m_Loop.refresh(m_Checkout.m_Checkout);
+    if (0 != m_Quantity)
+    {
+        m_Checkout.m_Checkout.scan(m_ID, m_Quantity);
+    }
+    else
+    {
+        m_Checkout.m_Checkout.scanWeight(m_ID, m_Grams);
+    }
+    m_IsApplied = true;
+}
+
+AsyncCheckout::AsyncCheckout(AsyncCheckoutLoop &io_Loop)
+    : m_Loop(io_Loop),
+      m_Checkout(io_Loop.snapshot())
+{
+}
+
+AsyncCheckout::~AsyncCheckout()
+{
+}
+
+AsyncCheckout::ScanAwaiter AsyncCheckout::scan(std::string i_ID, const int i_Quantity)
+{
+    return ScanAwaiter(*this, std::move(i_ID), i_Quantity, 0);
+}
+
+AsyncCheckout::ScanAwaiter AsyncCheckout::scanWeight(std::string i_ID, const int i_Grams)
+{
+    return ScanAwaiter(*this, std::move(i_ID), 0, i_Grams);
+}
+
+int AsyncCheckout::getTotal()
+{
+    m_Loop.refresh(m_Checkout);
+    return m_Checkout.getTotal();
+}
@@ -0,0 +1,70 @@
+// Local
+#include "Barcode.hpp"
+
+Barcode::Barcode(const bool i_IsValid, const std::uint64_t i_ItemKey, const Embedded i_Embedded, const int i_Value)
+    : m_IsValid(i_IsValid),
+      m_ItemKey(i_ItemKey),
+      m_Embedded(i_Embedded),
+      m_Value(i_Value)
+{
+}
+
+char Barcode::computeCheckDigit(std::string_view i_Digits)
+{
+    int sum = 0;
+    int weight = 3;
+    for (auto digit = i_Digits.rbegin(); i_Digits.rend() != digit; ++digit, weight = 4 - weight)
+    {
+        sum += (*digit - '0') * weight;
+    }
+    return static_cast<char>('0' + (10 - sum % 10) % 10);
+}
+
+bool Barcode::toKey(std::string_view i_ID, std::uint64_t &o_Key)
+{
+    const std::size_t length = i_ID.size();
+    if (8 != length && 12 != length && 13 != length && 14 != length)
+    {
+        return false;
+    }
+    o_Key = 0;
+    for (const char c : i_ID)
+    {
+        if (c < '0' || c > '9')
+        {
+            return false;
+        }
+        o_Key = o_Key * 10 + static_cast<std::uint64_t>(c - '0');
+    }
+    return true;
+}
+
+Barcode Barcode::parse(std::string_view i_Digits, const PrefixRules &i_Rules)
+{
+    std::uint64_t key = 0;
+    if (!toKey(i_Digits, key) || computeCheckDigit(i_Digits.substr(0, i_Digits.size() - 1)) != i_Digits.back())
+    {
+        return Barcode(false, 0, Embedded::NONE, 0);
+    }
+    /// Restricted circulation numbers are EAN-13 (or the same code as GTIN-14 with a 0)
+    if (14 == i_Digits.size() && '0' == i_Digits[0])
+    {
+        i_Digits.remove_prefix(1);
+    }
+    if (13 != i_Digits.size() || '2' != i_Digits[0])
+    {
+        return Barcode(true, key, Embedded::NONE, 0);
+    }
+    const Embedded embedded = i_Rules[i_Digits[1] - '0'];
+    if (Embedded::NONE == embedded)
+    {
+        return Barcode(true, key, Embedded::NONE, 0);
+    }
+    int value = 0;
+    for (const char c : i_Digits.substr(7, 5))
+    {
+        value = value * 10 + (c - '0');
+    }
+    /// 2PIIIIIVVVVVC -> 2PIIIII000000
+    return Barcode(true, key / 1000000 * 1000000, embedded, value);
+}
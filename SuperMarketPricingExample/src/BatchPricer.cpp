@@ -0,0 +1,267 @@
+// Local
+#include "BatchPricer.hpp"
+#include "LineKernel.hpp"
+// Standard Library
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    /// # of carts a worker claims at a time. Small enough to balance uneven carts,
+    /// big enough to keep the work-stealing counters cold.
+    const std::size_t CARTS_PER_CHUNK = 256;
+} // namespace
+
+BatchPricer::BatchPricer(std::shared_ptr<const PricingTable> i_PricingTable, const unsigned i_NumberOfThreads)
+    : m_PricingTable(std::move(i_PricingTable)),
+      m_Time(PromotionWindow::getCurrentTime()),
+      m_ThreadPool(i_NumberOfThreads),
+      m_Scratch(m_ThreadPool.size())
+{
+}
+
+BatchPricer::~BatchPricer()
+{
+}
+
+std::vector<Money> BatchPricer::priceAll(const std::vector<Cart> &i_Carts)
+{
+    std::vector<Money> totals(i_Carts.size());
+    m_ThreadPool.parallelFor(
+        i_Carts.size(),
+        CARTS_PER_CHUNK,
+        [&](std::size_t i_Begin, std::size_t i_End, unsigned i_Worker) {
+            priceChunk(&i_Carts[i_Begin], i_End - i_Begin, &totals[i_Begin], m_Scratch[i_Worker]);
+        });
+    return totals;
+}
+
+void BatchPricer::analyzeAll(const std::vector<Cart> &i_Carts, PromotionReport &io_Report)
+{
+    const std::size_t numberOfItems = m_PricingTable->size();
+    if (io_Report.items.empty())
+    {
+        io_Report.items.resize(numberOfItems);
+    }
+    if (io_Report.items.size() != numberOfItems)
+    {
+        throw std::runtime_error("Promotion report was filled from another pricing table");
+    }
+
+    /// Only the items a worker touched in the last batch have to be zeroed
+    for (auto &scratch : m_Scratch)
+    {
+        for (const PricingTable::Index item : scratch.touchedItems)
+        {
+            scratch.itemSummaries[item] = DealSummary();
+        }
+        scratch.touchedItems.clear();
+        scratch.promotionSummaries.fill(DealSummary());
+        scratch.numberOfCarts = 0;
+    }
+    m_ThreadPool.parallelFor(
+        i_Carts.size(),
+        CARTS_PER_CHUNK,
+        [&](std::size_t i_Begin, std::size_t i_End, unsigned i_Worker) {
+            analyzeChunk(&i_Carts[i_Begin], i_End - i_Begin, m_Scratch[i_Worker]);
+        });
+
+    /// Merge the workers' accumulators, only the items each of them touched
+    for (const auto &scratch : m_Scratch)
+    {
+        io_Report.numberOfCarts += scratch.numberOfCarts;
+        for (std::size_t promotion = 0; promotion < io_Report.promotions.size(); ++promotion)
+        {
+            io_Report.promotions[promotion] += scratch.promotionSummaries[promotion];
+        }
+        for (const PricingTable::Index item : scratch.touchedItems)
+        {
+            io_Report.items[item] += scratch.itemSummaries[item];
+        }
+    }
+}
+
+Money BatchPricer::priceCart(const Cart &i_Cart) const
+{
+    Scratch scratch;
+    Money total;
+    priceChunk(&i_Cart, 1, &total, scratch);
+    return total;
+}
+
+void BatchPricer::priceChunk(const Cart *i_Carts, const std::size_t i_NumberOfCarts, Money *o_Totals, Scratch &io_Scratch) const
+{
+    const PricingTable &table = *m_PricingTable;
+    io_Scratch.taxableAmount.clear();
+    io_Scratch.taxRate.clear();
+    io_Scratch.taxQuantity.clear();
+    io_Scratch.taxCart.clear();
+
+    for (std::size_t cart = 0; cart < i_NumberOfCarts; ++cart)
+    {
+        collectLines(i_Carts[cart], io_Scratch);
+
+        Money total;
+        PricingTable::TaxableAmounts taxable = {};
+        for (const auto &line : io_Scratch.lines)
+        {
+            /// Lines that are priced as SimplePrice are just the unit price * quantity
+            const PricingTable::Index deal = table.findDeal(line.first, m_Time);
+            int numberOfPartner = 0;
+            const bool isSimple = isSimpleLine(line.first, deal, io_Scratch, numberOfPartner);
+
+            Money &classTaxable = taxable[table.getTaxClass(line.first).getId()];
+            if (isSimple)
+            {
+                const Money cost = table.getUnitPrice(line.first) * line.second;
+                total += cost;
+                classTaxable += cost;
+            }
+            else
+            {
+                const PricingTable::LineDetails details = table.describeLine(line.first, deal, line.second, 0, numberOfPartner);
+                total += details.total;
+                classTaxable += details.taxableCost;
+            }
+        }
+
+        /// Tax is added below, once per class
+        for (std::size_t taxClass = 0; taxClass < TaxClass::COUNT; ++taxClass)
+        {
+            if (Money(0) == taxable[taxClass])
+            {
+                continue;
+            }
+            const TaxRate rate = table.getTaxRate(TaxClass(static_cast<std::uint8_t>(taxClass)));
+            if (LineKernel::fits(taxable[taxClass].getCents(), 1, rate.getBasisPoints()))
+            {
+                io_Scratch.taxableAmount.push_back(static_cast<std::int32_t>(taxable[taxClass].getCents()));
+                io_Scratch.taxRate.push_back(rate.getBasisPoints());
+                io_Scratch.taxQuantity.push_back(1);
+                io_Scratch.taxCart.push_back(cart);
+            }
+            else
+            {
+                total += rate.taxOn(taxable[taxClass]);
+            }
+        }
+        o_Totals[cart] = total;
+    }
+
+    /// Tax the classes of the whole chunk in one pass
+    const std::size_t numberOfAmounts = io_Scratch.taxCart.size();
+    io_Scratch.taxedAmount.resize(numberOfAmounts);
+    LineKernel::priceLines(
+        io_Scratch.taxableAmount.data(),
+        io_Scratch.taxRate.data(),
+        io_Scratch.taxQuantity.data(),
+        numberOfAmounts,
+        io_Scratch.taxedAmount.data());
+    for (std::size_t amount = 0; amount < numberOfAmounts; ++amount)
+    {
+        o_Totals[io_Scratch.taxCart[amount]] += Money(io_Scratch.taxedAmount[amount] - io_Scratch.taxableAmount[amount]);
+    }
+}
+
+void BatchPricer::analyzeChunk(const Cart *i_Carts, const std::size_t i_NumberOfCarts, Scratch &io_Scratch) const
+{
+    const PricingTable &table = *m_PricingTable;
+    /// Allocated by the first chunk a worker analyzes, then kept zeroed between batches
+    if (io_Scratch.itemSummaries.size() != table.size())
+    {
+        io_Scratch.itemSummaries.assign(table.size(), DealSummary());
+    }
+    for (std::size_t cart = 0; cart < i_NumberOfCarts; ++cart)
+    {
+        collectLines(i_Carts[cart], io_Scratch);
+        for (const auto &line : io_Scratch.lines)
+        {
+            DealSummary outcome;
+            outcome.numberOfLines = 1;
+            outcome.numberOfUnits = static_cast<std::uint64_t>(line.second);
+
+            const PricingTable::Index deal = table.findDeal(line.first, m_Time);
+            int numberOfPartner = 0;
+            if (isSimpleLine(line.first, deal, io_Scratch, numberOfPartner))
+            {
+                outcome.revenue = (table.getUnitPrice(line.first) * line.second).getCents();
+            }
+            else
+            {
+                const PricingTable::LineDetails details = table.describeLine(line.first, deal, line.second, 0, numberOfPartner);
+                outcome.numberOfFreeUnits = static_cast<std::uint64_t>(details.numberOfFreeUnits);
+                outcome.numberOfBundles = static_cast<std::uint64_t>(details.numberOfBundles);
+                outcome.freeSavings = details.freeSavings.getCents();
+                outcome.bundleSavings = details.bundleSavings.getCents();
+                outcome.revenue = details.total.getCents();
+            }
+            DealSummary &itemSummary = io_Scratch.itemSummaries[line.first];
+            if (0 == itemSummary.numberOfLines)
+            {
+                io_Scratch.touchedItems.push_back(line.first);
+            }
+            itemSummary += outcome;
+
+            /// Both lines of a bundle report it, the one it is charged to counts it
+            if (0 != outcome.numberOfBundles && line.first > table.getBundlePartner(deal))
+            {
+                outcome.numberOfBundles = 0;
+            }
+            io_Scratch.promotionSummaries[static_cast<std::size_t>(table.getPromotionKind(deal))] += outcome;
+        }
+    }
+    io_Scratch.numberOfCarts += i_NumberOfCarts;
+}
+
+void BatchPricer::collectLines(const Cart &i_Cart, Scratch &io_Scratch) const
+{
+    const PricingTable &table = *m_PricingTable;
+
+    /// Resolve and sort the scans so every item's units end up next to each other
+    io_Scratch.scans.clear();
+    for (const auto &id : i_Cart)
+    {
+        const PricingTable::Index index = table.find(id);
+        if (PricingTable::NO_INDEX != index)
+        {
+            io_Scratch.scans.push_back(index);
+        }
+    }
+    std::sort(io_Scratch.scans.begin(), io_Scratch.scans.end());
+
+    io_Scratch.lines.clear();
+    for (const PricingTable::Index index : io_Scratch.scans)
+    {
+        if (io_Scratch.lines.empty() || io_Scratch.lines.back().first != index)
+        {
+            io_Scratch.lines.emplace_back(index, 0);
+        }
+        ++io_Scratch.lines.back().second;
+    }
+}
+
+bool BatchPricer::isSimpleLine(
+    const PricingTable::Index i_Index,
+    const PricingTable::Index i_Deal,
+    const Scratch &i_Scratch,
+    int &o_NumberOfPartner) const
+{
+    o_NumberOfPartner = 0;
+    return m_PricingTable->visitPromotion(
+        i_Deal,
+        Overloaded{
+            [](const SimplePrice &) { return true; },
+            [](const BuyXGetY &) { return false; },
+            [&](const PricingTable::BundleDeal &) {
+                const PricingTable::Index partner = m_PricingTable->findBundlePartner(i_Index, i_Deal, m_Time);
+                const auto it = std::lower_bound(
+                    i_Scratch.lines.begin(),
+                    i_Scratch.lines.end(),
+                    std::make_pair(partner, 0));
+                if (i_Scratch.lines.end() != it && it->first == partner)
+                {
+                    o_NumberOfPartner = it->second;
+                }
+                return 0 == o_NumberOfPartner;
+            }});
+}
@@ -0,0 +1,33 @@
+// Local
+#include "Catalog.hpp"
+// Standard Library
+#include <utility>
+
+Catalog::Catalog()
+    : m_Current(std::make_shared<const PricingTable>())
+{
+}
+
+Catalog::Catalog(const PricingScheme &i_PricingScheme)
+    : m_Current(std::make_shared<const PricingTable>(i_PricingScheme.compile()))
+{
+}
+
+Catalog::~Catalog()
+{
+}
+
+void Catalog::publish(const PricingScheme &i_PricingScheme)
+{
+    publish(std::make_shared<const PricingTable>(i_PricingScheme.compile()));
+}
+
+void Catalog::publish(std::shared_ptr<const PricingTable> i_PricingTable)
+{
+    m_Current.store(std::move(i_PricingTable));
+}
+
+std::shared_ptr<const PricingTable> Catalog::snapshot() const
+{
+    return m_Current.load();
+}
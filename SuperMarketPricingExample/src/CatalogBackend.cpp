@@ -0,0 +1,94 @@
+// Local
+#include "CatalogBackend.hpp"
+// Standard Library
+#include <cstdint>
+#include <set>
+#include <utility>
+
+CatalogBackend::~CatalogBackend()
+{
+}
+
+FakeCatalogBackend::FakeCatalogBackend(const PricingScheme &i_PricingScheme, const std::chrono::microseconds i_Latency)
+    : m_Items(i_PricingScheme.getItemMap()),
+      m_Latency(i_Latency),
+      m_TaxRates(),
+      m_NumberOfRequests(0),
+      m_NumberOfIdsRequested(0),
+      m_Requests(),
+      m_Stop(false),
+      m_Thread()
+{
+    for (std::uint8_t taxClass = 0; taxClass < TaxClass::COUNT; ++taxClass)
+    {
+        m_TaxRates[taxClass] = i_PricingScheme.getTaxRate(TaxClass(taxClass));
+    }
+    m_Thread = std::thread(&FakeCatalogBackend::serve, this);
+}
+
+FakeCatalogBackend::~FakeCatalogBackend()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_RequestReady.notify_all();
+    m_Thread.join();
+}
+
+void FakeCatalogBackend::fetch(std::vector<std::string> i_IDs, Callback i_Done)
+{
+    ++m_NumberOfRequests;
+    m_NumberOfIdsRequested += i_IDs.size();
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Requests.push_back({std::chrono::steady_clock::now() + m_Latency, std::move(i_IDs), std::move(i_Done)});
+    }
+    m_RequestReady.notify_all();
+}
+
+void FakeCatalogBackend::serve()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    for (;;)
+    {
+        m_RequestReady.wait(lock, [&] { return m_Stop || !m_Requests.empty(); });
+        if (m_Requests.empty())
+        {
+            return;
+        }
+        /// Requests still in progress when the backend is destroyed are answered early
+        if (!m_Stop && std::chrono::steady_clock::now() < m_Requests.front().due)
+        {
+            /// A copy: the wait reads it again after fetch() may have grown m_Requests
+            const std::chrono::steady_clock::time_point due = m_Requests.front().due;
+            m_RequestReady.wait_until(lock, due);
+            continue;
+        }
+        Request request = std::move(m_Requests.front());
+        m_Requests.erase(m_Requests.begin());
+
+        lock.unlock();
+        std::vector<std::optional<Item>> items;
+        items.reserve(request.ids.size());
+        std::set<std::uint8_t> taxClasses;
+        for (const auto &id : request.ids)
+        {
+            const auto it = m_Items.find(id);
+            if (m_Items.end() == it)
+            {
+                items.push_back(std::nullopt);
+                continue;
+            }
+            items.push_back(it->second);
+            taxClasses.insert(it->second.getTaxClass().getId());
+        }
+        std::vector<std::pair<TaxClass, TaxRate>> taxRates;
+        for (const auto taxClass : taxClasses)
+        {
+            taxRates.emplace_back(TaxClass(taxClass), m_TaxRates[taxClass]);
+        }
+        request.done(std::move(items), std::move(taxRates));
+        lock.lock();
+    }
+}
@@ -0,0 +1,75 @@
+// Local
+#include "CatalogFile.hpp"
+#include "MappedFile.hpp"
+// Platform Specific
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+// Standard Library
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+    ///@brief Waits until a closed file's contents are stored on the disk
+    ///@throws std::runtime_error if they can't be
+    void syncFile(const std::string &i_Path)
+    {
+#ifdef _WIN32
+        const HANDLE file = CreateFileA(i_Path.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        const bool isSynced = INVALID_HANDLE_VALUE != file && FlushFileBuffers(file);
+        if (INVALID_HANDLE_VALUE != file)
+        {
+            CloseHandle(file);
+        }
+#else
+        const int file = open(i_Path.c_str(), O_RDWR);
+        const bool isSynced = file >= 0 && 0 == fsync(file);
+        if (file >= 0)
+        {
+            close(file);
+        }
+#endif
+        if (!isSynced)
+        {
+            throw std::runtime_error("Can't write " + i_Path + " to the disk");
+        }
+    }
+} // namespace
+
+void CatalogFile::write(const PricingTable &i_PricingTable, const std::string &i_Path)
+{
+    const std::string temporaryPath = i_Path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(static_cast<const char *>(i_PricingTable.getImage()), i_PricingTable.getImageSize());
+        /// Buffered data is only written (and a full disk only noticed) on close
+        file.close();
+        if (!file)
+        {
+            throw std::runtime_error("Can't write " + temporaryPath);
+        }
+    }
+    /// Otherwise a crash shortly after the rename can leave i_Path empty or partly written
+    syncFile(temporaryPath);
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, i_Path, error);
+    if (error)
+    {
+        throw std::runtime_error("Can't rename " + temporaryPath + " to " + i_Path + ": " + error.message());
+    }
+}
+
+std::shared_ptr<const PricingTable> CatalogFile::load(const std::string &i_Path, const bool i_VerifyChecksum)
+{
+    auto file = std::make_shared<const MappedFile>(i_Path);
+    const void *image = file->data();
+    const std::size_t imageSize = file->size();
+    return std::make_shared<const PricingTable>(
+        PricingTable::fromImage(std::move(file), image, imageSize, i_VerifyChecksum));
+}
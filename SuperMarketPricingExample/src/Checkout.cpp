@@ -1,12 +1,30 @@
 // Local
 #include "Checkout.hpp"
+#include <Metrics.hpp>
 // Standard Library
 #include <algorithm>
-#include <cmath>
+#include <stdexcept>
+#include <utility>
 
-Checkout::Checkout(const PricingScheme &i_PricingScheme)
-    : m_Total(0),
-      m_PricingScheme(i_PricingScheme)
+Checkout::Checkout(const PricingScheme &i_PricingScheme, std::pmr::memory_resource *i_Memory)
+    : m_Subtotal(0),
+      m_Taxable(),
+      m_PricingTable(std::make_shared<const PricingTable>(i_PricingScheme.compile())),
+      m_Time(PromotionWindow::getCurrentTime()),
+      m_ScheduleSegment(m_PricingTable->getScheduleSegment(m_Time)),
+      m_Cart(i_Memory),
+      m_Journal(nullptr)
+{
+}
+
+Checkout::Checkout(std::shared_ptr<const PricingTable> i_PricingTable, std::pmr::memory_resource *i_Memory)
+    : m_Subtotal(0),
+      m_Taxable(),
+      m_PricingTable(std::move(i_PricingTable)),
+      m_Time(PromotionWindow::getCurrentTime()),
+      m_ScheduleSegment(m_PricingTable->getScheduleSegment(m_Time)),
+      m_Cart(i_Memory),
+      m_Journal(nullptr)
 {
 }
 
@@ -14,97 +32,313 @@ Checkout::~Checkout()
 {
 }
 
-void Checkout::scan(const std::string &i_ID)
+void Checkout::reset()
 {
-    auto it = m_Cart.find(i_ID);
-    if (m_Cart.end() != it)
+    m_Cart.clear();
+    m_Subtotal = Money(0);
+    m_Taxable = PricingTable::TaxableAmounts();
+    /// The next transaction starts now, not when the previous one did
+    m_Time = PromotionWindow::getCurrentTime();
+    m_ScheduleSegment = m_PricingTable->getScheduleSegment(m_Time);
+    if (m_Journal)
     {
-        ++(it->second);
-    }
-    else
-    {
-        m_Cart[i_ID] = 1;
+        m_Journal->begin();
     }
 }
-int Checkout::getTotal()
+void Checkout::reset(std::shared_ptr<const PricingTable> i_PricingTable)
 {
-    calculateTotal();
-    return (std::round(m_Total * 100));
+    reset();
+    m_PricingTable = std::move(i_PricingTable);
+    m_ScheduleSegment = m_PricingTable->getScheduleSegment(m_Time);
 }
-void Checkout::calculateTotal()
+
+void Checkout::update(std::shared_ptr<const PricingTable> i_PricingTable, const std::vector<PricingTable::Index> &i_Changed)
 {
-    std::map<std::string, Item> itemPricesMap = m_PricingScheme.getItemMap();
-    for (auto &i : m_Cart)
+    const std::shared_ptr<const PricingTable> oldTable = std::move(m_PricingTable);
+    m_PricingTable = std::move(i_PricingTable);
+    m_ScheduleSegment = m_PricingTable->getScheduleSegment(m_Time);
+    for (const PricingTable::Index index : i_Changed)
     {
-        if (0 == i.second)
+        const auto it = m_Cart.find(index);
+        if (m_Cart.end() == it)
         {
             continue;
         }
-
-        Item item = itemPricesMap[i.first];
-        std::pair<std::string, double> bundle = item.getBundle();
-
-        double costOfItems = 0;
-        if (item.getBuyXGetY() != std::pair<int, int>{0, 0})
+        /// Reprices the line and its new bundle partner, or drops the line of a removed
+        /// item. A partner it no longer has a bundle with was priced as part of the old
+        /// bundle, so it is repriced too.
+        if (m_PricingTable->isRemoved(index))
+        {
+            removeLine(it);
+        }
+        else
         {
-            processBuyXGetY(costOfItems, item, i.second);
+            updateLine(index, it->second);
         }
-        else if (bundle != std::pair<std::string, double>{std::string(), 0})
+        const PricingTable::Index oldDeal = oldTable->findDeal(index, m_Time);
+        if (oldTable->hasBundle(oldDeal))
         {
-            auto it = m_Cart.find(bundle.first);
-            int numberOfSecondItem = 0;
-            if (m_Cart.end() != it)
+            const auto oldPartner = m_Cart.find(oldTable->getBundlePartner(oldDeal));
+            if (m_Cart.end() != oldPartner)
             {
-                numberOfSecondItem = it->second;
-                it->second = 0;
+                updateLine(oldPartner->first, oldPartner->second);
             }
+        }
+    }
+}
+void Checkout::update(std::shared_ptr<const PricingTable> i_PricingTable)
+{
+    m_PricingTable = std::move(i_PricingTable);
+    m_ScheduleSegment = m_PricingTable->getScheduleSegment(m_Time);
+    updateLines();
+}
+
+void Checkout::applyOverlay(const PricingOverlay &i_Overlay)
+{
+    std::vector<PricingTable::Index> changed;
+    auto table = std::make_shared<const PricingTable>(i_Overlay.compile(*m_PricingTable, changed));
+    update(std::move(table), changed);
+}
 
-            const int numberOfBundles = std::min(i.second, numberOfSecondItem);
-            const int numberOfUnbundlables = std::abs(i.second - numberOfSecondItem);
-            const double priceOfUnbundlables =
-                (i.second > numberOfSecondItem) ? item.getUnitPrice() : itemPricesMap[bundle.first].getUnitPrice();
-            const double taxOfUnbundables =
-                (i.second > numberOfSecondItem) ? item.getTax() : itemPricesMap[bundle.first].getTax();
+void Checkout::setTime(const std::int64_t i_Time)
+{
+    m_Time = i_Time;
+    if (i_Time >= m_ScheduleSegment.first && i_Time < m_ScheduleSegment.second)
+    {
+        return;
+    }
+    /// A scheduled deal started or ended since the cart was last priced
+    m_ScheduleSegment = m_PricingTable->getScheduleSegment(i_Time);
+    updateLines();
+}
 
-            costOfItems += bundle.second * numberOfBundles;
-            costOfItems += (taxOfUnbundables + 1) * priceOfUnbundlables * numberOfUnbundlables;
+void Checkout::setJournal(ScanJournal *io_Journal)
+{
+    m_Journal = io_Journal;
+    if (m_Journal)
+    {
+        /// Writes the cart as it is now, the scans that built it weren't journaled
+        m_Journal->begin();
+        for (const auto &line : m_Cart)
+        {
+            if (0 != line.second.quantity)
+            {
+                journalScan(line.first, ScanJournal::Kind::UNITS, line.second.quantity);
+            }
+            if (0 != line.second.grams)
+            {
+                journalScan(line.first, ScanJournal::Kind::GRAMS, line.second.grams);
+            }
         }
-        else
+    }
+}
+void Checkout::recover(ScanJournal &io_Journal)
+{
+    m_Journal = nullptr;
+    m_Cart.clear();
+    m_Subtotal = Money(0);
+    m_Taxable = PricingTable::TaxableAmounts();
+    for (const ScanJournal::Entry &entry : io_Journal.getRecovered())
+    {
+        if (entry.index >= m_PricingTable->size() || m_PricingTable->isRemoved(entry.index))
         {
-            costOfItems += (item.getTax() + 1) * item.getUnitPrice() * i.second;
+            continue;
         }
-        i.second = 0;
-        m_Total += costOfItems;
+        Line &line = m_Cart[entry.index];
+        (ScanJournal::Kind::UNITS == entry.kind ? line.quantity : line.grams) += entry.amount;
+        updateLine(entry.index, line);
     }
+    /// The recovered scans are still the open transaction of the journal
+    m_Journal = &io_Journal;
 }
-void Checkout::processBuyXGetY(double &io_Sum, const Item &i_Item, int &io_NumberOf)
+
+void Checkout::scan(std::string_view i_ID)
+{
+    scan(i_ID, 1);
+}
+void Checkout::scan(std::string_view i_ID, const int i_Quantity)
 {
-    const int buyX = i_Item.getBuyXGetY().first;
-    const int getY = i_Item.getBuyXGetY().second;
-    /// Default to # of remaining items in case there aren't enough left to be eligible
-    /// for the deal
-    int numberOfItemsToCalculate = io_NumberOf;
+    SMP_METRICS_TIME(SCAN);
+    SMP_METRICS_COUNT(SCANS);
+    SMP_METRICS_COUNT(LOOKUPS);
+    const PricingTable::Index index = m_PricingTable->find(i_ID);
+    if (PricingTable::NO_INDEX == index)
+    {
+        SMP_METRICS_COUNT(LOOKUP_MISSES);
+        return;
+    }
+    if (i_Quantity <= 0)
+    {
+        return;
+    }
 
-    /// If we still have enough to be eligible for the deal, subtract the buyX
-    /// from the # of items (because we're about to sum them) and also subtract the
-    /// getY (because they are free)
-    if (io_NumberOf >= buyX)
+    journalScan(index, ScanJournal::Kind::UNITS, i_Quantity);
+    Line &line = m_Cart[index];
+    line.quantity += i_Quantity;
+    updateLine(index, line);
+}
+void Checkout::scanWeight(std::string_view i_ID, const int i_Grams)
+{
+    SMP_METRICS_TIME(SCAN);
+    SMP_METRICS_COUNT(SCANS);
+    SMP_METRICS_COUNT(LOOKUPS);
+    const PricingTable::Index index = m_PricingTable->find(i_ID);
+    if (PricingTable::NO_INDEX == index)
     {
-        numberOfItemsToCalculate = buyX;
-        io_NumberOf -= buyX;
-        io_NumberOf -= getY;
+        SMP_METRICS_COUNT(LOOKUP_MISSES);
+        return;
     }
-    else
+    if (i_Grams <= 0)
     {
-        io_NumberOf = 0;
+        return;
     }
 
-    /// Update sum for cost of this batch of items
-    io_Sum += (i_Item.getTax() + 1) * i_Item.getUnitPrice() * numberOfItemsToCalculate;
+    journalScan(index, ScanJournal::Kind::GRAMS, i_Grams);
+    Line &line = m_Cart[index];
+    line.grams += i_Grams;
+    updateLine(index, line);
+}
+void Checkout::scanBarcode(std::string_view i_Barcode, const Barcode::PrefixRules &i_Rules)
+{
+    SMP_METRICS_TIME(SCAN);
+    SMP_METRICS_COUNT(SCANS);
+    SMP_METRICS_COUNT(LOOKUPS);
+    const Barcode barcode = Barcode::parse(i_Barcode, i_Rules);
+    const PricingTable::Index index = barcode.isValid() ? m_PricingTable->findBarcode(barcode.getItemKey()) : PricingTable::NO_INDEX;
+    if (PricingTable::NO_INDEX == index)
+    {
+        SMP_METRICS_COUNT(LOOKUP_MISSES);
+        return;
+    }
+
+    /// Weights are added as grams, everything else as units
+    ScanJournal::Kind kind = ScanJournal::Kind::UNITS;
+    int amount = 1;
+    if (Barcode::Embedded::WEIGHT == barcode.getEmbedded())
+    {
+        kind = ScanJournal::Kind::GRAMS;
+        amount = barcode.getValue();
+    }
+    else if (Barcode::Embedded::PRICE == barcode.getEmbedded())
+    {
+        const std::int64_t unitPrice = std::max<std::int64_t>(1, m_PricingTable->getUnitPrice(index).getCents());
+        amount = static_cast<int>((barcode.getValue() + unitPrice / 2) / unitPrice);
+    }
+    if (0 == amount)
+    {
+        return;
+    }
+
+    journalScan(index, kind, amount);
+    Line &line = m_Cart[index];
+    (ScanJournal::Kind::GRAMS == kind ? line.grams : line.quantity) += amount;
+    updateLine(index, line);
+}
+int Checkout::getTotal() const
+{
+    SMP_METRICS_TIME(GET_TOTAL);
+    return static_cast<int>((m_Subtotal + m_PricingTable->computeTax(m_Taxable)).getCents());
+}
+void Checkout::writeReceipt(ReceiptSink &io_Sink) const
+{
+    const PricingTable &table = *m_PricingTable;
+    ReceiptFormatter formatter(io_Sink);
+    for (const auto &line : m_Cart)
+    {
+        const PricingTable::Index deal = table.findDeal(line.first, m_Time);
+        const auto it = m_Cart.find(table.findBundlePartner(line.first, deal, m_Time));
+        const int numberOfPartner = m_Cart.end() != it ? it->second.quantity : 0;
+        formatter.addLine(
+            table,
+            line.first,
+            deal,
+            line.second.quantity,
+            line.second.grams,
+            table.describeLine(line.first, deal, line.second.quantity, line.second.grams, numberOfPartner));
+    }
+    for (std::size_t taxClass = 0; taxClass < TaxClass::COUNT; ++taxClass)
+    {
+        if (Money(0) != m_Taxable[taxClass])
+        {
+            formatter.addTax(table.getTaxRate(TaxClass(static_cast<std::uint8_t>(taxClass))), m_Taxable[taxClass]);
+        }
+    }
+    formatter.addTotal(Money(getTotal()));
+}
+std::size_t Checkout::writeReceipt(char *o_Buffer, const std::size_t i_Size) const
+{
+    BufferReceiptSink sink(o_Buffer, i_Size);
+    writeReceipt(sink);
+    return sink.getLength();
+}
+void Checkout::updateLine(const PricingTable::Index i_Index, Line &io_Line)
+{
+    const PricingTable &table = *m_PricingTable;
+
+    /// Only the bundle partner's line can change along with this one, and only if the
+    /// partner has been scanned and has the bundle too (see findBundlePartner)
+    const PricingTable::Index deal = table.findDeal(i_Index, m_Time);
+    const auto it = m_Cart.find(table.findBundlePartner(i_Index, deal, m_Time));
+    if (m_Cart.end() == it)
+    {
+        setLineCost(i_Index, deal, io_Line, 0);
+        return;
+    }
 
-    /// If we still have items left at this point, just use recursion until we are done
-    if (io_NumberOf > 0)
+    Line &partnerLine = it->second;
+    if (0 < io_Line.quantity && 0 < partnerLine.quantity)
+    {
+        SMP_METRICS_COUNT(BUNDLE_MATCHES);
+    }
+    setLineCost(i_Index, deal, io_Line, partnerLine.quantity);
+    setLineCost(it->first, table.findDeal(it->first, m_Time), partnerLine, io_Line.quantity);
+}
+void Checkout::updateLines()
+{
+    for (auto it = m_Cart.begin(); m_Cart.end() != it;)
+    {
+        if (m_PricingTable->isRemoved(it->first))
+        {
+            it = removeLine(it);
+            continue;
+        }
+        updateLine(it->first, it->second);
+        ++it;
+    }
+}
+std::pmr::map<PricingTable::Index, Checkout::Line>::iterator Checkout::removeLine(std::pmr::map<PricingTable::Index, Line>::iterator i_Line)
+{
+    m_Subtotal -= i_Line->second.subtotal;
+    m_Taxable[i_Line->second.taxClass.getId()] -= i_Line->second.taxableCost;
+    return m_Cart.erase(i_Line);
+}
+void Checkout::setLineCost(const PricingTable::Index i_Index, const PricingTable::Index i_Deal, Line &io_Line, const int i_NumberOfPartner)
+{
+    const PricingTable &table = *m_PricingTable;
+    const PricingTable::LineDetails details = table.describeLine(i_Index, i_Deal, io_Line.quantity, io_Line.grams, i_NumberOfPartner);
+    if (0 < details.numberOfFreeUnits)
+    {
+        SMP_METRICS_COUNT(BUY_X_GET_Y_APPLICATIONS);
+    }
+    m_Subtotal += details.total - io_Line.subtotal;
+    /// The item may have moved to another tax class since the line was last priced
+    m_Taxable[io_Line.taxClass.getId()] -= io_Line.taxableCost;
+    io_Line.taxClass = table.getTaxClass(i_Index);
+    m_Taxable[io_Line.taxClass.getId()] += details.taxableCost;
+    io_Line.subtotal = details.total;
+    io_Line.taxableCost = details.taxableCost;
+}
+void Checkout::journalScan(const PricingTable::Index i_Index, const ScanJournal::Kind i_Kind, const int i_Amount)
+{
+    if (!m_Journal || m_Journal->append(i_Index, i_Kind, i_Amount))
+    {
+        return;
+    }
+    /// The journal is full: compacts the transaction to one record per line and kind
+    if (2 * m_Cart.size() + 1 > m_Journal->getCapacity())
     {
-        processBuyXGetY(io_Sum, i_Item, io_NumberOf);
+        throw std::runtime_error("The scan journal has no room for the cart");
     }
+    setJournal(m_Journal);
+    m_Journal->append(i_Index, i_Kind, i_Amount);
 }
\ No newline at end of file
@@ -0,0 +1,164 @@
+// Local
+#include "ConcurrentCheckout.hpp"
+#include <Metrics.hpp>
+// Standard Library
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    ///@brief Small number given to each thread on first use, so threads spread evenly
+    /// over the shards (instead of hashing thread IDs, which can collide)
+    unsigned getThreadNumber()
+    {
+        static std::atomic<unsigned> s_NextThreadNumber(0);
+        thread_local const unsigned t_ThreadNumber = s_NextThreadNumber.fetch_add(1, std::memory_order_relaxed);
+        return t_ThreadNumber;
+    }
+} // namespace
+
+ConcurrentCheckout::ConcurrentCheckout(std::shared_ptr<const PricingTable> i_PricingTable, const unsigned i_NumberOfShards)
+    : m_PricingTable(std::move(i_PricingTable)),
+      m_NumberOfShards(std::max(1u, i_NumberOfShards ? i_NumberOfShards : std::thread::hardware_concurrency())),
+      m_Shards(new Shard[m_NumberOfShards]),
+      m_Time(PromotionWindow::getCurrentTime()),
+      m_ScheduleSegment(m_PricingTable->getScheduleSegment(m_Time)),
+      m_IsTotalStale(false),
+      m_Total(0),
+      m_NumberOfScansPriced(0)
+{
+    for (unsigned shard = 0; shard < m_NumberOfShards; ++shard)
+    {
+        m_Shards[shard].numberOfScans = 0;
+    }
+}
+
+ConcurrentCheckout::~ConcurrentCheckout()
+{
+}
+
+void ConcurrentCheckout::scan(std::string_view i_ID)
+{
+    add(i_ID, 1, 0);
+}
+void ConcurrentCheckout::scan(std::string_view i_ID, const int i_Quantity)
+{
+    add(i_ID, i_Quantity, 0);
+}
+void ConcurrentCheckout::scanWeight(std::string_view i_ID, const int i_Grams)
+{
+    add(i_ID, 0, i_Grams);
+}
+
+void ConcurrentCheckout::add(std::string_view i_ID, const int i_Quantity, const int i_Grams)
+{
+    SMP_METRICS_TIME(SCAN);
+    SMP_METRICS_COUNT(SCANS);
+    SMP_METRICS_COUNT(LOOKUPS);
+    /// The table is immutable, so the lookup needs no lock
+    const PricingTable::Index index = m_PricingTable->find(i_ID);
+    if (PricingTable::NO_INDEX == index)
+    {
+        SMP_METRICS_COUNT(LOOKUP_MISSES);
+        return;
+    }
+    /// Only one of them is set, a quantity or weight of 0 or less is ignored
+    if (i_Quantity < 0 || i_Grams < 0 || 0 == i_Quantity + i_Grams)
+    {
+        return;
+    }
+
+    Shard &shard = m_Shards[getThreadNumber() % m_NumberOfShards];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    Counts &counts = shard.lines[index];
+    counts.quantity += i_Quantity;
+    counts.grams += i_Grams;
+    ++shard.numberOfScans;
+}
+
+int ConcurrentCheckout::getTotal() const
+{
+    SMP_METRICS_TIME(GET_TOTAL);
+    std::lock_guard<std::mutex> totalLock(m_TotalMutex);
+
+    /// Lock every shard (always in the same order) to merge a consistent set of scans
+    std::vector<std::unique_lock<std::mutex>> locks;
+    locks.reserve(m_NumberOfShards);
+    std::uint64_t numberOfScans = 0;
+    for (unsigned shard = 0; shard < m_NumberOfShards; ++shard)
+    {
+        locks.emplace_back(m_Shards[shard].mutex);
+        numberOfScans += m_Shards[shard].numberOfScans;
+    }
+    if (numberOfScans == m_NumberOfScansPriced && !m_IsTotalStale)
+    {
+        return static_cast<int>(m_Total.getCents());
+    }
+
+    std::map<PricingTable::Index, Counts> merged;
+    for (unsigned shard = 0; shard < m_NumberOfShards; ++shard)
+    {
+        for (const auto &line : m_Shards[shard].lines)
+        {
+            Counts &counts = merged[line.first];
+            counts.quantity += line.second.quantity;
+            counts.grams += line.second.grams;
+        }
+    }
+    locks.clear();
+
+    const PricingTable &table = *m_PricingTable;
+    Money subtotal(0);
+    PricingTable::TaxableAmounts taxable = {};
+    for (const auto &line : merged)
+    {
+        const PricingTable::Index deal = table.findDeal(line.first, m_Time);
+        const auto it = merged.find(table.findBundlePartner(line.first, deal, m_Time));
+        const int numberOfPartner = merged.end() != it ? it->second.quantity : 0;
+        const PricingTable::LineDetails details = table.describeLine(line.first, deal, line.second.quantity, line.second.grams, numberOfPartner);
+        subtotal += details.total;
+        taxable[table.getTaxClass(line.first).getId()] += details.taxableCost;
+    }
+    m_Total = subtotal + table.computeTax(taxable);
+    m_NumberOfScansPriced = numberOfScans;
+    m_IsTotalStale = false;
+    return static_cast<int>(m_Total.getCents());
+}
+
+void ConcurrentCheckout::reset()
+{
+    std::lock_guard<std::mutex> totalLock(m_TotalMutex);
+    for (unsigned shard = 0; shard < m_NumberOfShards; ++shard)
+    {
+        std::lock_guard<std::mutex> lock(m_Shards[shard].mutex);
+        m_Shards[shard].lines.clear();
+        m_Shards[shard].numberOfScans = 0;
+    }
+    m_Total = Money(0);
+    m_NumberOfScansPriced = 0;
+    m_Time = PromotionWindow::getCurrentTime();
+    m_ScheduleSegment = m_PricingTable->getScheduleSegment(m_Time);
+    m_IsTotalStale = false;
+}
+
+void ConcurrentCheckout::setTime(const std::int64_t i_Time)
+{
+    std::lock_guard<std::mutex> totalLock(m_TotalMutex);
+    m_Time = i_Time;
+    if (i_Time >= m_ScheduleSegment.first && i_Time < m_ScheduleSegment.second)
+    {
+        return;
+    }
+    /// A scheduled deal started or ended since the cart was last priced
+    m_ScheduleSegment = m_PricingTable->getScheduleSegment(i_Time);
+    m_IsTotalStale = true;
+}
+
+std::int64_t ConcurrentCheckout::getTime() const
+{
+    std::lock_guard<std::mutex> totalLock(m_TotalMutex);
+    return m_Time;
+}
@@ -0,0 +1,685 @@
+// Local
+#include "DifferentialTester.hpp"
+#include <BatchPricer.hpp>
+#include <Checkout.hpp>
+#include <ConcurrentCheckout.hpp>
+#include <PricingTable.hpp>
+#include <PromotionEngine.hpp>
+#include <ThreadPool.hpp>
+// Standard Library
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <variant>
+
+namespace
+{
+    ///@brief Scans a case into any kind of checkout
+    template <typename CheckoutType>
+    void scanAll(const DifferentialTester::Case &i_Case, CheckoutType &io_Checkout)
+    {
+        for (const auto &scan : i_Case.scans)
+        {
+            if (0 != scan.grams)
+            {
+                io_Checkout.scanWeight(scan.id, scan.grams);
+            }
+            else if (1 == scan.quantity)
+            {
+                io_Checkout.scan(scan.id);
+            }
+            else
+            {
+                io_Checkout.scan(scan.id, scan.quantity);
+            }
+        }
+    }
+
+    ///@brief IDs of the scanned units, one per unit
+    ///@return false if the case has weighed scans
+    bool listUnits(const DifferentialTester::Case &i_Case, std::vector<std::string> &o_Ids)
+    {
+        for (const auto &scan : i_Case.scans)
+        {
+            if (0 != scan.grams)
+            {
+                return false;
+            }
+            o_Ids.insert(o_Ids.end(), scan.quantity, scan.id);
+        }
+        return true;
+    }
+
+    ///@brief Copy of an item with another price, tax or promotion
+    Item withPromotion(const Item &i_Item, const Promotion &i_Promotion)
+    {
+        return Item(i_Item.getId(), i_Item.getUnitPrice(), i_Promotion, i_Item.getTaxClass());
+    }
+    Item withTaxClass(const Item &i_Item, const TaxClass i_TaxClass)
+    {
+        return Item(i_Item.getId(), i_Item.getUnitPrice(), i_Item.getPromotion(), i_TaxClass);
+    }
+    Item withUnitPrice(const Item &i_Item, const Money i_UnitPrice)
+    {
+        return Item(i_Item.getId(), i_UnitPrice, i_Item.getPromotion(), i_Item.getTaxClass());
+    }
+
+    ///@brief Deal of an item at the time of a case: the deal scheduled for that time, if
+    /// any, else the item's own
+    const Promotion &findPromotion(const DifferentialTester::Case &i_Case, const Item &i_Item)
+    {
+        for (const auto &scheduled : i_Case.schedules)
+        {
+            if (scheduled.id != i_Item.getId())
+            {
+                continue;
+            }
+            bool isInWindow = false;
+            scheduled.window.forEachOccurrence([&](const std::int64_t i_Start, const std::int64_t i_End) {
+                isInWindow = isInWindow || (i_Start <= i_Case.time && i_Case.time < i_End);
+            });
+            if (isInWindow)
+            {
+                return scheduled.promotion;
+            }
+        }
+        return i_Item.getPromotion();
+    }
+
+    ///@brief Readable form of a promotion, as C++
+    std::string describePromotion(const Promotion &i_Promotion)
+    {
+        std::ostringstream text;
+        std::visit(Overloaded{
+                       [&](const SimplePrice &) {
+                           text << "SimplePrice()";
+                       },
+                       [&](const BuyXGetY &i_Deal) {
+                           text << "BuyXGetY{" << i_Deal.buyX << ", " << i_Deal.getY << "}";
+                       },
+                       [&](const Bundle &i_Deal) {
+                           text << "Bundle{\"" << i_Deal.partnerId << "\", Money(" << i_Deal.price.getCents() << ")}";
+                       }},
+                   i_Promotion);
+        return text.str();
+    }
+
+    ///@brief Case without the items or scans in [i_Begin, i_End)
+    template <typename T>
+    std::vector<T> without(const std::vector<T> &i_Values, const std::size_t i_Begin, const std::size_t i_End)
+    {
+        std::vector<T> values;
+        values.reserve(i_Values.size() - (i_End - i_Begin));
+        for (std::size_t i = 0; i < i_Values.size(); ++i)
+        {
+            if (i < i_Begin || i >= i_End)
+            {
+                values.push_back(i_Values[i]);
+            }
+        }
+        return values;
+    }
+} // namespace
+
+DifferentialTester::DifferentialTester(const Options &i_Options)
+    : m_Options(i_Options)
+{
+}
+
+DifferentialTester::~DifferentialTester()
+{
+}
+
+void DifferentialTester::addEngine(const std::string &i_Name, Engine i_Engine)
+{
+    m_Engines.emplace_back(i_Name, std::move(i_Engine));
+}
+
+void DifferentialTester::addDefaultEngines()
+{
+    addEngine("Checkout", [](const Case &i_Case) -> std::optional<std::int64_t> {
+        Checkout checkout(makeScheme(i_Case));
+        checkout.setTime(i_Case.time);
+        scanAll(i_Case, checkout);
+        return checkout.getTotal();
+    });
+    addEngine("Checkout (reset)", [](const Case &i_Case) -> std::optional<std::int64_t> {
+        /// A lane reuses its checkout: the previous customer's cart has to be gone
+        const auto table = std::make_shared<const PricingTable>(makeScheme(i_Case).compile());
+        Checkout checkout(table);
+        Case previous = i_Case;
+        std::reverse(previous.scans.begin(), previous.scans.end());
+        scanAll(previous, checkout);
+        checkout.reset(table);
+        checkout.setTime(i_Case.time);
+        scanAll(i_Case, checkout);
+        return checkout.getTotal();
+    });
+    addEngine("Checkout (delta update)", [](const Case &i_Case) -> std::optional<std::int64_t> {
+        /// The cart is scanned with other prices, tax classes and rates and no deals, then
+        /// the real items and rates are published as a delta and only the changed lines
+        /// are repriced
+        PricingScheme ps;
+        for (std::size_t taxClass = 0; taxClass < TaxClass::COUNT; ++taxClass)
+        {
+            ps.setTaxRate(TaxClass(static_cast<std::uint8_t>(taxClass)), TaxRate(static_cast<std::int32_t>(100 * taxClass + 50)));
+        }
+        for (const Item &item : i_Case.items)
+        {
+            const TaxClass otherClass(static_cast<std::uint8_t>((item.getTaxClass().getId() + 1) % TaxClass::COUNT));
+            ps.addItem(Item(item.getId(), item.getUnitPrice() + Money(7), SimplePrice(), otherClass));
+        }
+        const std::uint64_t version = ps.getVersion();
+        Checkout checkout(std::make_shared<const PricingTable>(ps.compile()));
+        checkout.setTime(i_Case.time);
+        scanAll(i_Case, checkout);
+
+        PricingScheme::Delta delta;
+        delta.items = i_Case.items;
+        for (std::size_t taxClass = 0; taxClass < TaxClass::COUNT; ++taxClass)
+        {
+            const TaxRate rate = taxClass < i_Case.taxRates.size() ? i_Case.taxRates[taxClass] : TaxRate();
+            delta.taxRates.emplace_back(TaxClass(static_cast<std::uint8_t>(taxClass)), rate);
+        }
+        ps.applyDelta(delta);
+        for (const auto &scheduled : i_Case.schedules)
+        {
+            ps.schedulePromotion(scheduled.id, scheduled.promotion, scheduled.window);
+        }
+        std::vector<PricingTable::Index> changed;
+        if (!ps.getChangesSince(version, changed))
+        {
+            return std::nullopt;
+        }
+        checkout.update(std::make_shared<const PricingTable>(ps.compile()), changed);
+        return checkout.getTotal();
+    });
+    addEngine("ConcurrentCheckout", [](const Case &i_Case) -> std::optional<std::int64_t> {
+        ConcurrentCheckout checkout(std::make_shared<const PricingTable>(makeScheme(i_Case).compile()), 2);
+        checkout.setTime(i_Case.time);
+        scanAll(i_Case, checkout);
+        return checkout.getTotal();
+    });
+    addEngine("BatchPricer", [](const Case &i_Case) -> std::optional<std::int64_t> {
+        BatchPricer::Cart cart;
+        if (!listUnits(i_Case, cart))
+        {
+            return std::nullopt;
+        }
+        BatchPricer pricer(std::make_shared<const PricingTable>(makeScheme(i_Case).compile()), 1);
+        pricer.setTime(i_Case.time);
+        return pricer.priceCart(cart).getCents();
+    });
+    addEngine("PromotionEngine (no deals)", [](const Case &i_Case) -> std::optional<std::int64_t> {
+        std::vector<std::string> cart;
+        if (!listUnits(i_Case, cart))
+        {
+            return std::nullopt;
+        }
+        PromotionEngine engine(std::make_shared<const PricingTable>(makeScheme(i_Case).compile()), {});
+        engine.setTime(i_Case.time);
+        return engine.price(cart, std::chrono::microseconds(0)).total.getCents();
+    });
+}
+
+DifferentialTester::Report DifferentialTester::run() const
+{
+    Report report{m_Options.numberOfCases, 0, {}};
+    std::atomic<std::size_t> numberOfComparisons(0);
+    std::mutex mutex;
+    /// Failures of the lowest case numbers, with the position of their engine
+    std::vector<std::pair<std::size_t, Failure>> failures;
+
+    ThreadPool pool(m_Options.numberOfThreads);
+    pool.parallelFor(m_Options.numberOfCases, 64, [&](const std::size_t i_Begin, const std::size_t i_End, unsigned) {
+        std::size_t numberCompared = 0;
+        for (std::size_t caseNumber = i_Begin; caseNumber < i_End; ++caseNumber)
+        {
+            const Case testCase = generate(m_Options, caseNumber);
+            const std::int64_t expected = priceReference(testCase);
+            for (std::size_t engine = 0; engine < m_Engines.size(); ++engine)
+            {
+                Failure failure{m_Engines[engine].first, caseNumber, Case(), expected, 0, std::string()};
+                if (check(m_Engines[engine].second, testCase, numberCompared, failure))
+                {
+                    continue;
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                failures.emplace_back(engine, std::move(failure));
+                if (failures.size() > 2 * m_Options.maxFailures)
+                {
+                    std::sort(failures.begin(), failures.end(), [](const auto &i_Left, const auto &i_Right) {
+                        return std::make_pair(i_Left.second.caseNumber, i_Left.first) < std::make_pair(i_Right.second.caseNumber, i_Right.first);
+                    });
+                    failures.resize(m_Options.maxFailures);
+                }
+            }
+        }
+        numberOfComparisons += numberCompared;
+    });
+
+    /// Keeps the same failures whatever the scheduling was
+    std::sort(failures.begin(), failures.end(), [](const auto &i_Left, const auto &i_Right) {
+        return std::make_pair(i_Left.second.caseNumber, i_Left.first) < std::make_pair(i_Right.second.caseNumber, i_Right.first);
+    });
+    failures.resize(std::min(failures.size(), m_Options.maxFailures));
+    for (auto &failure : failures)
+    {
+        report.failures.push_back(shrink(m_Engines[failure.first].second, std::move(failure.second)));
+    }
+    report.numberOfComparisons = numberOfComparisons;
+    return report;
+}
+
+DifferentialTester::Case DifferentialTester::generate(const Options &i_Options, const std::uint64_t i_CaseNumber)
+{
+    std::mt19937_64 random(i_Options.seed * 0x9E3779B97F4A7C15ull + i_CaseNumber);
+    Case testCase;
+
+    /// IDs sort differently than they are added once there are 10 or more
+    const std::size_t numberOfItems = 1 + random() % std::max<std::size_t>(1, i_Options.maxItems);
+    std::vector<std::string> ids;
+    for (std::size_t item = 0; item < numberOfItems; ++item)
+    {
+        ids.push_back("I" + std::to_string(item));
+    }
+    static const std::int32_t TAX_RATES[] = {0, 500, 925, 1000};
+    const std::size_t numberOfTaxClasses = 1 + random() % 4;
+    for (std::size_t taxClass = 0; taxClass < numberOfTaxClasses; ++taxClass)
+    {
+        const std::uint64_t rateChoice = random() % 5;
+        testCase.taxRates.push_back(TaxRate(rateChoice < 4 ? TAX_RATES[rateChoice] : static_cast<std::int32_t>(random() % 2500)));
+    }
+    std::vector<Promotion> promotions(numberOfItems, SimplePrice());
+    std::vector<bool> isPromotionSet(numberOfItems, false);
+    for (std::size_t item = 0; item < numberOfItems; ++item)
+    {
+        const std::uint64_t kind = random() % 4;
+        if (isPromotionSet[item] || kind < 2)
+        {
+            continue;
+        }
+        isPromotionSet[item] = true;
+        if (2 == kind)
+        {
+            promotions[item] = BuyXGetY{1 + static_cast<int>(random() % 4), 1 + static_cast<int>(random() % 3)};
+            continue;
+        }
+        std::vector<std::size_t> partners;
+        for (std::size_t partner = item + 1; partner < numberOfItems; ++partner)
+        {
+            if (!isPromotionSet[partner])
+            {
+                partners.push_back(partner);
+            }
+        }
+        if (partners.empty() || 0 == random() % 8)
+        {
+            /// Never completed, priced as SimplePrice
+            promotions[item] = Bundle{"MISSING", Money(random() % 4000)};
+            continue;
+        }
+        if (0 == random() % 4)
+        {
+            /// One-sided, with an item before or after it that keeps its own deal: priced as
+            /// SimplePrice (see PricingTable::findBundlePartner)
+            const std::size_t partner = (item + 1 + random() % (numberOfItems - 1)) % numberOfItems;
+            promotions[item] = Bundle{ids[partner], Money(random() % 4000)};
+            continue;
+        }
+        /// Most bundles are pairs that name each other, as in real catalogs
+        const std::size_t partner = partners[random() % partners.size()];
+        isPromotionSet[partner] = true;
+        promotions[item] = Bundle{ids[partner], Money(random() % 4000)};
+        promotions[partner] = Bundle{ids[item], Money(random() % 4000)};
+    }
+    for (std::size_t item = 0; item < numberOfItems; ++item)
+    {
+        const Money unitPrice(0 == random() % 10 ? random() % 100000 : random() % 2000);
+        const TaxClass taxClass(static_cast<std::uint8_t>(random() % numberOfTaxClasses));
+        testCase.items.push_back(Item(ids[item], unitPrice, promotions[item], taxClass));
+    }
+
+    /// Deals scheduled around the case's time for some of the items, once or repeating. A
+    /// scheduled deal replacing one side of a bundle leaves the other side one-sided.
+    const std::int64_t start = 1700000000;
+    testCase.time = start + static_cast<std::int64_t>(random() % 1000);
+    for (std::size_t item = 0; item < numberOfItems; ++item)
+    {
+        if (0 != random() % 3)
+        {
+            continue;
+        }
+        PromotionWindow window{start + static_cast<std::int64_t>(random() % 1000), 0};
+        window.end = window.start + 1 + static_cast<std::int64_t>(random() % 300);
+        if (0 == random() % 2)
+        {
+            window.period = window.end - window.start + static_cast<std::int64_t>(random() % 300);
+            window.until = window.start + window.period * (1 + static_cast<std::int64_t>(random() % 4));
+        }
+        testCase.schedules.push_back(ScheduledDeal{ids[item], SimplePrice(), window});
+        const std::uint64_t kind = random() % 4;
+        if (1 == kind && numberOfItems > 1)
+        {
+            const std::size_t partner = (item + 1 + random() % (numberOfItems - 1)) % numberOfItems;
+            testCase.schedules.back().promotion = Bundle{ids[partner], Money(random() % 4000)};
+        }
+        else if (1 < kind)
+        {
+            testCase.schedules.back().promotion = BuyXGetY{1 + static_cast<int>(random() % 4), 1 + static_cast<int>(random() % 3)};
+        }
+    }
+
+    const std::size_t numberOfScans = random() % (i_Options.maxScans + 1);
+    for (std::size_t scan = 0; scan < numberOfScans; ++scan)
+    {
+        const std::string id = 0 == random() % 20 ? std::string("UNKNOWN") : ids[random() % numberOfItems];
+        if (0 == random() % 10)
+        {
+            testCase.scans.push_back(Scan{id, 0, 1 + static_cast<int>(random() % 3000)});
+        }
+        else
+        {
+            testCase.scans.push_back(Scan{id, 0 == random() % 5 ? 1 + static_cast<int>(random() % 20) : 1, 0});
+        }
+    }
+    return testCase;
+}
+
+std::int64_t DifferentialTester::priceReference(const Case &i_Case)
+{
+    /// Position of each item in the catalog (the first one added wins)
+    std::map<std::string, std::size_t> positions;
+    for (std::size_t position = 0; position < i_Case.items.size(); ++position)
+    {
+        positions.emplace(i_Case.items[position].getId(), position);
+    }
+
+    /// Units and grams of each item in the cart (unknown items aren't sold)
+    std::map<std::string, std::pair<std::int64_t, std::int64_t>> cart;
+    for (const Scan &scan : i_Case.scans)
+    {
+        if (positions.count(scan.id))
+        {
+            cart[scan.id].first += scan.quantity;
+            cart[scan.id].second += scan.grams;
+        }
+    }
+
+    /// Tax is charged on the taxable amount of each class, once for the cart
+    Money total;
+    std::map<int, Money> taxable;
+    for (const auto &line : cart)
+    {
+        const Item &item = i_Case.items[positions[line.first]];
+        const Promotion &promotion = findPromotion(i_Case, item);
+        const std::int64_t numberOf = line.second.first;
+        std::int64_t numberOfPaid = numberOf;
+        Money bundles;
+        if (const BuyXGetY *deal = std::get_if<BuyXGetY>(&promotion))
+        {
+            /// Units are counted off in groups of buyX paid and getY free
+            numberOfPaid = 0;
+            for (std::int64_t unit = 0; unit < numberOf; ++unit)
+            {
+                numberOfPaid += unit % (deal->buyX + deal->getY) < deal->buyX ? 1 : 0;
+            }
+        }
+        else if (const Bundle *deal = std::get_if<Bundle>(&promotion))
+        {
+            /// Each unit that has a partner unit is part of a bundle, if the partner has a
+            /// bundle with the item too. The bundle price is charged once, to the line of the
+            /// item that was added to the catalog first.
+            const auto partnerPosition = positions.find(deal->partnerId);
+            const Bundle *partnerDeal = positions.end() == partnerPosition
+                                            ? nullptr
+                                            : std::get_if<Bundle>(&findPromotion(i_Case, i_Case.items[partnerPosition->second]));
+            if (partnerDeal && partnerDeal->partnerId == line.first)
+            {
+                const auto partner = cart.find(deal->partnerId);
+                const std::int64_t numberOfBundles = cart.end() == partner ? 0 : std::min(numberOf, partner->second.first);
+                numberOfPaid = numberOf - numberOfBundles;
+                if (positions[line.first] < positions[deal->partnerId])
+                {
+                    bundles = deal->price * numberOfBundles;
+                }
+            }
+        }
+        const Money cost = item.getUnitPrice() * numberOfPaid + item.getUnitPrice().scale(line.second.second, 1000);
+        total += cost + bundles;
+        taxable[item.getTaxClass().getId()] += cost;
+    }
+    for (const auto &taxClass : taxable)
+    {
+        const std::size_t id = static_cast<std::size_t>(taxClass.first);
+        total += (id < i_Case.taxRates.size() ? i_Case.taxRates[id] : TaxRate()).taxOn(taxClass.second);
+    }
+    return total.getCents();
+}
+
+PricingScheme DifferentialTester::makeScheme(const Case &i_Case)
+{
+    PricingScheme ps;
+    for (std::size_t taxClass = 0; taxClass < i_Case.taxRates.size(); ++taxClass)
+    {
+        ps.setTaxRate(TaxClass(static_cast<std::uint8_t>(taxClass)), i_Case.taxRates[taxClass]);
+    }
+    for (const Item &item : i_Case.items)
+    {
+        ps.addItem(item);
+    }
+    for (const auto &scheduled : i_Case.schedules)
+    {
+        ps.schedulePromotion(scheduled.id, scheduled.promotion, scheduled.window);
+    }
+    return ps;
+}
+
+std::string DifferentialTester::describe(const Case &i_Case)
+{
+    std::ostringstream text;
+    for (std::size_t taxClass = 0; taxClass < i_Case.taxRates.size(); ++taxClass)
+    {
+        text << "ps.setTaxRate(TaxClass(" << taxClass << "), TaxRate(" << i_Case.taxRates[taxClass].getBasisPoints() << "));\n";
+    }
+    for (const Item &item : i_Case.items)
+    {
+        text << "ps.addItem(Item(\"" << item.getId() << "\", Money(" << item.getUnitPrice().getCents() << "), "
+             << describePromotion(item.getPromotion()) << ", TaxClass(" << static_cast<int>(item.getTaxClass().getId()) << ")));\n";
+    }
+    for (const auto &scheduled : i_Case.schedules)
+    {
+        text << "ps.schedulePromotion(\"" << scheduled.id << "\", " << describePromotion(scheduled.promotion)
+             << ", PromotionWindow{" << scheduled.window.start << ", " << scheduled.window.end << ", "
+             << scheduled.window.period << ", " << scheduled.window.until << "});\n";
+    }
+    text << "c.setTime(" << i_Case.time << ");\n";
+    for (const Scan &scan : i_Case.scans)
+    {
+        if (0 != scan.grams)
+        {
+            text << "c.scanWeight(\"" << scan.id << "\", " << scan.grams << ");\n";
+        }
+        else
+        {
+            text << "c.scan(\"" << scan.id << "\", " << scan.quantity << ");\n";
+        }
+    }
+    return text.str();
+}
+
+bool DifferentialTester::check(const Engine &i_Engine, const Case &i_Case, std::size_t &io_NumberOfComparisons, Failure &io_Failure)
+{
+    std::optional<std::int64_t> actual;
+    try
+    {
+        actual = i_Engine(i_Case);
+    }
+    catch (const std::exception &e)
+    {
+        io_Failure.error = e.what();
+        io_Failure.shrunk = i_Case;
+        return false;
+    }
+    if (!actual)
+    {
+        return true;
+    }
+    ++io_NumberOfComparisons;
+    if (*actual == io_Failure.expected)
+    {
+        return true;
+    }
+    io_Failure.actual = *actual;
+    io_Failure.shrunk = i_Case;
+    return false;
+}
+
+DifferentialTester::Failure DifferentialTester::shrink(const Engine &i_Engine, Failure i_Failure)
+{
+    Failure &best = i_Failure;
+    std::size_t numberCompared = 0;
+    /// Keeps the candidate if the engine still fails on it
+    const auto isFailing = [&](Case &&i_Candidate) {
+        Failure failure{best.engine, best.caseNumber, Case(), priceReference(i_Candidate), 0, std::string()};
+        if (check(i_Engine, i_Candidate, numberCompared, failure))
+        {
+            return false;
+        }
+        best = std::move(failure);
+        return true;
+    };
+
+    for (bool isShrinking = true; isShrinking;)
+    {
+        isShrinking = false;
+
+        /// Fewer scans: large chunks first, down to single scans
+        for (std::size_t chunk = best.shrunk.scans.size(); chunk > 0; chunk /= 2)
+        {
+            for (std::size_t begin = 0; begin + chunk <= best.shrunk.scans.size();)
+            {
+                Case candidate = best.shrunk;
+                candidate.scans = without(best.shrunk.scans, begin, begin + chunk);
+                if (isFailing(std::move(candidate)))
+                {
+                    isShrinking = true;
+                }
+                else
+                {
+                    begin += chunk;
+                }
+            }
+        }
+
+        /// Fewer items (and their scheduled deals)
+        for (std::size_t item = best.shrunk.items.size(); item-- > 0;)
+        {
+            Case candidate = best.shrunk;
+            candidate.items = without(best.shrunk.items, item, item + 1);
+            candidate.schedules.clear();
+            for (const auto &scheduled : best.shrunk.schedules)
+            {
+                if (scheduled.id != best.shrunk.items[item].getId())
+                {
+                    candidate.schedules.push_back(scheduled);
+                }
+            }
+            isShrinking |= isFailing(std::move(candidate));
+        }
+
+        /// Fewer scheduled deals
+        for (std::size_t scheduled = best.shrunk.schedules.size(); scheduled-- > 0;)
+        {
+            Case candidate = best.shrunk;
+            candidate.schedules = without(best.shrunk.schedules, scheduled, scheduled + 1);
+            isShrinking |= isFailing(std::move(candidate));
+        }
+
+        /// Simpler items: no deal (for both items of a bundle), no tax, lower prices
+        for (std::size_t item = 0; item < best.shrunk.items.size(); ++item)
+        {
+            const Item current = best.shrunk.items[item];
+            std::vector<Item> candidates;
+            if (!std::holds_alternative<SimplePrice>(current.getPromotion()))
+            {
+                candidates.push_back(withPromotion(current, SimplePrice()));
+            }
+            if (TaxClass() != current.getTaxClass())
+            {
+                candidates.push_back(withTaxClass(current, TaxClass()));
+            }
+            if (current.getUnitPrice().getCents() > 1)
+            {
+                candidates.push_back(withUnitPrice(current, Money(current.getUnitPrice().getCents() / 2)));
+            }
+            for (const Item &simpler : candidates)
+            {
+                Case candidate = best.shrunk;
+                candidate.items = without(candidate.items, item, item + 1);
+                candidate.items.insert(candidate.items.begin() + item, simpler);
+                const Bundle *deal = std::get_if<Bundle>(&current.getPromotion());
+                for (std::size_t partner = 0; deal && partner < candidate.items.size(); ++partner)
+                {
+                    if (candidate.items[partner].getId() == deal->partnerId && std::holds_alternative<SimplePrice>(simpler.getPromotion()))
+                    {
+                        const Item partnerItem = withPromotion(candidate.items[partner], SimplePrice());
+                        candidate.items = without(candidate.items, partner, partner + 1);
+                        candidate.items.insert(candidate.items.begin() + partner, partnerItem);
+                    }
+                }
+                if (isFailing(std::move(candidate)))
+                {
+                    isShrinking = true;
+                    break;
+                }
+            }
+        }
+
+        /// Fewer tax classes, and rates of 0
+        for (std::size_t taxClass = best.shrunk.taxRates.size(); taxClass-- > 0;)
+        {
+            Case candidate = best.shrunk;
+            if (taxClass + 1 == candidate.taxRates.size())
+            {
+                candidate.taxRates.pop_back();
+            }
+            else if (TaxRate() != candidate.taxRates[taxClass])
+            {
+                candidate.taxRates[taxClass] = TaxRate();
+            }
+            else
+            {
+                continue;
+            }
+            isShrinking |= isFailing(std::move(candidate));
+        }
+
+        /// Smaller quantities and weights
+        for (std::size_t scan = 0; scan < best.shrunk.scans.size(); ++scan)
+        {
+            Case candidate = best.shrunk;
+            Scan &smaller = candidate.scans[scan];
+            if (smaller.quantity > 1)
+            {
+                smaller.quantity /= 2;
+            }
+            else if (smaller.grams > 1)
+            {
+                smaller.grams /= 2;
+            }
+            else
+            {
+                continue;
+            }
+            isShrinking |= isFailing(std::move(candidate));
+        }
+    }
+    return best;
+}
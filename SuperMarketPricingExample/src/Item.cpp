@@ -1,44 +1,73 @@
 // Local
 #include "Item.hpp"
 
+namespace
+{
+    Promotion toPromotion(const std::pair<int, int> &i_BuyXGetY)
+    {
+        if (0 == i_BuyXGetY.first && 0 == i_BuyXGetY.second)
+        {
+            return SimplePrice();
+        }
+        return BuyXGetY{i_BuyXGetY.first, i_BuyXGetY.second};
+    }
+    Promotion toPromotion(const std::pair<std::string, Money> &i_Bundle)
+    {
+        if (i_Bundle.first.empty())
+        {
+            return SimplePrice();
+        }
+        return Bundle{i_Bundle.first, i_Bundle.second};
+    }
+} // namespace
+
 Item::Item(
     const std::string &i_Id,
-    const double i_UnitPrice,
-    const double i_Tax,
+    const Money i_UnitPrice,
+    const TaxClass i_TaxClass,
     const std::pair<int, int> &i_BuyXGetY)
     : m_Id(i_Id),
       m_UnitPrice(i_UnitPrice),
-      m_Tax(i_Tax),
-      m_BuyXGetY(i_BuyXGetY),
-      m_Bundle({std::string(), 0})
+      m_TaxClass(i_TaxClass),
+      m_Promotion(toPromotion(i_BuyXGetY))
+{
+    validatePromotion(m_Id, m_Promotion);
+}
+Item::Item(
+    const std::string &i_Id,
+    const Money i_UnitPrice,
+    const std::pair<std::string, Money> &i_Bundle,
+    const TaxClass i_TaxClass)
+    : m_Id(i_Id),
+      m_UnitPrice(i_UnitPrice),
+      m_TaxClass(i_TaxClass),
+      m_Promotion(toPromotion(i_Bundle))
 {
 }
 Item::Item(
     const std::string &i_Id,
-    const double i_UnitPrice,
-    const std::pair<std::string, double> &i_Bundle,
-    const double i_Tax)
+    const Money i_UnitPrice,
+    const Promotion &i_Promotion,
+    const TaxClass i_TaxClass)
     : m_Id(i_Id),
       m_UnitPrice(i_UnitPrice),
-      m_Tax(i_Tax),
-      m_BuyXGetY({0, 0}),
-      m_Bundle(i_Bundle)
+      m_TaxClass(i_TaxClass),
+      m_Promotion(i_Promotion)
 {
+    validatePromotion(m_Id, m_Promotion);
 }
 Item::Item()
     : m_Id(),
-      m_UnitPrice(0),
-      m_Tax(0),
-      m_BuyXGetY({0, 0}),
-      m_Bundle({std::string(), 0})
+      m_UnitPrice(),
+      m_TaxClass(),
+      m_Promotion()
 {
 }
 Item::Item(const Item &i_Item)
     : m_Id(i_Item.m_Id),
       m_UnitPrice(i_Item.m_UnitPrice),
-      m_Tax(i_Item.m_Tax),
-      m_BuyXGetY(i_Item.m_BuyXGetY),
-      m_Bundle(i_Item.m_Bundle)
+      m_TaxClass(i_Item.m_TaxClass),
+      m_Promotion(i_Item.m_Promotion)
 {
 }
 Item::~Item()
@@ -47,8 +76,7 @@ Item::~Item()
 void Item::operator=(const Item &i_Item)
 {
     const_cast<std::string &>(m_Id) = i_Item.m_Id;
-    const_cast<double &>(m_UnitPrice) = i_Item.m_UnitPrice;
-    const_cast<double &>(m_Tax) = i_Item.m_Tax;
-    const_cast<std::pair<int, int> &>(m_BuyXGetY) = i_Item.m_BuyXGetY;
-    const_cast<std::pair<std::string, double> &>(m_Bundle) = i_Item.m_Bundle;
+    const_cast<Money &>(m_UnitPrice) = i_Item.m_UnitPrice;
+    const_cast<TaxClass &>(m_TaxClass) = i_Item.m_TaxClass;
+    const_cast<Promotion &>(m_Promotion) = i_Item.m_Promotion;
 }
\ No newline at end of file
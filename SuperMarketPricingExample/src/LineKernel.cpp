@@ -0,0 +1,111 @@
+// Local
+#include "LineKernel.hpp"
+#include "Money.hpp"
+// Platform Specific
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define LINE_KERNEL_HAS_AVX2 1
+#else
+#define LINE_KERNEL_HAS_AVX2 0
+#endif
+
+namespace
+{
+    using PriceLinesFunction = void (*)(
+        const std::int32_t *,
+        const std::int32_t *,
+        const std::int32_t *,
+        const std::size_t,
+        std::int64_t *);
+
+    ///@brief Prices one simple line with the same arithmetic as Money/TaxRate
+    std::int64_t priceLine(const std::int32_t i_UnitPriceCents, const std::int32_t i_TaxBasisPoints, const std::int32_t i_Quantity)
+    {
+        const Money costBeforeTax = Money(i_UnitPriceCents) * i_Quantity;
+        return (costBeforeTax + TaxRate(i_TaxBasisPoints).taxOn(costBeforeTax)).getCents();
+    }
+
+#if LINE_KERNEL_HAS_AVX2
+    ///@brief AVX2 version of LineKernel::priceLines, 4 lines per iteration.
+    ///@remarks The math is done in doubles. With the limits in LineKernel::fits(),
+    /// price * quantity and price * quantity * taxBasisPoints are below 2^53 so they are
+    /// exact, and the quotient by 10000 is at most ~2^40 so its rounding error is far less
+    /// than the 1/10000 it would take to cross an integer, so floor() matches the integer
+    /// division used by TaxRate::taxOn. Costs are below 2^51, which lets them be turned
+    /// into int64 by adding 2^52 and subtracting the bit patterns.
+    __attribute__((target("avx2"))) void priceLinesAvx2(
+        const std::int32_t *i_UnitPriceCents,
+        const std::int32_t *i_TaxBasisPoints,
+        const std::int32_t *i_Quantity,
+        const std::size_t i_Count,
+        std::int64_t *o_Cost)
+    {
+        const __m256d half = _mm256_set1_pd(5000.0);
+        const __m256d basisPointsPerUnit = _mm256_set1_pd(10000.0);
+        const __m256d magic = _mm256_set1_pd(4503599627370496.0); // 2^52
+        const __m256i magicBits = _mm256_castpd_si256(magic);
+
+        std::size_t i = 0;
+        for (; i + 4 <= i_Count; i += 4)
+        {
+            const __m256d unitPrice = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i *>(i_UnitPriceCents + i)));
+            const __m256d taxRate = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i *>(i_TaxBasisPoints + i)));
+            const __m256d quantity = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i *>(i_Quantity + i)));
+
+            const __m256d costBeforeTax = _mm256_mul_pd(unitPrice, quantity);
+            const __m256d tax = _mm256_floor_pd(
+                _mm256_div_pd(_mm256_add_pd(_mm256_mul_pd(costBeforeTax, taxRate), half), basisPointsPerUnit));
+            const __m256d cost = _mm256_add_pd(_mm256_add_pd(costBeforeTax, tax), magic);
+
+            _mm256_storeu_si256(
+                reinterpret_cast<__m256i *>(o_Cost + i),
+                _mm256_sub_epi64(_mm256_castpd_si256(cost), magicBits));
+        }
+        for (; i < i_Count; ++i)
+        {
+            o_Cost[i] = priceLine(i_UnitPriceCents[i], i_TaxBasisPoints[i], i_Quantity[i]);
+        }
+    }
+#endif
+
+    ///@brief Picks the fastest version of the kernel the CPU supports
+    PriceLinesFunction selectPriceLines(PriceLinesFunction i_Fallback)
+    {
+#if LINE_KERNEL_HAS_AVX2
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return priceLinesAvx2;
+        }
+#endif
+        return i_Fallback;
+    }
+} // namespace
+
+void LineKernel::priceLines(
+    const std::int32_t *i_UnitPriceCents,
+    const std::int32_t *i_TaxBasisPoints,
+    const std::int32_t *i_Quantity,
+    const std::size_t i_Count,
+    std::int64_t *o_Cost)
+{
+    static const PriceLinesFunction priceLinesFunction = selectPriceLines(priceLinesScalar);
+    priceLinesFunction(i_UnitPriceCents, i_TaxBasisPoints, i_Quantity, i_Count, o_Cost);
+}
+
+bool LineKernel::isVectorized()
+{
+    return selectPriceLines(priceLinesScalar) != priceLinesScalar;
+}
+
+void LineKernel::priceLinesScalar(
+    const std::int32_t *i_UnitPriceCents,
+    const std::int32_t *i_TaxBasisPoints,
+    const std::int32_t *i_Quantity,
+    const std::size_t i_Count,
+    std::int64_t *o_Cost)
+{
+    for (std::size_t i = 0; i < i_Count; ++i)
+    {
+        o_Cost[i] = priceLine(i_UnitPriceCents[i], i_TaxBasisPoints[i], i_Quantity[i]);
+    }
+}
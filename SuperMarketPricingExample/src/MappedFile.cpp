@@ -0,0 +1,207 @@
+// Local
+#include "MappedFile.hpp"
+// Platform Specific
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+// Standard Library
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string &i_Path)
+    : m_Data(nullptr),
+      m_Size(0),
+      m_File(INVALID_HANDLE_VALUE),
+      m_Mapping(nullptr)
+{
+    m_File = CreateFileA(i_Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (INVALID_HANDLE_VALUE == m_File)
+    {
+        throw std::runtime_error("Can't open " + i_Path);
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_File, &size))
+    {
+        CloseHandle(m_File);
+        throw std::runtime_error("Can't get the size of " + i_Path);
+    }
+    m_Size = static_cast<std::size_t>(size.QuadPart);
+    if (0 == m_Size)
+    {
+        return;
+    }
+
+    m_Mapping = CreateFileMappingA(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    m_Data = m_Mapping ? MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!m_Data)
+    {
+        if (m_Mapping)
+        {
+            CloseHandle(m_Mapping);
+        }
+        CloseHandle(m_File);
+        throw std::runtime_error("Can't map " + i_Path);
+    }
+}
+
+MappedFile::MappedFile(const std::string &i_Path, const std::size_t i_Size)
+    : m_Data(nullptr),
+      m_Size(0),
+      m_File(INVALID_HANDLE_VALUE),
+      m_Mapping(nullptr)
+{
+    m_File = CreateFileA(i_Path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (INVALID_HANDLE_VALUE == m_File)
+    {
+        throw std::runtime_error("Can't open " + i_Path);
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_File, &size))
+    {
+        CloseHandle(m_File);
+        throw std::runtime_error("Can't get the size of " + i_Path);
+    }
+    m_Size = std::max(static_cast<std::size_t>(size.QuadPart), i_Size);
+    if (0 == m_Size)
+    {
+        return;
+    }
+
+    /// Mapping more than the file's size grows the file
+    LARGE_INTEGER mappingSize;
+    mappingSize.QuadPart = static_cast<LONGLONG>(m_Size);
+    m_Mapping = CreateFileMappingA(m_File, nullptr, PAGE_READWRITE, mappingSize.HighPart, mappingSize.LowPart, nullptr);
+    m_Data = m_Mapping ? MapViewOfFile(m_Mapping, FILE_MAP_WRITE, 0, 0, 0) : nullptr;
+    if (!m_Data)
+    {
+        if (m_Mapping)
+        {
+            CloseHandle(m_Mapping);
+        }
+        CloseHandle(m_File);
+        throw std::runtime_error("Can't map " + i_Path);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_Data)
+    {
+        UnmapViewOfFile(m_Data);
+        CloseHandle(m_Mapping);
+    }
+    CloseHandle(m_File);
+}
+
+void MappedFile::sync(const std::size_t i_Offset, const std::size_t i_Length)
+{
+    if (0 == i_Length)
+    {
+        return;
+    }
+    if (!FlushViewOfFile(static_cast<char *>(m_Data) + i_Offset, i_Length) || !FlushFileBuffers(m_File))
+    {
+        throw std::runtime_error("Can't write the mapped pages to the disk");
+    }
+}
+#else
+MappedFile::MappedFile(const std::string &i_Path)
+    : m_Data(nullptr),
+      m_Size(0)
+{
+    const int file = open(i_Path.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        throw std::runtime_error("Can't open " + i_Path);
+    }
+    struct stat status;
+    if (0 != fstat(file, &status))
+    {
+        close(file);
+        throw std::runtime_error("Can't get the size of " + i_Path);
+    }
+    m_Size = static_cast<std::size_t>(status.st_size);
+
+    if (0 != m_Size)
+    {
+        m_Data = mmap(nullptr, m_Size, PROT_READ, MAP_SHARED, file, 0);
+    }
+    /// The mapping stays valid after the file is closed
+    close(file);
+    if (MAP_FAILED == m_Data)
+    {
+        m_Data = nullptr;
+        throw std::runtime_error("Can't map " + i_Path);
+    }
+}
+
+MappedFile::MappedFile(const std::string &i_Path, const std::size_t i_Size)
+    : m_Data(nullptr),
+      m_Size(0)
+{
+    const int file = open(i_Path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (file < 0)
+    {
+        throw std::runtime_error("Can't open " + i_Path);
+    }
+    struct stat status;
+    if (0 != fstat(file, &status))
+    {
+        close(file);
+        throw std::runtime_error("Can't get the size of " + i_Path);
+    }
+    m_Size = static_cast<std::size_t>(status.st_size);
+    if (m_Size < i_Size)
+    {
+        /// Not every file system can allocate blocks up front, growing the file still works
+        const int error = posix_fallocate(file, 0, static_cast<off_t>(i_Size));
+        if (0 != error && ((EINVAL != error && EOPNOTSUPP != error) || 0 != ftruncate(file, static_cast<off_t>(i_Size))))
+        {
+            close(file);
+            throw std::runtime_error("Can't grow " + i_Path);
+        }
+        m_Size = i_Size;
+    }
+
+    if (0 != m_Size)
+    {
+        m_Data = mmap(nullptr, m_Size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    }
+    close(file);
+    if (MAP_FAILED == m_Data)
+    {
+        m_Data = nullptr;
+        throw std::runtime_error("Can't map " + i_Path);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_Data)
+    {
+        munmap(m_Data, m_Size);
+    }
+}
+
+void MappedFile::sync(const std::size_t i_Offset, const std::size_t i_Length)
+{
+    if (0 == i_Length)
+    {
+        return;
+    }
+    /// msync() wants a page aligned start
+    static const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    const std::size_t start = i_Offset - i_Offset % pageSize;
+    if (0 != msync(static_cast<char *>(m_Data) + start, i_Offset + i_Length - start, MS_SYNC))
+    {
+        throw std::runtime_error("Can't write the mapped pages to the disk");
+    }
+}
+#endif
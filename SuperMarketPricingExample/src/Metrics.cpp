@@ -0,0 +1,326 @@
+// Local
+#include "Metrics.hpp"
+// Standard Library
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+std::atomic<bool> Metrics::s_Enabled(false);
+
+namespace
+{
+    ///@brief Position of the highest set bit
+    ///@pre i_Value != 0
+    unsigned highestBit(const std::uint64_t i_Value)
+    {
+#if defined(__GNUC__)
+        return 63 - __builtin_clzll(i_Value);
+#else
+        unsigned bit = 0;
+        for (std::uint64_t value = i_Value >> 1; 0 != value; value >>= 1)
+        {
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+
+    ///@brief Increment by the only thread that writes to i_Value. Readers may see a
+    /// slightly stale value but never a torn one, and no locked instruction is needed.
+    void bump(std::atomic<std::uint64_t> &io_Value, const std::uint64_t i_Amount)
+    {
+        io_Value.store(io_Value.load(std::memory_order_relaxed) + i_Amount, std::memory_order_relaxed);
+    }
+
+    ///@brief Histogram that one thread writes and any thread can read
+    struct SharedHistogram
+    {
+        std::atomic<std::uint64_t> buckets[Metrics::Histogram::NUMBER_OF_BUCKETS];
+        std::atomic<std::uint64_t> count;
+        std::atomic<std::uint64_t> sum;
+        std::atomic<std::uint64_t> max;
+    };
+
+    ///@brief Everything recorded by one thread. A shard outlives its thread, and is
+    /// handed to the next new thread, so the number of shards is bounded by the highest
+    /// number of threads that were recording at the same time.
+    struct alignas(64) Shard
+    {
+        std::atomic<std::uint64_t> counters[Metrics::NUMBER_OF_COUNTERS];
+        SharedHistogram timers[Metrics::NUMBER_OF_TIMERS];
+        /// Owned by a running thread
+        bool inUse;
+    };
+
+    ///@brief All shards ever created
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<Shard>> shards;
+    };
+
+    Registry &getRegistry()
+    {
+        /// Never destroyed, so threads that exit during static destruction can still
+        /// release their shard
+        static Registry *registry = new Registry();
+        return *registry;
+    }
+
+    ///@brief Claims a shard for the calling thread and gives it back when the thread exits
+    class ShardLease
+    {
+
+    public:
+        ShardLease()
+        {
+            Registry &registry = getRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            for (const auto &shard : registry.shards)
+            {
+                if (!shard->inUse)
+                {
+                    m_Shard = shard.get();
+                    m_Shard->inUse = true;
+                    return;
+                }
+            }
+            registry.shards.emplace_back(new Shard());
+            m_Shard = registry.shards.back().get();
+            m_Shard->inUse = true;
+        }
+        ~ShardLease()
+        {
+            Registry &registry = getRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            m_Shard->inUse = false;
+        }
+
+        Shard &get() const
+        {
+            return *m_Shard;
+        }
+
+    private:
+        Shard *m_Shard;
+    };
+
+    Shard &getLocalShard()
+    {
+        thread_local ShardLease lease;
+        return lease.get();
+    }
+
+    /// Names used in the text exposition, in enum order
+    const char *const COUNTER_NAMES[Metrics::NUMBER_OF_COUNTERS] = {
+        "scans",
+        "lookups",
+        "lookup_misses",
+        "bundle_matches",
+        "buy_x_get_y_applications",
+        "catalog_updates"};
+    const char *const TIMER_NAMES[Metrics::NUMBER_OF_TIMERS] = {
+        "scan",
+        "get_total",
+        "compile"};
+} // namespace
+
+// Histogram
+Metrics::Histogram::Histogram()
+    : m_Buckets(),
+      m_Count(0),
+      m_Sum(0),
+      m_Max(0)
+{
+}
+
+Metrics::Histogram::~Histogram()
+{
+}
+
+void Metrics::Histogram::record(const std::uint64_t i_Value)
+{
+    ++m_Buckets[getBucket(i_Value)];
+    ++m_Count;
+    m_Sum += i_Value;
+    m_Max = std::max(m_Max, i_Value);
+}
+
+void Metrics::Histogram::merge(const Histogram &i_Other)
+{
+    for (std::size_t bucket = 0; bucket < NUMBER_OF_BUCKETS; ++bucket)
+    {
+        m_Buckets[bucket] += i_Other.m_Buckets[bucket];
+    }
+    m_Count += i_Other.m_Count;
+    m_Sum += i_Other.m_Sum;
+    m_Max = std::max(m_Max, i_Other.m_Max);
+}
+
+std::uint64_t Metrics::Histogram::getPercentile(const double i_Fraction) const
+{
+    if (0 == m_Count)
+    {
+        return 0;
+    }
+    /// Rank of the value we are looking for, 1-based
+    const std::uint64_t rank = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(std::ceil(std::min(1.0, std::max(0.0, i_Fraction)) * m_Count)));
+    std::uint64_t seen = 0;
+    for (std::size_t bucket = 0; bucket < NUMBER_OF_BUCKETS; ++bucket)
+    {
+        seen += m_Buckets[bucket];
+        if (seen >= rank)
+        {
+            return std::min(getBucketHighest(bucket), m_Max);
+        }
+    }
+    return m_Max;
+}
+
+std::size_t Metrics::Histogram::getBucket(const std::uint64_t i_Value)
+{
+    if (i_Value < SUB_BUCKETS)
+    {
+        return static_cast<std::size_t>(i_Value);
+    }
+    /// The SUB_BUCKET_BITS bits after the highest set bit select the linear bucket
+    const unsigned exponent = highestBit(i_Value);
+    const std::size_t subBucket = static_cast<std::size_t>(i_Value >> (exponent - SUB_BUCKET_BITS)) - SUB_BUCKETS;
+    return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + subBucket;
+}
+
+std::uint64_t Metrics::Histogram::getBucketLowest(const std::size_t i_Bucket)
+{
+    if (i_Bucket < SUB_BUCKETS)
+    {
+        return i_Bucket;
+    }
+    const std::size_t group = i_Bucket / SUB_BUCKETS;
+    return static_cast<std::uint64_t>(SUB_BUCKETS + i_Bucket % SUB_BUCKETS) << (group - 1);
+}
+
+std::uint64_t Metrics::Histogram::getBucketHighest(const std::size_t i_Bucket)
+{
+    if (i_Bucket < SUB_BUCKETS)
+    {
+        return i_Bucket;
+    }
+    const std::size_t group = i_Bucket / SUB_BUCKETS;
+    return getBucketLowest(i_Bucket) + ((std::uint64_t(1) << (group - 1)) - 1);
+}
+// End of Histogram
+
+void Metrics::setEnabled(const bool i_Enabled)
+{
+    s_Enabled.store(i_Enabled, std::memory_order_relaxed);
+}
+
+void Metrics::add(const Counter i_Counter, const std::uint64_t i_Amount)
+{
+    bump(getLocalShard().counters[i_Counter], i_Amount);
+}
+
+void Metrics::record(const Timer i_Timer, const std::int64_t i_Nanoseconds)
+{
+    const std::uint64_t value = static_cast<std::uint64_t>(std::max<std::int64_t>(0, i_Nanoseconds));
+    SharedHistogram &histogram = getLocalShard().timers[i_Timer];
+    bump(histogram.buckets[Histogram::getBucket(value)], 1);
+    bump(histogram.count, 1);
+    bump(histogram.sum, value);
+    if (value > histogram.max.load(std::memory_order_relaxed))
+    {
+        histogram.max.store(value, std::memory_order_relaxed);
+    }
+}
+
+Metrics::Snapshot Metrics::snapshot()
+{
+    Snapshot snapshot;
+    snapshot.counters.fill(0);
+
+    Registry &registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const auto &shard : registry.shards)
+    {
+        for (int counter = 0; counter < NUMBER_OF_COUNTERS; ++counter)
+        {
+            snapshot.counters[counter] += shard->counters[counter].load(std::memory_order_relaxed);
+        }
+        for (int timer = 0; timer < NUMBER_OF_TIMERS; ++timer)
+        {
+            const SharedHistogram &shared = shard->timers[timer];
+            Histogram &histogram = snapshot.timers[timer];
+            for (std::size_t bucket = 0; bucket < Histogram::NUMBER_OF_BUCKETS; ++bucket)
+            {
+                histogram.m_Buckets[bucket] += shared.buckets[bucket].load(std::memory_order_relaxed);
+            }
+            histogram.m_Count += shared.count.load(std::memory_order_relaxed);
+            histogram.m_Sum += shared.sum.load(std::memory_order_relaxed);
+            histogram.m_Max = std::max(histogram.m_Max, shared.max.load(std::memory_order_relaxed));
+        }
+    }
+    return snapshot;
+}
+
+void Metrics::reset()
+{
+    Registry &registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const auto &shard : registry.shards)
+    {
+        for (auto &counter : shard->counters)
+        {
+            counter.store(0, std::memory_order_relaxed);
+        }
+        for (auto &shared : shard->timers)
+        {
+            for (auto &bucket : shared.buckets)
+            {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+            shared.count.store(0, std::memory_order_relaxed);
+            shared.sum.store(0, std::memory_order_relaxed);
+            shared.max.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+std::string Metrics::exportText(const Snapshot &i_Snapshot)
+{
+    static const double QUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+
+    std::ostringstream text;
+    for (int counter = 0; counter < NUMBER_OF_COUNTERS; ++counter)
+    {
+        const std::string name = std::string("supermarket_") + COUNTER_NAMES[counter] + "_total";
+        text << "# TYPE " << name << " counter\n"
+             << name << " " << i_Snapshot.counters[counter] << "\n";
+    }
+    for (int timer = 0; timer < NUMBER_OF_TIMERS; ++timer)
+    {
+        const std::string name = std::string("supermarket_") + TIMER_NAMES[timer] + "_duration_nanoseconds";
+        const Histogram &histogram = i_Snapshot.timers[timer];
+        text << "# TYPE " << name << " summary\n";
+        for (const double quantile : QUANTILES)
+        {
+            text << name << "{quantile=\"" << quantile << "\"} " << histogram.getPercentile(quantile) << "\n";
+        }
+        text << name << "_sum " << histogram.getSum() << "\n"
+             << name << "_count " << histogram.getCount() << "\n";
+    }
+    return text.str();
+}
+
+const char *Metrics::getName(const Counter i_Counter)
+{
+    return COUNTER_NAMES[i_Counter];
+}
+
+const char *Metrics::getName(const Timer i_Timer)
+{
+    return TIMER_NAMES[i_Timer];
+}
@@ -0,0 +1,36 @@
+// Local
+#include "Money.hpp"
+// Standard Library
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <ostream>
+
+Money Money::fromDollars(const double i_Dollars)
+{
+    return Money(std::llround(i_Dollars * 100));
+}
+
+std::ostream &operator<<(std::ostream &io_Stream, const Money i_Money)
+{
+    const std::int64_t cents = i_Money.getCents();
+    if (cents < 0)
+    {
+        io_Stream << '-';
+    }
+    const std::int64_t absoluteCents = std::llabs(cents);
+    return io_Stream << absoluteCents / 100 << '.'
+                     << std::setw(2) << std::setfill('0') << absoluteCents % 100 << std::setfill(' ');
+}
+
+std::ostream &operator<<(std::ostream &io_Stream, const TaxRate i_TaxRate)
+{
+    const std::int32_t basisPoints = i_TaxRate.getBasisPoints();
+    if (basisPoints < 0)
+    {
+        io_Stream << '-';
+    }
+    const std::int32_t absoluteBasisPoints = std::abs(basisPoints);
+    return io_Stream << absoluteBasisPoints / 100 << '.'
+                     << std::setw(2) << std::setfill('0') << absoluteBasisPoints % 100 << std::setfill(' ') << '%';
+}
@@ -0,0 +1,136 @@
+// Local
+#include "PricingOverlay.hpp"
+// Standard Library
+#include <algorithm>
+#include <memory>
+#include <variant>
+
+PricingOverlay::PricingOverlay()
+{
+}
+
+PricingOverlay::~PricingOverlay()
+{
+}
+
+void PricingOverlay::setUnitPrice(const std::string &i_ID, const Money i_UnitPrice)
+{
+    m_UnitPrices[i_ID] = i_UnitPrice;
+}
+
+void PricingOverlay::setPromotion(const std::string &i_ID, const Promotion &i_Promotion)
+{
+    validatePromotion(i_ID, i_Promotion);
+    m_Promotions.insert_or_assign(i_ID, i_Promotion);
+}
+
+std::size_t PricingOverlay::size() const
+{
+    std::size_t numberOfItems = m_UnitPrices.size();
+    for (const auto &promotion : m_Promotions)
+    {
+        numberOfItems += m_UnitPrices.count(promotion.first) ? 0 : 1;
+    }
+    return numberOfItems;
+}
+
+PricingTable PricingOverlay::compile(const PricingTable &i_Base) const
+{
+    std::vector<PricingTable::Index> changed;
+    return compile(i_Base, changed);
+}
+
+PricingTable PricingOverlay::compile(const PricingTable &i_Base, std::vector<PricingTable::Index> &o_Changed) const
+{
+    using Override = PricingTable::Override;
+    o_Changed.clear();
+
+    /// Starts from the base's overrides (if it has an overlay already)
+    std::map<PricingTable::Index, Override> rows;
+    if (i_Base.m_Overrides)
+    {
+        for (const Override &row : *i_Base.m_Overrides)
+        {
+            rows.emplace_hint(rows.end(), row.index, row);
+        }
+    }
+    const auto findRow = [&](const std::string &i_ID) -> Override * {
+        const PricingTable::Index index = i_Base.find(i_ID);
+        if (PricingTable::NO_INDEX == index)
+        {
+            return nullptr;
+        }
+        const auto it = rows.find(index);
+        if (rows.end() != it)
+        {
+            return &it->second;
+        }
+        /// The row starts as the base's data of the item
+        Override row = {index, static_cast<std::int32_t>(i_Base.getPromotionKind(index)), i_Base.getUnitPrice(index).getCents(), 0, 0, PricingTable::NO_INDEX, 0};
+        i_Base.visitPromotion(
+            index,
+            Overloaded{
+                [](const SimplePrice &) {},
+                [&](const BuyXGetY &i_Deal) {
+                    row.buyX = i_Deal.buyX;
+                    row.getY = i_Deal.getY;
+                },
+                [&](const PricingTable::BundleDeal &i_Deal) {
+                    row.bundlePartner = i_Deal.partner;
+                    row.bundlePrice = i_Deal.price.getCents();
+                }});
+        return &rows.emplace(index, row).first->second;
+    };
+
+    for (const auto &unitPrice : m_UnitPrices)
+    {
+        if (Override *row = findRow(unitPrice.first))
+        {
+            row->unitPrice = unitPrice.second.getCents();
+            o_Changed.push_back(row->index);
+        }
+    }
+    for (const auto &promotion : m_Promotions)
+    {
+        Override *row = findRow(promotion.first);
+        if (nullptr == row)
+        {
+            continue;
+        }
+        row->buyX = 0;
+        row->getY = 0;
+        row->bundlePartner = PricingTable::NO_INDEX;
+        row->bundlePrice = 0;
+        row->promotionKind = static_cast<std::int32_t>(PromotionKind::SIMPLE_PRICE);
+        std::visit(Overloaded{
+                       [](const SimplePrice &) {},
+                       [&](const BuyXGetY &i_Deal) {
+                           row->promotionKind = static_cast<std::int32_t>(PromotionKind::BUY_X_GET_Y);
+                           row->buyX = i_Deal.buyX;
+                           row->getY = i_Deal.getY;
+                       },
+                       [&](const Bundle &i_Deal) {
+                           /// A bundle with an item that isn't in the base can never be completed
+                           row->bundlePartner = i_Base.find(i_Deal.partnerId);
+                           if (PricingTable::NO_INDEX != row->bundlePartner)
+                           {
+                               row->promotionKind = static_cast<std::int32_t>(PromotionKind::BUNDLE);
+                               row->bundlePrice = i_Deal.price.getCents();
+                           }
+                       }},
+                   promotion.second);
+        o_Changed.push_back(row->index);
+    }
+    std::sort(o_Changed.begin(), o_Changed.end());
+    o_Changed.erase(std::unique(o_Changed.begin(), o_Changed.end()), o_Changed.end());
+
+    auto overrides = std::make_shared<std::vector<Override>>();
+    overrides->reserve(rows.size());
+    for (const auto &row : rows)
+    {
+        overrides->push_back(row.second);
+    }
+    PricingTable table = i_Base;
+    table.m_Overrides = std::move(overrides);
+    return table;
+}
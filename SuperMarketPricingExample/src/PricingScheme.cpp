@@ -1,7 +1,15 @@
 // Local
 #include "PricingScheme.hpp"
+#include <Metrics.hpp>
+// Standard Library
+#include <algorithm>
+#include <stdexcept>
+#include <string>
 
 PricingScheme::PricingScheme()
+    : m_Version(0),
+      m_TaxRates(),
+      m_JournalStart(0)
 {
 }
 
@@ -11,5 +19,217 @@ PricingScheme::~PricingScheme()
 
 void PricingScheme::addItem(const Item &i_Item)
 {
+    checkTaxClass(i_Item.getTaxClass());
+    setItem(i_Item, m_Version + 1);
+    ++m_Version;
+}
+
+void PricingScheme::removeItem(const std::string &i_ID)
+{
+    if (eraseItem(i_ID, m_Version + 1))
+    {
+        ++m_Version;
+    }
+}
+
+void PricingScheme::setTaxRate(const TaxClass i_TaxClass, const TaxRate i_TaxRate)
+{
+    checkTaxClass(i_TaxClass);
+    SMP_METRICS_COUNT(CATALOG_UPDATES);
+    m_TaxRates[i_TaxClass.getId()] = i_TaxRate;
+    ++m_Version;
+}
+
+void PricingScheme::schedulePromotion(const std::string &i_ID, const Promotion &i_Promotion, const PromotionWindow &i_Window)
+{
+    if (0 == m_ItemMap.count(i_ID))
+    {
+        throw std::runtime_error("Can't schedule a deal for " + i_ID + ", it isn't in the scheme");
+    }
+    validatePromotion(i_ID, i_Promotion);
+    const auto schedule = m_Schedules.find(i_ID);
+    checkWindow(m_Schedules.end() != schedule ? schedule->second : std::vector<std::pair<PromotionWindow, Promotion>>(), i_Window);
+    SMP_METRICS_COUNT(CATALOG_UPDATES);
+    m_Schedules[i_ID].emplace_back(i_Window, i_Promotion);
+    m_Journal.emplace_back(m_Version + 1, m_Indices.at(i_ID));
+    ++m_Version;
+}
+
+void PricingScheme::clearSchedule(const std::string &i_ID)
+{
+    if (0 == m_Schedules.erase(i_ID))
+    {
+        return;
+    }
+    SMP_METRICS_COUNT(CATALOG_UPDATES);
+    m_Journal.emplace_back(m_Version + 1, m_Indices.at(i_ID));
+    ++m_Version;
+}
+
+void PricingScheme::applyDelta(const Delta &i_Delta)
+{
+    for (const auto &item : i_Delta.items)
+    {
+        checkTaxClass(item.getTaxClass());
+    }
+    for (const auto &rate : i_Delta.taxRates)
+    {
+        checkTaxClass(rate.first);
+    }
+
+    bool isChanged = false;
+    for (const auto &rate : i_Delta.taxRates)
+    {
+        SMP_METRICS_COUNT(CATALOG_UPDATES);
+        m_TaxRates[rate.first.getId()] = rate.second;
+        isChanged = true;
+    }
+    for (const auto &item : i_Delta.items)
+    {
+        setItem(item, m_Version + 1);
+        isChanged = true;
+    }
+    for (const auto &id : i_Delta.removedIds)
+    {
+        isChanged = eraseItem(id, m_Version + 1) || isChanged;
+    }
+    if (isChanged)
+    {
+        ++m_Version;
+    }
+}
+
+bool PricingScheme::getChangesSince(const std::uint64_t i_Version, std::vector<PricingTable::Index> &o_Changed) const
+{
+    o_Changed.clear();
+    if (i_Version < m_JournalStart)
+    {
+        return false;
+    }
+    const auto first = std::upper_bound(
+        m_Journal.begin(), m_Journal.end(), i_Version,
+        [](const std::uint64_t i_Value, const std::pair<std::uint64_t, PricingTable::Index> &i_Change) {
+            return i_Value < i_Change.first;
+        });
+    for (auto it = first; m_Journal.end() != it; ++it)
+    {
+        o_Changed.push_back(it->second);
+    }
+    std::sort(o_Changed.begin(), o_Changed.end());
+    o_Changed.erase(std::unique(o_Changed.begin(), o_Changed.end()), o_Changed.end());
+    return true;
+}
+
+void PricingScheme::trimJournal(const std::uint64_t i_Version)
+{
+    const std::uint64_t version = std::min(i_Version, m_Version);
+    if (version <= m_JournalStart)
+    {
+        return;
+    }
+    const auto last = std::upper_bound(
+        m_Journal.begin(), m_Journal.end(), version,
+        [](const std::uint64_t i_Value, const std::pair<std::uint64_t, PricingTable::Index> &i_Change) {
+            return i_Value < i_Change.first;
+        });
+    m_Journal.erase(m_Journal.begin(), last);
+    m_JournalStart = version;
+}
+
+void PricingScheme::checkTaxClass(const TaxClass i_TaxClass)
+{
+    if (i_TaxClass.getId() >= TaxClass::COUNT)
+    {
+        throw std::runtime_error("Tax class " + std::to_string(i_TaxClass.getId()) + " is not in the tax table");
+    }
+}
+
+void PricingScheme::checkWindow(const std::vector<std::pair<PromotionWindow, Promotion>> &i_Schedule, const PromotionWindow &i_Window)
+{
+    if (i_Window.start >= i_Window.end ||
+        (0 != i_Window.period && (i_Window.period < i_Window.end - i_Window.start || i_Window.until <= i_Window.start)))
+    {
+        throw std::runtime_error("Promotion window is empty or repeats before it ends");
+    }
+    if (i_Window.getNumberOfOccurrences() > MAX_OCCURRENCES)
+    {
+        throw std::runtime_error("Promotion window repeats more than " + std::to_string(MAX_OCCURRENCES) + " times");
+    }
+
+    /// Occurrences of every window of the item, in order: no two may overlap
+    std::vector<std::pair<std::int64_t, std::int64_t>> occurrences;
+    const auto addOccurrence = [&](const std::int64_t i_Start, const std::int64_t i_End) {
+        occurrences.emplace_back(i_Start, i_End);
+    };
+    i_Window.forEachOccurrence(addOccurrence);
+    for (const auto &scheduled : i_Schedule)
+    {
+        scheduled.first.forEachOccurrence(addOccurrence);
+    }
+    std::sort(occurrences.begin(), occurrences.end());
+    for (std::size_t i = 1; i < occurrences.size(); ++i)
+    {
+        if (occurrences[i].first < occurrences[i - 1].second)
+        {
+            throw std::runtime_error("Promotion window overlaps a deal already scheduled for the item");
+        }
+    }
+}
+
+void PricingScheme::setItem(const Item &i_Item, const std::uint64_t i_Version)
+{
+    SMP_METRICS_COUNT(CATALOG_UPDATES);
     m_ItemMap[i_Item.getId()] = i_Item;
+
+    const auto index = m_Indices.emplace(i_Item.getId(), static_cast<PricingTable::Index>(m_Ids.size()));
+    if (index.second)
+    {
+        m_Ids.push_back(i_Item.getId());
+    }
+    m_Journal.emplace_back(i_Version, index.first->second);
+}
+
+bool PricingScheme::eraseItem(const std::string &i_ID, const std::uint64_t i_Version)
+{
+    if (0 == m_ItemMap.erase(i_ID))
+    {
+        return false;
+    }
+    m_Schedules.erase(i_ID);
+    SMP_METRICS_COUNT(CATALOG_UPDATES);
+    m_Journal.emplace_back(i_Version, m_Indices.at(i_ID));
+    return true;
+}
+
+PricingTable PricingScheme::compile() const
+{
+    SMP_METRICS_TIME(COMPILE);
+    std::vector<PricingTable::Entry> entries;
+    entries.reserve(m_Ids.size());
+    for (const auto &id : m_Ids)
+    {
+        const auto it = m_ItemMap.find(id);
+        if (m_ItemMap.end() == it)
+        {
+            entries.push_back({id, Money(0), TaxClass(), nullptr, nullptr});
+            continue;
+        }
+        const Item &item = it->second;
+        const auto schedule = m_Schedules.find(id);
+        /// Deals are divided into groups of buyX + getY units when priced
+        validatePromotion(id, item.getPromotion());
+        if (m_Schedules.end() != schedule)
+        {
+            for (const auto &scheduled : schedule->second)
+            {
+                validatePromotion(id, scheduled.second);
+            }
+        }
+        entries.push_back({id,
+                           item.getUnitPrice(),
+                           item.getTaxClass(),
+                           &item.getPromotion(),
+                           m_Schedules.end() != schedule ? &schedule->second : nullptr});
+    }
+    return PricingTable::build(m_Version, entries, m_TaxRates);
 }
\ No newline at end of file
@@ -0,0 +1,732 @@
+// Local
+#include "PricingTable.hpp"
+#include <Barcode.hpp>
+// Standard Library
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <variant>
+
+namespace
+{
+    ///@brief Rounds a size up to a multiple of 8 bytes
+    std::uint64_t align8(const std::uint64_t i_Size)
+    {
+        return (i_Size + 7) & ~std::uint64_t(7);
+    }
+
+    ///@brief splitmix64 finalizer, a bijection that mixes every bit into every other
+    std::uint64_t mix64(std::uint64_t i_Value)
+    {
+        i_Value = (i_Value ^ (i_Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        i_Value = (i_Value ^ (i_Value >> 27)) * 0x94D049BB133111EBull;
+        return i_Value ^ (i_Value >> 31);
+    }
+
+    /// Average # of keys per bucket of the barcode index
+    const std::uint64_t KEYS_PER_BUCKET = 3;
+    /// # of positions of the barcode index per 100 keys
+    const std::uint64_t POSITIONS_PER_100_KEYS = 101;
+    /// Pilots tried for one bucket before the index is rebuilt with another seed
+    const std::uint32_t MAX_PILOT = 1u << 22;
+} // namespace
+
+PricingTable::PricingTable()
+    : PricingTable(build(0, {}, {}))
+{
+}
+
+PricingTable::PricingTable(std::shared_ptr<const void> i_Storage, const Header *i_Header)
+    : m_Storage(std::move(i_Storage)),
+      m_Header(i_Header)
+{
+    const char *image = reinterpret_cast<const char *>(i_Header);
+    const std::uint64_t *offset = i_Header->sectionOffset;
+    m_UnitPrice = reinterpret_cast<const std::int64_t *>(image + offset[UNIT_PRICE]);
+    m_TaxClass = reinterpret_cast<const std::uint8_t *>(image + offset[TAX_CLASS]);
+    m_PromotionKind = reinterpret_cast<const std::int32_t *>(image + offset[PROMOTION_KIND]);
+    m_BuyX = reinterpret_cast<const std::int32_t *>(image + offset[BUY_X]);
+    m_GetY = reinterpret_cast<const std::int32_t *>(image + offset[GET_Y]);
+    m_BundlePartner = reinterpret_cast<const Index *>(image + offset[BUNDLE_PARTNER]);
+    m_BundlePrice = reinterpret_cast<const std::int64_t *>(image + offset[BUNDLE_PRICE]);
+    m_IdOffsets = reinterpret_cast<const std::uint32_t *>(image + offset[ID_OFFSETS]);
+    m_Slots = reinterpret_cast<const Index *>(image + offset[SLOTS]);
+    m_IdChars = image + offset[ID_CHARS];
+    m_BarcodePilots = reinterpret_cast<const std::uint32_t *>(image + offset[BARCODE_PILOTS]);
+    m_BarcodeKeys = reinterpret_cast<const std::uint64_t *>(image + offset[BARCODE_KEYS]);
+    m_BarcodeItems = reinterpret_cast<const Index *>(image + offset[BARCODE_ITEMS]);
+    m_BarcodeRemap = reinterpret_cast<const std::uint32_t *>(image + offset[BARCODE_REMAP]);
+    m_TaxRates = reinterpret_cast<const std::int32_t *>(image + offset[TAX_RATES]);
+    m_ScheduleOffsets = reinterpret_cast<const std::uint32_t *>(image + offset[SCHEDULE_OFFSETS]);
+    m_ScheduleStart = reinterpret_cast<const std::int64_t *>(image + offset[SCHEDULE_START]);
+    m_ScheduleEnd = reinterpret_cast<const std::int64_t *>(image + offset[SCHEDULE_END]);
+    m_ScheduleDeal = reinterpret_cast<const Index *>(image + offset[SCHEDULE_DEAL]);
+    m_ScheduleBoundaries = reinterpret_cast<const std::int64_t *>(image + offset[SCHEDULE_BOUNDARIES]);
+}
+
+PricingTable::~PricingTable()
+{
+}
+
+PricingTable PricingTable::fromImage(
+    std::shared_ptr<const void> i_Storage,
+    const void *i_Image,
+    const std::size_t i_ImageSize,
+    const bool i_VerifyChecksum)
+{
+    if (i_ImageSize < sizeof(Header) || 0 != reinterpret_cast<std::uintptr_t>(i_Image) % 8)
+    {
+        throw std::runtime_error("Pricing table image is truncated or misaligned");
+    }
+    const Header &header = *static_cast<const Header *>(i_Image);
+    if (0 != std::memcmp(header.magic, FORMAT_MAGIC, sizeof(FORMAT_MAGIC)))
+    {
+        throw std::runtime_error("Pricing table image has the wrong magic number");
+    }
+    if (BYTE_ORDER_MARK != header.byteOrderMark)
+    {
+        throw std::runtime_error("Pricing table image was built on a machine with a different byte order");
+    }
+    if (FORMAT_VERSION != header.formatVersion)
+    {
+        throw std::runtime_error("Pricing table image has unsupported format version " + std::to_string(header.formatVersion));
+    }
+    if (header.imageSize != i_ImageSize || 0 != header.imageSize % 8)
+    {
+        throw std::runtime_error("Pricing table image size doesn't match its header");
+    }
+    /// Lookups only terminate if there is at least one empty slot
+    if (header.numberOfItems >= NO_INDEX || header.numberOfSlots <= header.numberOfItems ||
+        0 != (header.numberOfSlots & (header.numberOfSlots - 1)))
+    {
+        throw std::runtime_error("Pricing table image has an invalid item count");
+    }
+    if (header.numberOfBarcodes > header.numberOfItems ||
+        header.numberOfBarcodePositions < header.numberOfBarcodes || header.numberOfBarcodePositions >= UINT32_MAX ||
+        (0 != header.numberOfBarcodes && (0 == header.numberOfBarcodeBuckets || header.numberOfBarcodeBuckets > header.numberOfBarcodes)))
+    {
+        throw std::runtime_error("Pricing table image has an invalid barcode count");
+    }
+    if (header.numberOfScheduledDeals >= NO_INDEX - header.numberOfItems ||
+        header.numberOfDealWindows >= UINT32_MAX || header.numberOfScheduleBoundaries > 2 * header.numberOfDealWindows)
+    {
+        throw std::runtime_error("Pricing table image has an invalid schedule size");
+    }
+    for (int section = 0; section < NUMBER_OF_SECTIONS; ++section)
+    {
+        const std::uint64_t offset = header.sectionOffset[section];
+        const std::uint64_t size = getSectionSize(static_cast<Section>(section), header);
+        if (0 != offset % 8 || offset < sizeof(Header) || offset > header.imageSize || size > header.imageSize - offset)
+        {
+            throw std::runtime_error("Pricing table image has a section out of bounds");
+        }
+    }
+    if (i_VerifyChecksum && computeChecksum(header) != header.checksum)
+    {
+        throw std::runtime_error("Pricing table image checksum mismatch");
+    }
+    /// Every section that indexes another one is checked even if the checksum isn't, so a
+    /// corrupt image is rejected rather than read out of bounds. Tax classes index the tax
+    /// table.
+    const auto *taxClass = reinterpret_cast<const std::uint8_t *>(static_cast<const char *>(i_Image) + header.sectionOffset[TAX_CLASS]);
+    if (std::any_of(taxClass, taxClass + header.numberOfItems, [](const std::uint8_t i_Class) { return i_Class >= TaxClass::COUNT; }))
+    {
+        throw std::runtime_error("Pricing table image has an invalid tax class");
+    }
+    /// The windows of each item and their deals index the promotions
+    const char *image = static_cast<const char *>(i_Image);
+    const auto *scheduleOffsets = reinterpret_cast<const std::uint32_t *>(image + header.sectionOffset[SCHEDULE_OFFSETS]);
+    const auto *scheduleDeal = reinterpret_cast<const Index *>(image + header.sectionOffset[SCHEDULE_DEAL]);
+    if (0 != scheduleOffsets[0] || header.numberOfDealWindows != scheduleOffsets[header.numberOfItems] ||
+        !std::is_sorted(scheduleOffsets, scheduleOffsets + header.numberOfItems + 1) ||
+        std::any_of(scheduleDeal, scheduleDeal + header.numberOfDealWindows, [&](const Index i_Deal) {
+            return i_Deal < header.numberOfItems || i_Deal - header.numberOfItems >= header.numberOfScheduledDeals;
+        }))
+    {
+        throw std::runtime_error("Pricing table image has an invalid schedule");
+    }
+    /// Buy X Get Y deals divide the units into groups of buyX + getY
+    const std::uint64_t numberOfDeals = header.numberOfItems + header.numberOfScheduledDeals;
+    const auto *promotionKind = reinterpret_cast<const std::int32_t *>(image + header.sectionOffset[PROMOTION_KIND]);
+    const auto *buyX = reinterpret_cast<const std::int32_t *>(image + header.sectionOffset[BUY_X]);
+    const auto *getY = reinterpret_cast<const std::int32_t *>(image + header.sectionOffset[GET_Y]);
+    for (std::uint64_t deal = 0; deal < numberOfDeals; ++deal)
+    {
+        if (static_cast<std::int32_t>(PromotionKind::BUY_X_GET_Y) == promotionKind[deal] && !BuyXGetY{buyX[deal], getY[deal]}.isValid())
+        {
+            throw std::runtime_error("Pricing table image has an invalid Buy X Get Y deal");
+        }
+    }
+    /// Bundle partners index the items
+    const auto *bundlePartner = reinterpret_cast<const Index *>(image + header.sectionOffset[BUNDLE_PARTNER]);
+    for (std::uint64_t deal = 0; deal < numberOfDeals; ++deal)
+    {
+        if (static_cast<std::int32_t>(PromotionKind::BUNDLE) == promotionKind[deal] && bundlePartner[deal] >= header.numberOfItems)
+        {
+            throw std::runtime_error("Pricing table image has an invalid bundle partner");
+        }
+    }
+    /// ID offsets index the ID characters, and slots the items. Lookups only terminate if
+    /// there is at least one empty slot.
+    const auto *idOffsets = reinterpret_cast<const std::uint32_t *>(image + header.sectionOffset[ID_OFFSETS]);
+    if (0 != idOffsets[0] || idOffsets[header.numberOfItems] > header.idCharsSize ||
+        !std::is_sorted(idOffsets, idOffsets + header.numberOfItems + 1))
+    {
+        throw std::runtime_error("Pricing table image has invalid ID offsets");
+    }
+    const auto *slots = reinterpret_cast<const Index *>(image + header.sectionOffset[SLOTS]);
+    if (std::none_of(slots, slots + header.numberOfSlots, [](const Index i_Index) { return NO_INDEX == i_Index; }) ||
+        std::any_of(slots, slots + header.numberOfSlots, [&](const Index i_Index) {
+            return NO_INDEX != i_Index && i_Index >= header.numberOfItems;
+        }))
+    {
+        throw std::runtime_error("Pricing table image has invalid slots");
+    }
+    /// Barcode entries index the items, remapping entries the barcode entries
+    const auto *barcodeItems = reinterpret_cast<const Index *>(image + header.sectionOffset[BARCODE_ITEMS]);
+    const auto *barcodeRemap = reinterpret_cast<const std::uint32_t *>(image + header.sectionOffset[BARCODE_REMAP]);
+    if (std::any_of(barcodeItems, barcodeItems + header.numberOfBarcodes, [&](const Index i_Index) { return i_Index >= header.numberOfItems; }) ||
+        std::any_of(barcodeRemap, barcodeRemap + (header.numberOfBarcodePositions - header.numberOfBarcodes), [&](const std::uint32_t i_Slot) {
+            return i_Slot >= header.numberOfBarcodes;
+        }))
+    {
+        throw std::runtime_error("Pricing table image has an invalid barcode index");
+    }
+
+    return PricingTable(std::move(i_Storage), &header);
+}
+
+PricingTable::Index PricingTable::find(std::string_view i_ID) const
+{
+    const std::size_t mask = m_Header->numberOfSlots - 1;
+    for (std::size_t slot = hashId(i_ID) & mask;; slot = (slot + 1) & mask)
+    {
+        const Index index = m_Slots[slot];
+        if (NO_INDEX == index || getId(index) == i_ID)
+        {
+            return index;
+        }
+    }
+}
+
+PricingTable::Index PricingTable::findBarcode(const std::uint64_t i_Key) const
+{
+    const std::uint64_t numberOfBarcodes = m_Header->numberOfBarcodes;
+    if (0 == numberOfBarcodes)
+    {
+        return NO_INDEX;
+    }
+    const std::uint64_t hash = hashBarcode(i_Key, m_Header->barcodeSeed);
+    const std::uint32_t pilot = m_BarcodePilots[getBarcodeBucket(hash, m_Header->numberOfBarcodeBuckets)];
+    std::uint64_t slot = getBarcodePosition(hash, pilot, m_Header->numberOfBarcodePositions);
+    if (slot >= numberOfBarcodes)
+    {
+        slot = m_BarcodeRemap[slot - numberOfBarcodes];
+    }
+    return i_Key == m_BarcodeKeys[slot] ? m_BarcodeItems[slot] : NO_INDEX;
+}
+
+const PricingTable::Override *PricingTable::searchOverrides(const Index i_Index) const
+{
+    const auto it = std::lower_bound(
+        m_Overrides->begin(), m_Overrides->end(), i_Index,
+        [](const Override &i_Override, const Index i_Value) { return i_Override.index < i_Value; });
+    return m_Overrides->end() != it && i_Index == it->index ? &*it : nullptr;
+}
+
+PricingTable::Index PricingTable::findScheduledDeal(
+    const Index i_Index,
+    const std::int64_t *i_Begin,
+    const std::int64_t *i_End,
+    const std::int64_t i_Time) const
+{
+    /// Last window that starts at or before i_Time, windows don't overlap
+    const std::int64_t *next = std::upper_bound(i_Begin, i_End, i_Time);
+    if (i_Begin == next)
+    {
+        return i_Index;
+    }
+    const std::size_t window = next - 1 - m_ScheduleStart;
+    return i_Time < m_ScheduleEnd[window] ? m_ScheduleDeal[window] : i_Index;
+}
+
+std::pair<std::int64_t, std::int64_t> PricingTable::getScheduleSegment(const std::int64_t i_Time) const
+{
+    const std::int64_t *begin = m_ScheduleBoundaries;
+    const std::int64_t *end = m_ScheduleBoundaries + m_Header->numberOfScheduleBoundaries;
+    const std::int64_t *next = std::upper_bound(begin, end, i_Time);
+    return {begin == next ? INT64_MIN : *(next - 1), end == next ? INT64_MAX : *next};
+}
+
+PricingTable::LineDetails PricingTable::describeLine(
+    const Index i_Index,
+    const Index i_Deal,
+    const int i_NumberOf,
+    const int i_Grams,
+    const int i_NumberOfPartner) const
+{
+    const Money unitPrice = getUnitPrice(i_Index);
+    LineDetails details = {0, 0, unitPrice * i_NumberOf, unitPrice.scale(i_Grams, 1000), Money(), Money(), Money(), Money()};
+
+    /// Units paid at the unit price, and what the deal costs on top of them
+    Money costOfDeals;
+    const int numberOfPaidUnits = visitPromotion(
+        i_Deal,
+        Overloaded{
+            [&](const SimplePrice &) {
+                return i_NumberOf;
+            },
+            [&](const BuyXGetY &i_Deal) {
+                const int numberOfPaidUnits = countPaidUnits(i_Deal, i_NumberOf);
+                details.numberOfFreeUnits = i_NumberOf - numberOfPaidUnits;
+                details.freeSavings = unitPrice * details.numberOfFreeUnits;
+                return numberOfPaidUnits;
+            },
+            [&](const BundleDeal &i_Deal) {
+                const int numberOfBundles = std::min(i_NumberOf, i_NumberOfPartner);
+                details.numberOfBundles = numberOfBundles;
+                if (i_Index < i_Deal.partner && numberOfBundles > 0)
+                {
+                    costOfDeals = i_Deal.price * numberOfBundles;
+                    details.bundleSavings = (unitPrice + getUnitPrice(i_Deal.partner)) * numberOfBundles - costOfDeals;
+                }
+                return i_NumberOf - numberOfBundles;
+            }});
+
+    details.taxableCost = unitPrice * numberOfPaidUnits + details.weightCost;
+    details.total = details.taxableCost + costOfDeals;
+    return details;
+}
+
+int PricingTable::countPaidUnits(const BuyXGetY &i_Deal, const int i_NumberOf)
+{
+    /// Every complete deal is buyX paid + getY free. Of the remaining items, up to buyX
+    /// are paid for and any beyond that are free (the customer forgot to grab them).
+    const int numberOfDeals = i_NumberOf / (i_Deal.buyX + i_Deal.getY);
+    const int numberOfRemaining = i_NumberOf % (i_Deal.buyX + i_Deal.getY);
+    return numberOfDeals * i_Deal.buyX + std::min(numberOfRemaining, i_Deal.buyX);
+}
+
+std::uint32_t PricingTable::hashId(std::string_view i_ID)
+{
+    std::uint32_t hash = 2166136261u;
+    for (const char c : i_ID)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+std::uint64_t PricingTable::hashBarcode(const std::uint64_t i_Key, const std::uint64_t i_Seed)
+{
+    return mix64(i_Key ^ mix64(i_Seed));
+}
+
+std::uint64_t PricingTable::getBarcodeBucket(const std::uint64_t i_Hash, const std::uint64_t i_NumberOfBuckets)
+{
+    /// Multiply and shift maps the high 32 bits onto [0, i_NumberOfBuckets) without a division
+    return ((i_Hash >> 32) * i_NumberOfBuckets) >> 32;
+}
+
+std::uint64_t PricingTable::getBarcodePosition(const std::uint64_t i_Hash, const std::uint32_t i_Pilot, const std::uint64_t i_NumberOfPositions)
+{
+    return ((mix64(i_Hash ^ (i_Pilot * 0x9E3779B97F4A7C15ull)) >> 32) * i_NumberOfPositions) >> 32;
+}
+
+std::uint64_t PricingTable::buildBarcodeIndex(
+    const std::vector<std::pair<std::uint64_t, Index>> &i_Barcodes,
+    const Header &i_Header,
+    std::uint32_t *o_Pilots,
+    std::uint64_t *o_Keys,
+    Index *o_Items,
+    std::uint32_t *o_Remap)
+{
+    const std::uint64_t numberOfKeys = i_Header.numberOfBarcodes;
+    const std::uint64_t numberOfBuckets = i_Header.numberOfBarcodeBuckets;
+    const std::uint64_t numberOfPositions = i_Header.numberOfBarcodePositions;
+    std::vector<std::uint64_t> hashes(numberOfKeys);
+    std::vector<std::uint32_t> bucketStart(numberOfBuckets + 1);
+    std::vector<std::uint32_t> keysByBucket(numberOfKeys);
+    std::vector<std::uint32_t> buckets(numberOfBuckets);
+    std::vector<bool> isTaken(numberOfPositions);
+    std::vector<std::uint64_t> positions;
+    /// Key at each position
+    std::vector<std::uint32_t> keyAt(numberOfPositions);
+    for (std::uint64_t seed = 0;; ++seed)
+    {
+        /// Groups the keys by bucket (counting sort)
+        std::fill(bucketStart.begin(), bucketStart.end(), 0);
+        for (std::uint64_t key = 0; key < numberOfKeys; ++key)
+        {
+            hashes[key] = hashBarcode(i_Barcodes[key].first, seed);
+            ++bucketStart[getBarcodeBucket(hashes[key], numberOfBuckets) + 1];
+        }
+        for (std::uint64_t bucket = 0; bucket < numberOfBuckets; ++bucket)
+        {
+            bucketStart[bucket + 1] += bucketStart[bucket];
+        }
+        std::vector<std::uint32_t> next(bucketStart.begin(), bucketStart.end() - 1);
+        for (std::uint64_t key = 0; key < numberOfKeys; ++key)
+        {
+            keysByBucket[next[getBarcodeBucket(hashes[key], numberOfBuckets)]++] = static_cast<std::uint32_t>(key);
+        }
+        for (std::uint64_t bucket = 0; bucket < numberOfBuckets; ++bucket)
+        {
+            buckets[bucket] = static_cast<std::uint32_t>(bucket);
+        }
+        std::stable_sort(buckets.begin(), buckets.end(), [&](const std::uint32_t i_Left, const std::uint32_t i_Right) {
+            return bucketStart[i_Left + 1] - bucketStart[i_Left] > bucketStart[i_Right + 1] - bucketStart[i_Right];
+        });
+
+        std::fill(isTaken.begin(), isTaken.end(), false);
+        std::fill(o_Pilots, o_Pilots + numberOfBuckets, 0);
+        bool isPlaced = true;
+        for (const std::uint32_t bucket : buckets)
+        {
+            const std::uint32_t *begin = keysByBucket.data() + bucketStart[bucket];
+            const std::uint32_t *end = keysByBucket.data() + bucketStart[bucket + 1];
+            if (begin == end)
+            {
+                break;
+            }
+            std::uint32_t pilot = 0;
+            for (; pilot < MAX_PILOT; ++pilot)
+            {
+                positions.clear();
+                for (const std::uint32_t *key = begin; key < end; ++key)
+                {
+                    const std::uint64_t position = getBarcodePosition(hashes[*key], pilot, numberOfPositions);
+                    if (isTaken[position] || positions.end() != std::find(positions.begin(), positions.end(), position))
+                    {
+                        break;
+                    }
+                    positions.push_back(position);
+                }
+                if (positions.size() == static_cast<std::size_t>(end - begin))
+                {
+                    break;
+                }
+            }
+            if (MAX_PILOT == pilot)
+            {
+                isPlaced = false;
+                break;
+            }
+            o_Pilots[bucket] = pilot;
+            for (std::size_t i = 0; i < positions.size(); ++i)
+            {
+                isTaken[positions[i]] = true;
+                keyAt[positions[i]] = begin[i];
+            }
+        }
+        if (!isPlaced)
+        {
+            continue;
+        }
+
+        /// Keys past the last slot move to the slots that are free, in order. Remap
+        /// entries of free positions are never used by a key in the index.
+        std::fill(o_Remap, o_Remap + (numberOfPositions - numberOfKeys), 0);
+        std::uint64_t freeSlot = 0;
+        for (std::uint64_t position = 0; position < numberOfPositions; ++position)
+        {
+            if (!isTaken[position])
+            {
+                continue;
+            }
+            std::uint64_t slot = position;
+            if (position >= numberOfKeys)
+            {
+                while (isTaken[freeSlot])
+                {
+                    ++freeSlot;
+                }
+                slot = freeSlot++;
+                o_Remap[position - numberOfKeys] = static_cast<std::uint32_t>(slot);
+            }
+            o_Keys[slot] = i_Barcodes[keyAt[position]].first;
+            o_Items[slot] = i_Barcodes[keyAt[position]].second;
+        }
+        return seed;
+    }
+}
+
+PricingTable PricingTable::build(
+    const std::uint64_t i_Version,
+    const std::vector<Entry> &i_Entries,
+    const std::array<TaxRate, TaxClass::COUNT> &i_TaxRates)
+{
+    const std::size_t numberOfItems = i_Entries.size();
+
+    /// Items that can be scanned by barcode. Different IDs can be the same GTIN (e.g., with
+    /// and without leading zeros), the item with the lower index gets the barcode.
+    std::vector<std::pair<std::uint64_t, Index>> barcodes;
+    for (Index index = 0; index < numberOfItems; ++index)
+    {
+        std::uint64_t key = 0;
+        if (nullptr != i_Entries[index].promotion && Barcode::toKey(i_Entries[index].id, key))
+        {
+            barcodes.emplace_back(key, index);
+        }
+    }
+    std::sort(barcodes.begin(), barcodes.end());
+    barcodes.erase(
+        std::unique(barcodes.begin(), barcodes.end(), [](const auto &i_Left, const auto &i_Right) { return i_Left.first == i_Right.first; }),
+        barcodes.end());
+
+    /// Promotion of every deal: the items' own, then the scheduled deals, which are in
+    /// effect during every occurrence of their window
+    std::vector<const Promotion *> promotions;
+    std::vector<DealWindow> windows;
+    promotions.reserve(numberOfItems);
+    for (const auto &entry : i_Entries)
+    {
+        promotions.push_back(entry.promotion);
+    }
+    for (Index index = 0; index < numberOfItems; ++index)
+    {
+        if (nullptr == i_Entries[index].schedule)
+        {
+            continue;
+        }
+        for (const auto &scheduled : *i_Entries[index].schedule)
+        {
+            const Index deal = static_cast<Index>(promotions.size());
+            promotions.push_back(&scheduled.second);
+            scheduled.first.forEachOccurrence([&](const std::int64_t i_Start, const std::int64_t i_End) {
+                windows.push_back({i_Start, i_End, index, deal});
+            });
+        }
+    }
+    std::sort(windows.begin(), windows.end(), [](const DealWindow &i_Left, const DealWindow &i_Right) {
+        return i_Left.index != i_Right.index ? i_Left.index < i_Right.index : i_Left.start < i_Right.start;
+    });
+    /// Every start and end once, in order
+    std::vector<std::int64_t> boundaries;
+    boundaries.reserve(2 * windows.size());
+    for (const auto &window : windows)
+    {
+        boundaries.push_back(window.start);
+        boundaries.push_back(window.end);
+    }
+    std::sort(boundaries.begin(), boundaries.end());
+    boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, FORMAT_MAGIC, sizeof(FORMAT_MAGIC));
+    header.byteOrderMark = BYTE_ORDER_MARK;
+    header.formatVersion = FORMAT_VERSION;
+    header.catalogVersion = i_Version;
+    header.numberOfItems = numberOfItems;
+    /// Keep the load factor at or below 50% so probe sequences stay short
+    header.numberOfSlots = 16;
+    while (header.numberOfSlots < numberOfItems * 2)
+    {
+        header.numberOfSlots *= 2;
+    }
+    for (const auto &entry : i_Entries)
+    {
+        header.idCharsSize += entry.id.size();
+    }
+    header.numberOfBarcodes = barcodes.size();
+    header.numberOfBarcodeBuckets = (barcodes.size() + KEYS_PER_BUCKET - 1) / KEYS_PER_BUCKET;
+    header.numberOfBarcodePositions = (barcodes.size() * POSITIONS_PER_100_KEYS + 99) / 100;
+    header.numberOfScheduledDeals = promotions.size() - numberOfItems;
+    header.numberOfDealWindows = windows.size();
+    header.numberOfScheduleBoundaries = boundaries.size();
+    std::uint64_t offset = align8(sizeof(Header));
+    for (int section = 0; section < NUMBER_OF_SECTIONS; ++section)
+    {
+        header.sectionOffset[section] = offset;
+        offset = align8(offset + getSectionSize(static_cast<Section>(section), header));
+    }
+    header.imageSize = offset;
+
+    /// Words rather than bytes so the image is 8-byte aligned
+    auto storage = std::make_shared<std::vector<std::uint64_t>>(header.imageSize / 8);
+    char *image = reinterpret_cast<char *>(storage->data());
+    std::memcpy(image, &header, sizeof(header));
+    const std::uint64_t *sectionOffset = header.sectionOffset;
+    auto *unitPrice = reinterpret_cast<std::int64_t *>(image + sectionOffset[UNIT_PRICE]);
+    auto *taxClass = reinterpret_cast<std::uint8_t *>(image + sectionOffset[TAX_CLASS]);
+    auto *promotionKind = reinterpret_cast<std::int32_t *>(image + sectionOffset[PROMOTION_KIND]);
+    auto *buyX = reinterpret_cast<std::int32_t *>(image + sectionOffset[BUY_X]);
+    auto *getY = reinterpret_cast<std::int32_t *>(image + sectionOffset[GET_Y]);
+    auto *bundlePartner = reinterpret_cast<Index *>(image + sectionOffset[BUNDLE_PARTNER]);
+    auto *bundlePrice = reinterpret_cast<std::int64_t *>(image + sectionOffset[BUNDLE_PRICE]);
+    auto *idOffsets = reinterpret_cast<std::uint32_t *>(image + sectionOffset[ID_OFFSETS]);
+    auto *slots = reinterpret_cast<Index *>(image + sectionOffset[SLOTS]);
+    char *idChars = image + sectionOffset[ID_CHARS];
+    auto *barcodePilots = reinterpret_cast<std::uint32_t *>(image + sectionOffset[BARCODE_PILOTS]);
+    auto *barcodeKeys = reinterpret_cast<std::uint64_t *>(image + sectionOffset[BARCODE_KEYS]);
+    auto *barcodeItems = reinterpret_cast<Index *>(image + sectionOffset[BARCODE_ITEMS]);
+    auto *barcodeRemap = reinterpret_cast<std::uint32_t *>(image + sectionOffset[BARCODE_REMAP]);
+    auto *taxRates = reinterpret_cast<std::int32_t *>(image + sectionOffset[TAX_RATES]);
+    auto *scheduleOffsets = reinterpret_cast<std::uint32_t *>(image + sectionOffset[SCHEDULE_OFFSETS]);
+    auto *scheduleStart = reinterpret_cast<std::int64_t *>(image + sectionOffset[SCHEDULE_START]);
+    auto *scheduleEnd = reinterpret_cast<std::int64_t *>(image + sectionOffset[SCHEDULE_END]);
+    auto *scheduleDeal = reinterpret_cast<Index *>(image + sectionOffset[SCHEDULE_DEAL]);
+    auto *scheduleBoundaries = reinterpret_cast<std::int64_t *>(image + sectionOffset[SCHEDULE_BOUNDARIES]);
+
+    for (std::size_t rate = 0; rate < TaxClass::COUNT; ++rate)
+    {
+        taxRates[rate] = i_TaxRates[rate].getBasisPoints();
+    }
+    for (Index deal = 0; deal < promotions.size(); ++deal)
+    {
+        bundlePartner[deal] = NO_INDEX;
+        if (nullptr == promotions[deal])
+        {
+            promotionKind[deal] = static_cast<std::int32_t>(PromotionKind::SIMPLE_PRICE);
+            continue;
+        }
+        std::visit(Overloaded{
+                       [&](const SimplePrice &) {
+                           promotionKind[deal] = static_cast<std::int32_t>(PromotionKind::SIMPLE_PRICE);
+                       },
+                       [&](const BuyXGetY &i_Deal) {
+                           promotionKind[deal] = static_cast<std::int32_t>(PromotionKind::BUY_X_GET_Y);
+                           buyX[deal] = i_Deal.buyX;
+                           getY[deal] = i_Deal.getY;
+                       },
+                       [&](const Bundle &i_Deal) {
+                           /// The partner is resolved below, once every ID has an index
+                           promotionKind[deal] = static_cast<std::int32_t>(PromotionKind::BUNDLE);
+                           bundlePrice[deal] = i_Deal.price.getCents();
+                       }},
+                   *promotions[deal]);
+    }
+    buildSchedule(windows, header, scheduleOffsets, scheduleStart, scheduleEnd, scheduleDeal);
+    std::copy(boundaries.begin(), boundaries.end(), scheduleBoundaries);
+    idOffsets[0] = 0;
+    for (Index index = 0; index < numberOfItems; ++index)
+    {
+        const Entry &entry = i_Entries[index];
+        unitPrice[index] = entry.unitPrice.getCents();
+        taxClass[index] = entry.taxClass.getId();
+        std::memcpy(idChars + idOffsets[index], entry.id.data(), entry.id.size());
+        idOffsets[index + 1] = static_cast<std::uint32_t>(idOffsets[index] + entry.id.size());
+    }
+
+    const std::size_t mask = header.numberOfSlots - 1;
+    std::fill(slots, slots + header.numberOfSlots, NO_INDEX);
+    for (Index index = 0; index < numberOfItems; ++index)
+    {
+        if (nullptr == i_Entries[index].promotion)
+        {
+            continue;
+        }
+        std::size_t slot = hashId(i_Entries[index].id) & mask;
+        while (NO_INDEX != slots[slot])
+        {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = index;
+    }
+
+    reinterpret_cast<Header *>(image)->barcodeSeed = buildBarcodeIndex(barcodes, header, barcodePilots, barcodeKeys, barcodeItems, barcodeRemap);
+
+    PricingTable table(storage, reinterpret_cast<const Header *>(image));
+
+    /// Bundle partners can only be resolved once every ID has an index. A bundle with an
+    /// item that isn't in the table can never be completed, so it becomes SimplePrice.
+    for (Index deal = 0; deal < promotions.size(); ++deal)
+    {
+        if (const Bundle *bundle = std::get_if<Bundle>(promotions[deal]))
+        {
+            bundlePartner[deal] = table.find(bundle->partnerId);
+            if (NO_INDEX == bundlePartner[deal])
+            {
+                promotionKind[deal] = static_cast<std::int32_t>(PromotionKind::SIMPLE_PRICE);
+                bundlePrice[deal] = 0;
+            }
+        }
+    }
+
+    reinterpret_cast<Header *>(image)->checksum = computeChecksum(*table.m_Header);
+    return table;
+}
+
+void PricingTable::buildSchedule(
+    const std::vector<DealWindow> &i_Windows,
+    const Header &i_Header,
+    std::uint32_t *o_Offsets,
+    std::int64_t *o_Start,
+    std::int64_t *o_End,
+    Index *o_Deals)
+{
+    std::size_t window = 0;
+    for (Index index = 0; index < i_Header.numberOfItems; ++index)
+    {
+        o_Offsets[index] = static_cast<std::uint32_t>(window);
+        for (; window < i_Windows.size() && index == i_Windows[window].index; ++window)
+        {
+            o_Start[window] = i_Windows[window].start;
+            o_End[window] = i_Windows[window].end;
+            o_Deals[window] = i_Windows[window].deal;
+        }
+    }
+    o_Offsets[i_Header.numberOfItems] = static_cast<std::uint32_t>(window);
+}
+
+std::uint64_t PricingTable::getSectionSize(const Section i_Section, const Header &i_Header)
+{
+    const std::uint64_t numberOfItems = i_Header.numberOfItems;
+    switch (i_Section)
+    {
+    case UNIT_PRICE:
+        return numberOfItems * sizeof(std::int64_t);
+    case BUNDLE_PRICE:
+        return (numberOfItems + i_Header.numberOfScheduledDeals) * sizeof(std::int64_t);
+    case TAX_CLASS:
+        return numberOfItems * sizeof(std::uint8_t);
+    case PROMOTION_KIND:
+    case BUY_X:
+    case GET_Y:
+        return (numberOfItems + i_Header.numberOfScheduledDeals) * sizeof(std::int32_t);
+    case BUNDLE_PARTNER:
+        return (numberOfItems + i_Header.numberOfScheduledDeals) * sizeof(Index);
+    case ID_OFFSETS:
+        return (numberOfItems + 1) * sizeof(std::uint32_t);
+    case SLOTS:
+        return i_Header.numberOfSlots * sizeof(Index);
+    case ID_CHARS:
+        return i_Header.idCharsSize;
+    case BARCODE_PILOTS:
+        return i_Header.numberOfBarcodeBuckets * sizeof(std::uint32_t);
+    case BARCODE_KEYS:
+        return i_Header.numberOfBarcodes * sizeof(std::uint64_t);
+    case BARCODE_ITEMS:
+        return i_Header.numberOfBarcodes * sizeof(Index);
+    case BARCODE_REMAP:
+        return (i_Header.numberOfBarcodePositions - i_Header.numberOfBarcodes) * sizeof(std::uint32_t);
+    case TAX_RATES:
+        return TaxClass::COUNT * sizeof(std::int32_t);
+    case SCHEDULE_OFFSETS:
+        return (numberOfItems + 1) * sizeof(std::uint32_t);
+    case SCHEDULE_START:
+    case SCHEDULE_END:
+        return i_Header.numberOfDealWindows * sizeof(std::int64_t);
+    case SCHEDULE_DEAL:
+        return i_Header.numberOfDealWindows * sizeof(Index);
+    case SCHEDULE_BOUNDARIES:
+        return i_Header.numberOfScheduleBoundaries * sizeof(std::int64_t);
+    default:
+        return 0;
+    }
+}
+
+std::uint64_t PricingTable::computeChecksum(const Header &i_Header)
+{
+    const std::uint64_t *begin = reinterpret_cast<const std::uint64_t *>(&i_Header);
+    std::uint64_t checksum = 14695981039346656037ull;
+    for (const std::uint64_t *word = begin + align8(sizeof(Header)) / 8; word < begin + i_Header.imageSize / 8; ++word)
+    {
+        checksum ^= *word;
+        checksum *= 1099511628211ull;
+    }
+    return checksum;
+}
@@ -0,0 +1,13 @@
+// Local
+#include "Promotion.hpp"
+// Standard Library
+#include <stdexcept>
+
+void validatePromotion(const std::string &i_ID, const Promotion &i_Promotion)
+{
+    const BuyXGetY *deal = std::get_if<BuyXGetY>(&i_Promotion);
+    if (deal && !deal->isValid())
+    {
+        throw std::runtime_error("Buy X Get Y deal of " + i_ID + " needs buyX > 0 and getY >= 0");
+    }
+}
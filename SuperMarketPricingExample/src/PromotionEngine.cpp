@@ -0,0 +1,470 @@
+// Local
+#include "PromotionEngine.hpp"
+#include <Promotion.hpp>
+// Standard Library
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+///@brief Units left in the cart, the deals applied to them so far and the best set of
+/// deals found. Lines are the distinct items of the cart, sorted by index.
+class PromotionEngine::Search
+{
+
+public:
+    Search(const PricingTable &i_Table,
+           const std::vector<CompiledRule> &i_Rules,
+           const std::vector<std::string> &i_Cart,
+           const std::int64_t i_Time,
+           const std::chrono::steady_clock::time_point i_Deadline)
+        : m_Table(i_Table),
+          m_Deadline(i_Deadline),
+          m_DealCost(0),
+          m_RemainingCost(0),
+          m_Taxable(),
+          m_LowerBound(0),
+          m_BestCost(0),
+          m_NumberOfNodes(0),
+          m_TimedOut(false)
+    {
+        std::vector<PricingTable::Index> scans;
+        scans.reserve(i_Cart.size());
+        for (const auto &id : i_Cart)
+        {
+            const PricingTable::Index index = m_Table.find(id);
+            if (PricingTable::NO_INDEX != index)
+            {
+                scans.push_back(index);
+            }
+        }
+        std::sort(scans.begin(), scans.end());
+        for (const PricingTable::Index index : scans)
+        {
+            if (m_Lines.empty() || m_Lines.back().index != index)
+            {
+                const PricingTable::Index deal = m_Table.findDeal(index, i_Time);
+                m_Lines.push_back({index, deal, 0, Money(0), Money(0), -1, getOwnLowerBound(index, deal)});
+            }
+            ++m_Lines.back().remaining;
+        }
+        for (auto &line : m_Lines)
+        {
+            line.partner = findLine(m_Table.findBundlePartner(line.index, line.deal, i_Time));
+        }
+
+        /// Only keep the eligible items that are in the cart, and rules that could apply
+        for (std::size_t rule = 0; rule < i_Rules.size(); ++rule)
+        {
+            const CompiledRule &compiled = i_Rules[rule];
+            Rule cartRule = {rule, {}, compiled.quantity, compiled.price, 0};
+            bool isPossible = true;
+            for (std::size_t slot = 0; slot < compiled.eligible.size(); ++slot)
+            {
+                std::vector<int> lines;
+                int numberOfUnits = 0;
+                for (const PricingTable::Index index : compiled.eligible[slot])
+                {
+                    const int line = findLine(index);
+                    if (line >= 0)
+                    {
+                        lines.push_back(line);
+                        numberOfUnits += m_Lines[line].remaining;
+                    }
+                }
+                isPossible = isPossible && numberOfUnits >= compiled.quantity[slot];
+                cartRule.numberOfUnits += compiled.quantity[slot];
+                cartRule.eligible.push_back(std::move(lines));
+            }
+            if (!isPossible)
+            {
+                continue;
+            }
+            for (const auto &lines : cartRule.eligible)
+            {
+                for (const int line : lines)
+                {
+                    m_Lines[line].unitLowerBound = std::min(m_Lines[line].unitLowerBound, compiled.pricePerUnit, lessMoney);
+                }
+            }
+            m_Rules.push_back(std::move(cartRule));
+        }
+
+        for (std::size_t line = 0; line < m_Lines.size(); ++line)
+        {
+            repriceLine(line);
+            m_LowerBound += m_Lines[line].unitLowerBound * m_Lines[line].remaining;
+        }
+    }
+
+    ///@brief Greedy assignment, then (if i_Search) branch and bound from there
+    Result run(const bool i_Search)
+    {
+        runGreedy();
+        if (i_Search)
+        {
+            std::vector<int> noChoice;
+            explore(0, noChoice);
+        }
+
+        Result result;
+        result.total = m_BestCost;
+        result.isOptimal = i_Search && !m_TimedOut;
+        result.numberOfNodes = m_NumberOfNodes;
+        for (const auto &deal : m_BestDeals)
+        {
+            result.deals.push_back({m_Rules[deal.rule].rule, {}});
+            for (const int line : deal.lines)
+            {
+                result.deals.back().items.push_back(m_Lines[line].index);
+            }
+        }
+        return result;
+    }
+
+private:
+    struct Line
+    {
+        PricingTable::Index index;
+        /// Deal of the item at the pricing time (see PricingTable::findDeal)
+        PricingTable::Index deal;
+        /// Units not used by a deal
+        int remaining;
+        /// Price of the remaining units before tax (see PricingTable::priceLine)
+        Money cost;
+        /// Part of the cost taxed at the item's tax class
+        Money taxableCost;
+        /// Line of the bundle partner, -1 if none
+        int partner;
+        /// Lowest price a unit can end up costing, in a deal or not
+        Money unitLowerBound;
+    };
+
+    ///@brief Rule that can apply to this cart, eligible items as lines
+    struct Rule
+    {
+        /// Position in the engine's rules
+        std::size_t rule;
+        std::vector<std::vector<int>> eligible;
+        std::vector<int> quantity;
+        Money price;
+        int numberOfUnits;
+    };
+
+    ///@brief Deal applied to the cart
+    struct Deal
+    {
+        std::size_t rule;
+        /// Line of each unit used
+        std::vector<int> lines;
+    };
+
+    static bool lessMoney(const Money i_Left, const Money i_Right)
+    {
+        return i_Left < i_Right;
+    }
+
+    int findLine(const PricingTable::Index i_Index) const
+    {
+        const auto it = std::lower_bound(
+            m_Lines.begin(), m_Lines.end(), i_Index,
+            [](const Line &i_Line, const PricingTable::Index i_Value) { return i_Line.index < i_Value; });
+        return m_Lines.end() != it && it->index == i_Index ? static_cast<int>(it - m_Lines.begin()) : -1;
+    }
+
+    ///@brief Lowest price a unit of the item can cost outside a deal
+    Money getOwnLowerBound(const PricingTable::Index i_Index, const PricingTable::Index i_Deal) const
+    {
+        const std::int64_t unitPrice = m_Table.getUnitPrice(i_Index).getCents();
+        return m_Table.visitPromotion(
+            i_Deal,
+            Overloaded{
+                [&](const SimplePrice &) {
+                    /// Tax is rounded once per class, so never below the sum of each unit's
+                    /// tax rounded down
+                    return Money(unitPrice + unitPrice * m_Table.getTax(i_Index).getBasisPoints() / 10000);
+                },
+                [&](const BuyXGetY &i_Deal) {
+                    return Money(unitPrice * i_Deal.buyX / (i_Deal.buyX + i_Deal.getY));
+                },
+                [](const PricingTable::BundleDeal &) {
+                    /// The partner's line may carry the whole bundle price
+                    return Money(0);
+                }});
+    }
+
+    ///@brief Reprices the remaining units of a line and applies the difference to the
+    /// remaining cost, which includes the tax of the taxable amount of each class
+    void repriceLine(const std::size_t i_Line)
+    {
+        Line &line = m_Lines[i_Line];
+        const int numberOfPartner = line.partner >= 0 ? m_Lines[line.partner].remaining : 0;
+        const PricingTable::LineDetails details = m_Table.describeLine(line.index, line.deal, line.remaining, 0, numberOfPartner);
+        const TaxClass taxClass = m_Table.getTaxClass(line.index);
+        const TaxRate rate = m_Table.getTaxRate(taxClass);
+        Money &taxable = m_Taxable[taxClass.getId()];
+        m_RemainingCost -= line.cost + rate.taxOn(taxable);
+        taxable += details.taxableCost - line.taxableCost;
+        line.cost = details.total;
+        line.taxableCost = details.taxableCost;
+        m_RemainingCost += line.cost + rate.taxOn(taxable);
+    }
+
+    ///@brief Takes units out of (i_Delta < 0) or puts them back into (i_Delta > 0) a line
+    void addUnits(const int i_Line, const int i_Delta)
+    {
+        Line &line = m_Lines[i_Line];
+        line.remaining += i_Delta;
+        m_LowerBound += line.unitLowerBound * i_Delta;
+        repriceLine(i_Line);
+        if (line.partner >= 0)
+        {
+            repriceLine(line.partner);
+        }
+    }
+
+    ///@brief Takes the most expensive remaining units of every slot of a rule
+    ///@return false (and takes nothing) if the rule can't be filled
+    bool takeGreedily(const Rule &i_Rule, std::vector<int> &o_Lines)
+    {
+        o_Lines.clear();
+        for (std::size_t slot = 0; slot < i_Rule.eligible.size(); ++slot)
+        {
+            for (int unit = 0; unit < i_Rule.quantity[slot]; ++unit)
+            {
+                const auto it = std::find_if(
+                    i_Rule.eligible[slot].begin(), i_Rule.eligible[slot].end(),
+                    [this](const int i_Line) { return m_Lines[i_Line].remaining > 0; });
+                if (i_Rule.eligible[slot].end() == it)
+                {
+                    putBack(o_Lines);
+                    return false;
+                }
+                addUnits(*it, -1);
+                o_Lines.push_back(*it);
+            }
+        }
+        return true;
+    }
+
+    void putBack(std::vector<int> &io_Lines)
+    {
+        for (const int line : io_Lines)
+        {
+            addUnits(line, 1);
+        }
+        io_Lines.clear();
+    }
+
+    ///@brief Applies the deal that saves the most until none saves anything, and keeps
+    /// the result as the best so far. Leaves the cart as it was.
+    void runGreedy()
+    {
+        std::vector<Deal> deals;
+        std::vector<int> lines;
+        for (;;)
+        {
+            const Money before = m_RemainingCost;
+            Money bestSaving(0);
+            Deal bestDeal = {0, {}};
+            for (std::size_t rule = 0; rule < m_Rules.size(); ++rule)
+            {
+                if (!takeGreedily(m_Rules[rule], lines))
+                {
+                    continue;
+                }
+                const Money saving = before - m_RemainingCost - m_Rules[rule].price;
+                if (bestSaving < saving)
+                {
+                    bestSaving = saving;
+                    bestDeal = {rule, lines};
+                }
+                putBack(lines);
+            }
+            if (bestDeal.lines.empty())
+            {
+                break;
+            }
+            for (const int line : bestDeal.lines)
+            {
+                addUnits(line, -1);
+            }
+            m_DealCost += m_Rules[bestDeal.rule].price;
+            deals.push_back(std::move(bestDeal));
+        }
+
+        m_BestCost = m_DealCost + m_RemainingCost;
+        m_BestDeals = deals;
+        for (auto &deal : deals)
+        {
+            m_DealCost -= m_Rules[deal.rule].price;
+            putBack(deal.lines);
+        }
+    }
+
+    ///@brief Visits every set of deals that applies rules i_Rule and up, where the next
+    /// application of i_Rule uses units at or after i_Previous (positions in the slots'
+    /// eligible lists), so each set is only visited in one order
+    void explore(const std::size_t i_Rule, const std::vector<int> &i_Previous)
+    {
+        if (m_TimedOut)
+        {
+            return;
+        }
+        if (0 == (++m_NumberOfNodes & 63) && std::chrono::steady_clock::now() > m_Deadline)
+        {
+            m_TimedOut = true;
+            return;
+        }
+
+        const Money cost = m_DealCost + m_RemainingCost;
+        if (cost < m_BestCost)
+        {
+            m_BestCost = cost;
+            m_BestDeals = m_Deals;
+        }
+        /// Nothing below this node can beat the best set found
+        if (!(m_DealCost + m_LowerBound < m_BestCost) || i_Rule == m_Rules.size())
+        {
+            return;
+        }
+
+        std::vector<int> choice(m_Rules[i_Rule].numberOfUnits);
+        chooseUnits(i_Rule, 0, 0, 0, choice, i_Previous, !i_Previous.empty());
+        const std::vector<int> noChoice;
+        explore(i_Rule + 1, noChoice);
+    }
+
+    ///@brief Fills unit i_Unit of slot i_Slot (unit i_Depth of the rule) with every
+    /// eligible line that has units left, then applies the rule once all are filled
+    ///@param i_IsEqualPrefix True if choices so far are the same as i_Previous
+    void chooseUnits(
+        const std::size_t i_Rule,
+        const std::size_t i_Depth,
+        const std::size_t i_Slot,
+        const int i_Unit,
+        std::vector<int> &io_Choice,
+        const std::vector<int> &i_Previous,
+        const bool i_IsEqualPrefix)
+    {
+        const Rule &rule = m_Rules[i_Rule];
+        if (i_Slot == rule.eligible.size())
+        {
+            Deal deal = {i_Rule, {}};
+            std::size_t depth = 0;
+            for (std::size_t slot = 0; slot < rule.eligible.size(); ++slot)
+            {
+                for (int unit = 0; unit < rule.quantity[slot]; ++unit, ++depth)
+                {
+                    deal.lines.push_back(rule.eligible[slot][io_Choice[depth]]);
+                }
+            }
+            m_Deals.push_back(std::move(deal));
+            m_DealCost += rule.price;
+            explore(i_Rule, io_Choice);
+            m_DealCost -= rule.price;
+            m_Deals.pop_back();
+            return;
+        }
+        if (i_Unit == rule.quantity[i_Slot])
+        {
+            chooseUnits(i_Rule, i_Depth, i_Slot + 1, 0, io_Choice, i_Previous, i_IsEqualPrefix);
+            return;
+        }
+
+        /// Units of a slot are chosen in non-decreasing order
+        int first = i_Unit > 0 ? io_Choice[i_Depth - 1] : 0;
+        if (i_IsEqualPrefix)
+        {
+            first = std::max(first, i_Previous[i_Depth]);
+        }
+        const std::vector<int> &eligible = rule.eligible[i_Slot];
+        for (int position = first; position < static_cast<int>(eligible.size()) && !m_TimedOut; ++position)
+        {
+            const int line = eligible[position];
+            if (0 == m_Lines[line].remaining)
+            {
+                continue;
+            }
+            io_Choice[i_Depth] = position;
+            addUnits(line, -1);
+            chooseUnits(i_Rule, i_Depth + 1, i_Slot, i_Unit + 1, io_Choice, i_Previous,
+                        i_IsEqualPrefix && position == i_Previous[i_Depth]);
+            addUnits(line, 1);
+        }
+    }
+
+    const PricingTable &m_Table;
+    const std::chrono::steady_clock::time_point m_Deadline;
+
+    std::vector<Line> m_Lines;
+    std::vector<Rule> m_Rules;
+
+    /// Deals applied at the current node and their total price
+    std::vector<Deal> m_Deals;
+    Money m_DealCost;
+    /// Sum of the cost of every line, plus the tax of every class
+    Money m_RemainingCost;
+    /// Taxable amount of the remaining units in each tax class
+    PricingTable::TaxableAmounts m_Taxable;
+    /// Sum of the lower bound of every remaining unit
+    Money m_LowerBound;
+
+    Money m_BestCost;
+    std::vector<Deal> m_BestDeals;
+
+    std::size_t m_NumberOfNodes;
+    bool m_TimedOut;
+};
+
+PromotionEngine::PromotionEngine(std::shared_ptr<const PricingTable> i_PricingTable, const std::vector<DealRule> &i_Rules)
+    : m_PricingTable(std::move(i_PricingTable)),
+      m_Rules(i_Rules),
+      m_CompiledRules(),
+      m_Time(PromotionWindow::getCurrentTime())
+{
+    const PricingTable &table = *m_PricingTable;
+    for (const auto &rule : m_Rules)
+    {
+        if (rule.slots.empty())
+        {
+            throw std::runtime_error("Deal " + rule.name + " has no slots");
+        }
+        CompiledRule compiled = {{}, {}, rule.price, Money(0)};
+        int numberOfUnits = 0;
+        for (const auto &slot : rule.slots)
+        {
+            if (slot.quantity <= 0)
+            {
+                throw std::runtime_error("Deal " + rule.name + " has a slot without units");
+            }
+            std::vector<PricingTable::Index> eligible;
+            for (const auto &id : slot.eligibleIds)
+            {
+                const PricingTable::Index index = table.find(id);
+                if (PricingTable::NO_INDEX != index && eligible.end() == std::find(eligible.begin(), eligible.end(), index))
+                {
+                    eligible.push_back(index);
+                }
+            }
+            /// Trying the most expensive units first finds good deals early
+            std::stable_sort(eligible.begin(), eligible.end(), [&table](const PricingTable::Index i_Left, const PricingTable::Index i_Right) {
+                return table.getUnitPrice(i_Right) < table.getUnitPrice(i_Left);
+            });
+            compiled.eligible.push_back(std::move(eligible));
+            compiled.quantity.push_back(slot.quantity);
+            numberOfUnits += slot.quantity;
+        }
+        compiled.pricePerUnit = Money(rule.price.getCents() / numberOfUnits);
+        m_CompiledRules.push_back(std::move(compiled));
+    }
+}
+
+PromotionEngine::~PromotionEngine()
+{
+}
+
+PromotionEngine::Result PromotionEngine::price(const std::vector<std::string> &i_Cart, const std::chrono::microseconds i_Budget) const
+{
+    Search search(*m_PricingTable, m_CompiledRules, i_Cart, m_Time, std::chrono::steady_clock::now() + i_Budget);
+    return search.run(i_Budget.count() > 0);
+}
@@ -0,0 +1,198 @@
+// Local
+#include "Receipt.hpp"
+// Standard Library
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+    ///@brief Builds a piece of text in a fixed buffer, silently truncating it
+    class Text
+    {
+
+    public:
+        Text(char *o_Buffer, const std::size_t i_Size)
+            : m_Buffer(o_Buffer),
+              m_Size(i_Size),
+              m_Length(0)
+        {
+        }
+
+        Text &operator<<(std::string_view i_Text)
+        {
+            const std::size_t length = std::min(i_Text.size(), m_Size - m_Length);
+            std::memcpy(m_Buffer + m_Length, i_Text.data(), length);
+            m_Length += length;
+            return *this;
+        }
+        Text &operator<<(const std::int64_t i_Value)
+        {
+            char digits[24];
+            const auto result = std::to_chars(digits, digits + sizeof(digits), i_Value);
+            return *this << std::string_view(digits, result.ptr - digits);
+        }
+        ///@brief Writes i_Value / 10^i_Decimals with i_Decimals decimals, e.g., 1549 -> "15.49"
+        Text &fixed(const std::int64_t i_Value, const int i_Decimals)
+        {
+            std::int64_t scale = 1;
+            for (int decimal = 0; decimal < i_Decimals; ++decimal)
+            {
+                scale *= 10;
+            }
+            if (i_Value < 0)
+            {
+                *this << "-";
+            }
+            /// Negated in unsigned arithmetic, so INT64_MIN doesn't overflow
+            const std::uint64_t absolute = i_Value < 0 ? 0 - static_cast<std::uint64_t>(i_Value) : static_cast<std::uint64_t>(i_Value);
+            *this << static_cast<std::int64_t>(absolute / scale) << ".";
+            char decimals[20];
+            std::uint64_t remainder = absolute % scale;
+            for (int decimal = i_Decimals - 1; decimal >= 0; --decimal)
+            {
+                decimals[decimal] = static_cast<char>('0' + remainder % 10);
+                remainder /= 10;
+            }
+            return *this << std::string_view(decimals, i_Decimals);
+        }
+
+        std::string_view view() const
+        {
+            return std::string_view(m_Buffer, m_Length);
+        }
+
+    private:
+        char *const m_Buffer;
+        const std::size_t m_Size;
+        std::size_t m_Length;
+    };
+} // namespace
+
+ReceiptSink::~ReceiptSink()
+{
+}
+
+BufferReceiptSink::BufferReceiptSink(char *o_Buffer, const std::size_t i_Size)
+    : m_Buffer(o_Buffer),
+      m_Size(i_Size),
+      m_Length(0)
+{
+    if (m_Size > 0)
+    {
+        m_Buffer[0] = '\0';
+    }
+}
+
+BufferReceiptSink::~BufferReceiptSink()
+{
+}
+
+void BufferReceiptSink::write(std::string_view i_Text)
+{
+    /// Always leave room for the terminating null
+    if (m_Length + 1 < m_Size)
+    {
+        const std::size_t length = std::min(i_Text.size(), m_Size - 1 - m_Length);
+        std::memcpy(m_Buffer + m_Length, i_Text.data(), length);
+        m_Buffer[m_Length + length] = '\0';
+    }
+    m_Length += i_Text.size();
+}
+
+ReceiptFormatter::ReceiptFormatter(ReceiptSink &io_Sink)
+    : m_Sink(io_Sink)
+{
+}
+
+ReceiptFormatter::~ReceiptFormatter()
+{
+}
+
+void ReceiptFormatter::addLine(
+    const PricingTable &i_Table,
+    const PricingTable::Index i_Index,
+    const PricingTable::Index i_Deal,
+    const int i_NumberOf,
+    const int i_Grams,
+    const PricingTable::LineDetails &i_Details)
+{
+    char buffer[WIDTH];
+    const std::string_view id = i_Table.getId(i_Index);
+    const Money unitPrice = i_Table.getUnitPrice(i_Index);
+
+    if (i_NumberOf > 0)
+    {
+        Text label(buffer, sizeof(buffer));
+        label << id << " x" << static_cast<std::int64_t>(i_NumberOf) << " @ ";
+        label.fixed(unitPrice.getCents(), 2);
+        writeRow(label.view(), i_Details.unitsCost);
+    }
+    if (i_Grams > 0)
+    {
+        Text label(buffer, sizeof(buffer));
+        label << id << " ";
+        label.fixed(i_Grams, 3) << " kg @ ";
+        label.fixed(unitPrice.getCents(), 2) << "/kg";
+        writeRow(label.view(), i_Details.weightCost);
+    }
+    if (i_Details.numberOfFreeUnits > 0)
+    {
+        const BuyXGetY deal = i_Table.visitPromotion(
+            i_Deal,
+            Overloaded{
+                [](const BuyXGetY &i_Deal) { return i_Deal; },
+                [](const auto &) { return BuyXGetY{0, 0}; }});
+        Text label(buffer, sizeof(buffer));
+        label << "  Buy " << static_cast<std::int64_t>(deal.buyX)
+              << " Get " << static_cast<std::int64_t>(deal.getY)
+              << " Free (" << static_cast<std::int64_t>(i_Details.numberOfFreeUnits) << " free)";
+        writeRow(label.view(), Money(0) - i_Details.freeSavings);
+    }
+    if (i_Details.bundleSavings != Money(0))
+    {
+        Text label(buffer, sizeof(buffer));
+        label << "  Bundle with " << i_Table.getId(i_Table.getBundlePartner(i_Deal))
+              << " (x" << static_cast<std::int64_t>(i_Details.numberOfBundles) << ")";
+        writeRow(label.view(), Money(0) - i_Details.bundleSavings);
+    }
+}
+
+void ReceiptFormatter::addTax(const TaxRate i_TaxRate, const Money i_Taxable)
+{
+    char buffer[WIDTH];
+    Text label(buffer, sizeof(buffer));
+    label << "Tax ";
+    label.fixed(i_TaxRate.getBasisPoints(), 2) << "% on ";
+    label.fixed(i_Taxable.getCents(), 2);
+    writeRow(label.view(), i_TaxRate.taxOn(i_Taxable));
+}
+
+void ReceiptFormatter::addTotal(const Money i_Total)
+{
+    char separator[WIDTH];
+    std::fill(separator, separator + WIDTH, '-');
+    writeRow(std::string_view(separator, WIDTH), Money(), false);
+    writeRow("TOTAL", i_Total);
+}
+
+void ReceiptFormatter::writeRow(std::string_view i_Label, const Money i_Amount, const bool i_HasAmount)
+{
+    char amount[32];
+    Text amountText(amount, sizeof(amount));
+    if (i_HasAmount)
+    {
+        amountText.fixed(i_Amount.getCents(), 2);
+    }
+
+    /// Label, padding, amount right-aligned, new line. The label gives way to the amount.
+    char row[WIDTH + 1];
+    const std::size_t amountLength = amountText.view().size();
+    const std::size_t labelLength = std::min(i_Label.size(), WIDTH - std::min(WIDTH, amountLength + (i_HasAmount ? 1 : 0)));
+    std::memcpy(row, i_Label.data(), labelLength);
+    std::fill(row + labelLength, row + WIDTH - amountLength, ' ');
+    std::memcpy(row + WIDTH - amountLength, amountText.view().data(), amountLength);
+    row[WIDTH] = '\n';
+    m_Sink.write(std::string_view(row, WIDTH + 1));
+}
@@ -0,0 +1,230 @@
+// Local
+#include "ScanJournal.hpp"
+// Standard Library
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+    const char MAGIC[8] = {'S', 'M', 'P', 'S', 'C', 'A', 'N', 'J'};
+
+    ///@brief Layout of the file header (padded to ScanJournal::HEADER_SIZE)
+    struct Header
+    {
+        char magic[8];
+        std::uint32_t formatVersion;
+        std::uint32_t recordSize;
+        /// Number of the open transaction, never 0 (a record of zeros is never valid)
+        std::uint32_t transaction;
+    };
+
+    ///@brief Layout of a record
+    struct Record
+    {
+        std::uint32_t transaction;
+        std::uint32_t index;
+        std::int32_t amount;
+        std::uint16_t kind;
+        /// Check of the other fields and of the record's position
+        std::uint16_t check;
+    };
+    static_assert(sizeof(Header) <= ScanJournal::HEADER_SIZE, "The header doesn't fit");
+    static_assert(sizeof(Record) == ScanJournal::RECORD_SIZE, "Records must not be padded");
+
+    ///@brief Checks that a file can be opened as a journal before it is mapped (which grows
+    /// it): it doesn't exist, is empty, or starts with the journal's magic or with zeros
+    /// (grown, but the header wasn't written yet)
+    ///@return i_Path
+    ///@throws std::runtime_error if it is any other file, which must not be taken over
+    const std::string &checkJournalFile(const std::string &i_Path)
+    {
+        char header[ScanJournal::HEADER_SIZE] = {};
+        std::ifstream file(i_Path, std::ios::binary);
+        file.read(header, sizeof(header));
+        const std::size_t size = static_cast<std::size_t>(file.gcount());
+        const bool isNew = std::all_of(header, header + size, [](const char i_Byte) { return 0 == i_Byte; });
+        if (!isNew && (size < sizeof(MAGIC) || 0 != std::memcmp(header, MAGIC, sizeof(MAGIC))))
+        {
+            throw std::runtime_error(i_Path + " exists and isn't a scan journal");
+        }
+        return i_Path;
+    }
+
+    std::uint16_t getCheck(const std::size_t i_Position, const Record &i_Record)
+    {
+        /// Mixes every field into 64 bits (splitmix64 finalizer) and folds the result
+        std::uint64_t value = (std::uint64_t(i_Record.transaction) << 32 | i_Record.index) ^
+                              (std::uint64_t(static_cast<std::uint32_t>(i_Record.amount)) << 16 | i_Record.kind) * 0x9E3779B97F4A7C15ull ^
+                              std::uint64_t(i_Position) * 0xC2B2AE3D27D4EB4Full;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        value ^= value >> 31;
+        return static_cast<std::uint16_t>(value ^ (value >> 16) ^ (value >> 32) ^ (value >> 48));
+    }
+} // namespace
+
+ScanJournal::ScanJournal(const std::string &i_Path, const std::size_t i_Capacity, const std::chrono::milliseconds i_CommitInterval)
+    : m_File(checkJournalFile(i_Path), HEADER_SIZE + i_Capacity * RECORD_SIZE),
+      m_Records(static_cast<unsigned char *>(m_File.data()) + HEADER_SIZE),
+      m_Capacity((m_File.size() - HEADER_SIZE) / RECORD_SIZE),
+      m_Transaction(0),
+      m_Position(0),
+      m_NumberOfAppended(0),
+      m_NumberOfSyncs(0),
+      m_CommitInterval(i_CommitInterval),
+      m_NumberOfDurable(0),
+      m_IsCommitRequested(false),
+      m_IsStopping(false),
+      m_IsFailed(false)
+{
+    Header header;
+    std::memcpy(&header, m_File.data(), sizeof(header));
+    if (0 != std::memcmp(header.magic, MAGIC, sizeof(MAGIC)))
+    {
+        /// New file (all zeros, see checkJournalFile)
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.formatVersion = FORMAT_VERSION;
+        header.recordSize = RECORD_SIZE;
+        header.transaction = 1;
+        std::memcpy(m_File.data(), &header, sizeof(header));
+        sync();
+    }
+    else if (FORMAT_VERSION != header.formatVersion || RECORD_SIZE != header.recordSize || 0 == header.transaction)
+    {
+        throw std::runtime_error(i_Path + " is a scan journal of another format");
+    }
+    m_Transaction = header.transaction;
+
+    Entry entry;
+    std::size_t position = 0;
+    while (position < m_Capacity && readRecord(position, entry))
+    {
+        m_Recovered.push_back(entry);
+        ++position;
+    }
+    m_Position.store(position, std::memory_order_relaxed);
+
+    if (0 != m_CommitInterval.count())
+    {
+        m_Thread = std::thread(&ScanJournal::commitLoop, this);
+    }
+}
+
+ScanJournal::~ScanJournal()
+{
+    if (m_Thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_IsStopping = true;
+        }
+        m_Wakeup.notify_one();
+        m_Thread.join();
+    }
+    try
+    {
+        sync();
+    }
+    catch (const std::runtime_error &)
+    {
+        /// Nothing more can be done, the records are still in the file's pages
+    }
+}
+
+void ScanJournal::begin()
+{
+    m_Transaction = 0 == m_Transaction + 1 ? 1 : m_Transaction + 1;
+    std::memcpy(static_cast<unsigned char *>(m_File.data()) + offsetof(Header, transaction), &m_Transaction, sizeof(m_Transaction));
+    m_Position.store(0, std::memory_order_release);
+    /// The new header has to be committed too, or a crash could bring back the last cart
+    m_NumberOfAppended.store(m_NumberOfAppended.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void ScanJournal::commit()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    if (!m_Thread.joinable())
+    {
+        m_NumberOfDurable = sync();
+        return;
+    }
+    const std::uint64_t target = m_NumberOfAppended.load(std::memory_order_relaxed);
+    m_IsCommitRequested = true;
+    m_Wakeup.notify_one();
+    m_Committed.wait(lock, [&] { return m_NumberOfDurable >= target || m_IsFailed; });
+    if (m_IsFailed)
+    {
+        throw std::runtime_error("Can't sync the scan journal");
+    }
+}
+
+void ScanJournal::writeRecord(const std::size_t i_Position, const Entry &i_Entry)
+{
+    Record record;
+    record.transaction = m_Transaction;
+    record.index = i_Entry.index;
+    record.amount = i_Entry.amount;
+    record.kind = static_cast<std::uint16_t>(i_Entry.kind);
+    record.check = getCheck(i_Position, record);
+    std::memcpy(m_Records + i_Position * RECORD_SIZE, &record, sizeof(record));
+}
+
+bool ScanJournal::readRecord(const std::size_t i_Position, Entry &o_Entry) const
+{
+    Record record;
+    std::memcpy(&record, m_Records + i_Position * RECORD_SIZE, sizeof(record));
+    if (m_Transaction != record.transaction || getCheck(i_Position, record) != record.check ||
+        (static_cast<std::uint16_t>(Kind::UNITS) != record.kind && static_cast<std::uint16_t>(Kind::GRAMS) != record.kind))
+    {
+        return false;
+    }
+    o_Entry.index = record.index;
+    o_Entry.kind = static_cast<Kind>(record.kind);
+    o_Entry.amount = record.amount;
+    return true;
+}
+
+std::uint64_t ScanJournal::sync()
+{
+    /// Records counted in numberOfAppended are either below the position read after it,
+    /// or belong to a transaction that a begin() (in the synced header) has replaced
+    const std::uint64_t numberOfAppended = m_NumberOfAppended.load(std::memory_order_acquire);
+    const std::size_t position = m_Position.load(std::memory_order_acquire);
+    m_File.sync(0, HEADER_SIZE + position * RECORD_SIZE);
+    m_NumberOfSyncs.fetch_add(1, std::memory_order_relaxed);
+    return numberOfAppended;
+}
+
+void ScanJournal::commitLoop()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while (!m_IsStopping)
+    {
+        m_Wakeup.wait_for(lock, m_CommitInterval, [this] { return m_IsStopping || m_IsCommitRequested; });
+        m_IsCommitRequested = false;
+        if (m_NumberOfAppended.load(std::memory_order_acquire) == m_NumberOfDurable)
+        {
+            continue;
+        }
+
+        /// Appending goes on while the pages are written
+        lock.unlock();
+        bool isFailed = false;
+        std::uint64_t numberOfDurable = 0;
+        try
+        {
+            numberOfDurable = sync();
+        }
+        catch (const std::runtime_error &)
+        {
+            isFailed = true;
+        }
+        lock.lock();
+        m_IsFailed = isFailed;
+        m_NumberOfDurable = isFailed ? m_NumberOfDurable : numberOfDurable;
+        m_Committed.notify_all();
+    }
+}
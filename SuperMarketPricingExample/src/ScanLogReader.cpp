@@ -0,0 +1,182 @@
+// Local
+#include "ScanLogReader.hpp"
+// Standard Library
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    ///@brief Splits off the next comma-separated field of io_Line
+    std::string_view nextField(std::string_view &io_Line)
+    {
+        const std::size_t comma = io_Line.find(',');
+        const std::string_view field = io_Line.substr(0, comma);
+        io_Line.remove_prefix(std::string_view::npos == comma ? io_Line.size() : comma + 1);
+        return field;
+    }
+
+    ///@brief Parses a whole field as an integer
+    template <class T>
+    bool parseInteger(std::string_view i_Field, T &o_Value)
+    {
+        const char *end = i_Field.data() + i_Field.size();
+        const auto result = std::from_chars(i_Field.data(), end, o_Value);
+        return std::errc() == result.ec && end == result.ptr;
+    }
+
+    ///@brief Closes a FILE when going out of scope
+    struct FileCloser
+    {
+        void operator()(std::FILE *i_File) const
+        {
+            std::fclose(i_File);
+        }
+    };
+} // namespace
+
+ScanLogReader::ScanLogReader(std::shared_ptr<const PricingTable> i_PricingTable, const std::size_t i_ChunkSize)
+    : m_PricingTable(std::move(i_PricingTable)),
+      m_Buffer(i_ChunkSize),
+      m_OpenCarts()
+{
+}
+
+ScanLogReader::~ScanLogReader()
+{
+}
+
+ScanLogReader::Statistics ScanLogReader::read(const std::string &i_Path, const CartHandler &i_Handler)
+{
+    std::unique_ptr<std::FILE, FileCloser> file(std::fopen(i_Path.c_str(), "rb"));
+    if (!file)
+    {
+        throw std::runtime_error("Can't open " + i_Path);
+    }
+
+    Statistics statistics = {0, 0, 0};
+    /// Lanes are kept from earlier logs so their pools get reused, but any transaction
+    /// left open by a failed read is dropped
+    for (auto &openCart : m_OpenCarts)
+    {
+        openCart.second.checkout->reset();
+        openCart.second.isOpen = false;
+    }
+
+    /// [0, numberOfBytes) holds unparsed data: the start of a line cut off at the end of
+    /// the previous chunk, followed by the new chunk
+    std::size_t numberOfBytes = 0;
+    bool skippingLongLine = false;
+    for (;;)
+    {
+        const std::size_t numberRead = std::fread(m_Buffer.data() + numberOfBytes, 1, m_Buffer.size() - numberOfBytes, file.get());
+        if (0 == numberRead && std::ferror(file.get()))
+        {
+            throw std::runtime_error("Can't read " + i_Path);
+        }
+        const bool endOfFile = (0 == numberRead);
+        numberOfBytes += numberRead;
+
+        std::string_view chunk(m_Buffer.data(), numberOfBytes);
+        for (std::size_t newLine = chunk.find('\n'); std::string_view::npos != newLine; newLine = chunk.find('\n'))
+        {
+            if (!skippingLongLine && !processLine(chunk.substr(0, newLine), i_Handler, statistics))
+            {
+                ++statistics.numberOfMalformedLines;
+            }
+            skippingLongLine = false;
+            chunk.remove_prefix(newLine + 1);
+        }
+
+        if (endOfFile)
+        {
+            if (!chunk.empty() && !skippingLongLine && !processLine(chunk, i_Handler, statistics))
+            {
+                ++statistics.numberOfMalformedLines;
+            }
+            break;
+        }
+
+        if (chunk.size() == m_Buffer.size())
+        {
+            /// A line that doesn't fit in the buffer, drop it up to its end
+            statistics.numberOfMalformedLines += !skippingLongLine;
+            skippingLongLine = true;
+            numberOfBytes = 0;
+        }
+        else
+        {
+            std::memmove(m_Buffer.data(), chunk.data(), chunk.size());
+            numberOfBytes = chunk.size();
+        }
+    }
+
+    /// Transactions still open at the end of the log are complete
+    for (auto &openCart : m_OpenCarts)
+    {
+        if (openCart.second.isOpen)
+        {
+            i_Handler(openCart.first, openCart.second.transaction, *openCart.second.checkout);
+            ++statistics.numberOfCarts;
+            openCart.second.checkout->reset();
+            openCart.second.isOpen = false;
+        }
+    }
+    return statistics;
+}
+
+bool ScanLogReader::processLine(std::string_view i_Line, const CartHandler &i_Handler, Statistics &io_Statistics)
+{
+    if (!i_Line.empty() && '\r' == i_Line.back())
+    {
+        i_Line.remove_suffix(1);
+    }
+    if (i_Line.empty())
+    {
+        return true;
+    }
+
+    const std::string_view lane = nextField(i_Line);
+    const std::string_view transaction = nextField(i_Line);
+    const std::string_view sku = nextField(i_Line);
+    const std::string_view quantityField = nextField(i_Line);
+    const std::string_view timestampField = nextField(i_Line);
+    int quantity = 0;
+    std::int64_t timestamp = 0;
+    if (lane.empty() || transaction.empty() || sku.empty() || !i_Line.empty() ||
+        !parseInteger(quantityField, quantity) || quantity <= 0 ||
+        !parseInteger(timestampField, timestamp))
+    {
+        return false;
+    }
+
+    auto it = m_OpenCarts.find(lane);
+    if (m_OpenCarts.end() == it)
+    {
+        it = m_OpenCarts.emplace(std::string(lane), OpenCart()).first;
+        OpenCart &newCart = it->second;
+        newCart.memory = std::make_unique<std::pmr::unsynchronized_pool_resource>();
+        newCart.checkout = std::make_unique<Checkout>(m_PricingTable, newCart.memory.get());
+        newCart.isOpen = false;
+    }
+    OpenCart &openCart = it->second;
+    if (!openCart.isOpen || openCart.transaction != transaction)
+    {
+        if (openCart.isOpen)
+        {
+            i_Handler(lane, openCart.transaction, *openCart.checkout);
+            ++io_Statistics.numberOfCarts;
+            openCart.checkout->reset();
+        }
+        openCart.transaction.assign(transaction.data(), transaction.size());
+        openCart.isOpen = true;
+    }
+
+    /// Price with the deals in effect when the item was scanned, not when the lane's
+    /// checkout was created
+    openCart.checkout->setTime(timestamp / 1000);
+    openCart.checkout->scan(sku, quantity);
+    ++io_Statistics.numberOfEvents;
+    return true;
+}
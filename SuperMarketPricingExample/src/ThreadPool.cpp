@@ -0,0 +1,125 @@
+// Local
+#include "ThreadPool.hpp"
+// Standard Library
+#include <algorithm>
+
+ThreadPool::ThreadPool(const unsigned i_NumberOfThreads)
+    : m_NumberOfWorkers(std::max(1u, i_NumberOfThreads ? i_NumberOfThreads : std::thread::hardware_concurrency())),
+      m_Threads(),
+      m_Slices(new Slice[m_NumberOfWorkers]),
+      m_Generation(0),
+      m_NumberRunning(0),
+      m_Stop(false),
+      m_Exception(),
+      m_Task(nullptr),
+      m_ChunkSize(1),
+      m_Failed(false)
+{
+    /// Worker 0 is whichever thread calls parallelFor()
+    for (unsigned worker = 1; worker < m_NumberOfWorkers; ++worker)
+    {
+        m_Threads.emplace_back(&ThreadPool::workerLoop, this, worker);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_WorkReady.notify_all();
+    for (auto &thread : m_Threads)
+    {
+        thread.join();
+    }
+}
+
+void ThreadPool::parallelFor(const std::size_t i_Count, const std::size_t i_ChunkSize, const Task &i_Task)
+{
+    std::lock_guard<std::mutex> callLock(m_CallMutex);
+
+    /// Split the range into one contiguous slice per worker
+    const std::size_t sliceSize = (i_Count + m_NumberOfWorkers - 1) / m_NumberOfWorkers;
+    for (unsigned worker = 0; worker < m_NumberOfWorkers; ++worker)
+    {
+        const std::size_t begin = std::min(i_Count, sliceSize * worker);
+        m_Slices[worker].next.store(begin, std::memory_order_relaxed);
+        m_Slices[worker].end = std::min(i_Count, begin + sliceSize);
+    }
+    m_Task = &i_Task;
+    m_ChunkSize = std::max<std::size_t>(1, i_ChunkSize);
+    m_Failed.store(false, std::memory_order_relaxed);
+    m_Exception = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_NumberRunning = static_cast<unsigned>(m_Threads.size());
+        ++m_Generation;
+    }
+    m_WorkReady.notify_all();
+
+    runSlices(0);
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_WorkDone.wait(lock, [this] { return 0 == m_NumberRunning; });
+    m_Task = nullptr;
+    if (m_Exception)
+    {
+        std::rethrow_exception(m_Exception);
+    }
+}
+
+void ThreadPool::workerLoop(const unsigned i_Worker)
+{
+    std::size_t generation = 0;
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    for (;;)
+    {
+        m_WorkReady.wait(lock, [&] { return m_Stop || generation != m_Generation; });
+        if (m_Stop)
+        {
+            return;
+        }
+        generation = m_Generation;
+
+        lock.unlock();
+        runSlices(i_Worker);
+        lock.lock();
+
+        if (0 == --m_NumberRunning)
+        {
+            m_WorkDone.notify_one();
+        }
+    }
+}
+
+void ThreadPool::runSlices(const unsigned i_Worker)
+{
+    for (unsigned offset = 0; offset < m_NumberOfWorkers; ++offset)
+    {
+        Slice &slice = m_Slices[(i_Worker + offset) % m_NumberOfWorkers];
+        while (!m_Failed.load(std::memory_order_relaxed))
+        {
+            const std::size_t begin = slice.next.fetch_add(m_ChunkSize, std::memory_order_relaxed);
+            if (begin >= slice.end)
+            {
+                break;
+            }
+
+            try
+            {
+                (*m_Task)(begin, std::min(begin + m_ChunkSize, slice.end), i_Worker);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                if (!m_Exception)
+                {
+                    m_Exception = std::current_exception();
+                }
+                m_Failed.store(true, std::memory_order_relaxed);
+            }
+        }
+    }
+}
@@ -1,17 +1,43 @@
 // Local
+#include <AsyncCheckout.hpp>
+#include <Barcode.hpp>
+#include <BatchPricer.hpp>
+#include <Catalog.hpp>
+#include <CatalogBackend.hpp>
+#include <CatalogFile.hpp>
 #include <Checkout.hpp>
+#include <ConcurrentCheckout.hpp>
+#include <DifferentialTester.hpp>
 #include <Item.hpp>
+#include <LineKernel.hpp>
+#include <Metrics.hpp>
+#include <PricingOverlay.hpp>
 #include <PricingScheme.hpp>
+#include <Promotion.hpp>
+#include <PromotionEngine.hpp>
+#include <Receipt.hpp>
+#include <ScanJournal.hpp>
+#include <ScanLogReader.hpp>
 // Platform Specific
 #include <Windows.h>
 // Standard Library
+#include <atomic>
 #include <chrono>
+#include <cstdio>
+#include <cstring>
 #include <ctime>
+#include <fstream>
 #include <functional>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <memory_resource>
+#include <random>
+#include <sstream>
 #include <stdlib.h>
 #include <string>
+#include <thread>
+#include <variant>
 #include <vector>
 
 ///@brief Namespace to hold test framework
@@ -217,11 +243,12 @@ protected:
     virtual void runTest() override
     {
         PricingScheme ps;
-        ps.addItem(Item("1983", 1.99, 0, {2, 1}));      //toothbrush
-        ps.addItem(Item("6732", 2.49, {"4900", 4.99})); //chips
-        ps.addItem(Item("4900", 3.49, {"6732", 4.99})); //salsa
-        ps.addItem(Item("8873", 2.49, 0));              //milk
-        ps.addItem(Item("0923", 15.49, 0.0925));        //wine
+        ps.setTaxRate(TaxClass(1), TaxRate(925));
+        ps.addItem(Item("1983", Money(199), TaxClass(), {2, 1}));   //toothbrush
+        ps.addItem(Item("6732", Money(249), {"4900", Money(499)})); //chips
+        ps.addItem(Item("4900", Money(349), {"6732", Money(499)})); //salsa
+        ps.addItem(Item("8873", Money(249), TaxClass()));           //milk
+        ps.addItem(Item("0923", Money(1549), TaxClass(1)));        //wine
         Checkout c(ps);
 
         std::vector<std::string> items{
@@ -252,12 +279,12 @@ protected:
     virtual void runTest() override
     {
         PricingScheme ps;
-        ps.addItem(Item("0000", 2.23, 0));
-        ps.addItem(Item("1111", 8.00, 0));
-        ps.addItem(Item("2222", 0.49, 0));
-        ps.addItem(Item("3333", 100.00, 0));
-        ps.addItem(Item("4444", 1.00, 0));
-        ps.addItem(Item("5555", 5.00, 0));
+        ps.addItem(Item("0000", Money(223), TaxClass()));
+        ps.addItem(Item("1111", Money(800), TaxClass()));
+        ps.addItem(Item("2222", Money(49), TaxClass()));
+        ps.addItem(Item("3333", Money(10000), TaxClass()));
+        ps.addItem(Item("4444", Money(100), TaxClass()));
+        ps.addItem(Item("5555", Money(500), TaxClass()));
 
         Checkout c(ps);
 
@@ -287,11 +314,12 @@ protected:
     virtual void runTest() override
     {
         PricingScheme ps;
-        ps.addItem(Item("0000", 1.00, 0, {1, 2}));     //exact deal case
-        ps.addItem(Item("1111", 1.00, 0, {1, 2}));     //forgot the free items case
-        ps.addItem(Item("2222", 1.00, 0, {1, 1}));     //multiple deal, forgot free item case
-        ps.addItem(Item("3333", 1.00, 0, {3, 2}));     //1 deal plus additional bought
-        ps.addItem(Item("4444", 1.00, 0.1, {100, 1})); //no deal case plus tax case
+        ps.setTaxRate(TaxClass(2), TaxRate(1000));
+        ps.addItem(Item("0000", Money(100), TaxClass(), {1, 2}));      //exact deal case
+        ps.addItem(Item("1111", Money(100), TaxClass(), {1, 2}));      //forgot the free items case
+        ps.addItem(Item("2222", Money(100), TaxClass(), {1, 1}));      //multiple deal, forgot free item case
+        ps.addItem(Item("3333", Money(100), TaxClass(), {3, 2}));      //1 deal plus additional bought
+        ps.addItem(Item("4444", Money(100), TaxClass(2), {100, 1})); //no deal case plus tax case
 
         Checkout c(ps);
 
@@ -336,20 +364,21 @@ protected:
     virtual void runTest() override
     {
         PricingScheme ps;
-        ps.addItem(Item("0000", 5.00, {"1111", 1.00}, 0.1)); // no qualifying bundles (has tax)
-        ps.addItem(Item("1111", 5.00, {"0000", 1.00}));      // none bought
+        ps.setTaxRate(TaxClass(2), TaxRate(1000));
+        ps.addItem(Item("0000", Money(500), {"1111", Money(100)}, TaxClass(2))); // no qualifying bundles (has tax)
+        ps.addItem(Item("1111", Money(500), {"0000", Money(100)}));                // none bought
 
-        ps.addItem(Item("2222", 5.00, {"3333", 1.00})); // exactlty 1 bundle
-        ps.addItem(Item("3333", 5.00, {"2222", 1.00})); // exactlty 1 bundle
+        ps.addItem(Item("2222", Money(500), {"3333", Money(100)})); // exactlty 1 bundle
+        ps.addItem(Item("3333", Money(500), {"2222", Money(100)})); // exactlty 1 bundle
 
-        ps.addItem(Item("4444", 5.00, {"5555", 1.00}));  // has extra
-        ps.addItem(Item("5555", 10.00, {"4444", 1.00})); // exactly 1 bundle
+        ps.addItem(Item("4444", Money(500), {"5555", Money(100)}));  // has extra
+        ps.addItem(Item("5555", Money(1000), {"4444", Money(100)})); // exactly 1 bundle
 
-        ps.addItem(Item("6666", 5.00, {"7777", 1.00}));  // exactly 1 bundle
-        ps.addItem(Item("7777", 10.00, {"6666", 1.00})); // has extra
+        ps.addItem(Item("6666", Money(500), {"7777", Money(100)}));  // exactly 1 bundle
+        ps.addItem(Item("7777", Money(1000), {"6666", Money(100)})); // has extra
 
-        ps.addItem(Item("8888", 5.00, {"9999", 1.00}));  // exactly 2 bundles
-        ps.addItem(Item("9999", 10.00, {"8888", 1.00})); // 2 extra
+        ps.addItem(Item("8888", Money(500), {"9999", Money(100)}));  // exactly 2 bundles
+        ps.addItem(Item("9999", Money(1000), {"8888", Money(100)})); // 2 extra
 
         Checkout c(ps);
 
@@ -384,6 +413,1882 @@ protected:
         EXPECT_EQ(cents, 5650);
     }
 };
+
+///@test Test Case for compiling a Pricing Scheme into an index-based table
+class CompiledPricingTableTest : public Testing::TestCaseBase
+{
+public:
+    CompiledPricingTableTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~CompiledPricingTableTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        PricingScheme ps;
+        ps.setTaxRate(TaxClass(1), TaxRate(925));
+        ps.addItem(Item("1983", Money(199), TaxClass(), {2, 1}));
+        ps.addItem(Item("6732", Money(249), {"4900", Money(499)}));
+        ps.addItem(Item("4900", Money(349), {"6732", Money(499)}));
+        ps.addItem(Item("0923", Money(1549), TaxClass(1)));
+        ps.addItem(Item("5555", Money(100), {"7777", Money(50)})); // partner not in scheme
+
+        const PricingTable table = ps.compile();
+        EXPECT_EQ(table.size(), static_cast<std::size_t>(5));
+
+        const PricingTable::Index chips = table.find("6732");
+        const PricingTable::Index salsa = table.find("4900");
+        EXPECT_EQ(table.getId(chips), std::string_view("6732"));
+        EXPECT_EQ(table.getBundlePartner(chips), salsa);
+        EXPECT_EQ(table.getBundlePartner(salsa), chips);
+        EXPECT_EQ(table.getBundlePrice(chips), Money(499));
+        EXPECT_EQ(table.hasBundle(table.find("5555")), false);
+        EXPECT_EQ(table.hasBuyXGetY(table.find("1983")), true);
+        EXPECT_EQ(table.getTax(table.find("0923")), TaxRate(925));
+        EXPECT_EQ(table.find("7777"), PricingTable::NO_INDEX);
+
+        Checkout c(ps);
+        c.scan("0923");
+        c.scan("7777"); // unknown items have no price
+        EXPECT_EQ(c.getTotal(), 1692);
+    }
+};
+
+///@test Test Case for sharing and hot-swapping catalog snapshots between checkouts
+class CatalogSnapshotTest : public Testing::TestCaseBase
+{
+public:
+    CatalogSnapshotTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~CatalogSnapshotTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        PricingScheme ps;
+        ps.addItem(Item("8873", Money(249), TaxClass())); //milk
+        Catalog catalog(ps);
+
+        std::shared_ptr<const PricingTable> before = catalog.snapshot();
+        Checkout inFlight(before);
+        EXPECT_EQ(catalog.snapshot().get(), before.get()); // lanes share one snapshot
+
+        ps.addItem(Item("8873", Money(299), TaxClass())); //price update
+        catalog.publish(ps);
+        Checkout next(catalog.snapshot());
+        EXPECT_EQ(catalog.snapshot()->getVersion(), before->getVersion() + 1);
+
+        inFlight.scan("8873");
+        next.scan("8873");
+        EXPECT_EQ(inFlight.getTotal(), 249); // keeps the version it started with
+        EXPECT_EQ(next.getTotal(), 299);
+    }
+};
+
+///@test Test Case for the running total being kept up to date after every scan
+class RunningTotalTest : public Testing::TestCaseBase
+{
+public:
+    RunningTotalTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~RunningTotalTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        PricingScheme ps;
+        ps.setTaxRate(TaxClass(1), TaxRate(925));
+        ps.addItem(Item("1983", Money(199), TaxClass(), {2, 1}));   //toothbrush
+        ps.addItem(Item("6732", Money(249), {"4900", Money(499)})); //chips
+        ps.addItem(Item("4900", Money(349), {"6732", Money(499)})); //salsa
+        ps.addItem(Item("0923", Money(1549), TaxClass(1)));        //wine
+        Checkout c(ps);
+
+        EXPECT_EQ(c.getTotal(), 0);
+        c.scan("4900"); //salsa
+        EXPECT_EQ(c.getTotal(), 349);
+        c.scan("6732"); //chips completes the bundle
+        EXPECT_EQ(c.getTotal(), 499);
+        c.scan("6732"); //chips on its own
+        EXPECT_EQ(c.getTotal(), 748);
+        c.scan("1983"); //toothbrush
+        c.scan("1983"); //toothbrush
+        EXPECT_EQ(c.getTotal(), 1146);
+        c.scan("1983"); //free toothbrush
+        EXPECT_EQ(c.getTotal(), 1146);
+        c.scan("0923"); //wine
+        EXPECT_EQ(c.getTotal(), 2838);
+        EXPECT_EQ(c.getTotal(), 2838); // re-quoting doesn't change the total
+    }
+};
+
+///@test Test Case for scanning quantities and weights instead of single units
+class BulkQuantityTest : public Testing::TestCaseBase
+{
+public:
+    BulkQuantityTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~BulkQuantityTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        PricingScheme ps;
+        ps.setTaxRate(TaxClass(2), TaxRate(1000));
+        ps.addItem(Item("3333", Money(100), TaxClass(), {3, 2}));   //buy 3 get 2 free
+        ps.addItem(Item("6732", Money(249), {"4900", Money(499)})); //chips
+        ps.addItem(Item("4900", Money(349), {"6732", Money(499)})); //salsa
+        ps.addItem(Item("4011", Money(200), TaxClass(2)));        //bananas, per kg
+
+        Checkout pallet(ps);
+        pallet.scan("3333", 200000); //40000 deals
+        EXPECT_EQ(pallet.getTotal(), 12000000);
+
+        Checkout byQuantity(ps);
+        Checkout byUnit(ps);
+        byQuantity.scan("3333", 9);
+        byQuantity.scan("6732", 3);
+        byQuantity.scan("4900", 2);
+        for (int i = 0; i < 9; ++i)
+        {
+            byUnit.scan("3333");
+        }
+        for (const auto &item : std::vector<std::string>{"6732", "4900", "6732", "4900", "6732"})
+        {
+            byUnit.scan(item);
+        }
+        EXPECT_EQ(byQuantity.getTotal(), byUnit.getTotal());
+        EXPECT_EQ(byQuantity.getTotal(), 1847);
+
+        Checkout scale(ps);
+        scale.scanWeight("4011", 500);
+        scale.scanWeight("4011", 250);
+        EXPECT_EQ(scale.getTotal(), 165);
+
+        /// Amounts of 0 or less are ignored, they can't take items out of the cart
+        byQuantity.scan("3333", -9);
+        byQuantity.scan("6732", 0);
+        scale.scanWeight("4011", -750);
+        scale.scanWeight("4011", 0);
+        EXPECT_EQ(byQuantity.getTotal(), 1847);
+        EXPECT_EQ(scale.getTotal(), 165);
+        ConcurrentCheckout shared(std::make_shared<const PricingTable>(ps.compile()));
+        shared.scan("6732", -1);
+        shared.scanWeight("4011", -250);
+        shared.scan("4900", 0);
+        EXPECT_EQ(shared.getTotal(), 0);
+    }
+};
+
+///@test Test Case for the fixed-point Money and TaxRate types
+class MoneyTest : public Testing::TestCaseBase
+{
+public:
+    MoneyTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~MoneyTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        EXPECT_EQ(Money::fromDollars(15.49), Money(1549));
+        EXPECT_EQ(Money::fromDollars(0.29), Money(29));
+        EXPECT_EQ(Money(249) * 3 + Money(1), Money(748));
+
+        EXPECT_EQ(TaxRate(925).taxOn(Money(1549)), Money(143)); // 143.2825
+        EXPECT_EQ(TaxRate(1000).taxOn(Money(5)), Money(1));     // 0.5 rounds up
+        EXPECT_EQ(TaxRate(1000).taxOn(Money(-5)), Money(-1));   // and away from zero for refunds
+        EXPECT_EQ(Money(129).scale(1500, 1000), Money(194));    // 193.5
+
+        std::ostringstream stream;
+        stream << Money(1549) << " " << Money(-7) << " " << TaxRate(925);
+        EXPECT_EQ(stream.str(), std::string("15.49 -0.07 9.25%"));
+
+        PricingScheme ps;
+        ps.setTaxRate(TaxClass(1), TaxRate(925));
+        ps.addItem(Item("0923", Money(1549), TaxClass(1))); //wine
+        Checkout c(ps);
+        c.scan("0923", 3); // tax is rounded once for the line, not per bottle
+        EXPECT_EQ(c.getTotal(), 4647 + 430);
+    }
+};
+
+///@test Test Case for pricing a batch of carts in parallel
+class BatchPricerTest : public Testing::TestCaseBase
+{
+public:
+    BatchPricerTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~BatchPricerTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        PricingScheme ps;
+        ps.setTaxRate(TaxClass(1), TaxRate(925));
+        ps.addItem(Item("1983", Money(199), TaxClass(), {2, 1}));   //toothbrush
+        ps.addItem(Item("6732", Money(249), {"4900", Money(499)})); //chips
+        ps.addItem(Item("4900", Money(349), {"6732", Money(499)})); //salsa
+        ps.addItem(Item("8873", Money(249), TaxClass()));           //milk
+        ps.addItem(Item("0923", Money(1549), TaxClass(1)));        //wine
+        std::shared_ptr<const PricingTable> table = std::make_shared<const PricingTable>(ps.compile());
+
+        const std::vector<std::string> ids{"1983", "6732", "4900", "8873", "0923", "9999"};
+        std::mt19937 random(1983);
+        std::vector<BatchPricer::Cart> carts(5000);
+        for (auto &cart : carts)
+        {
+            cart.resize(random() % 20);
+            for (auto &id : cart)
+            {
+                id = ids[random() % ids.size()];
+            }
+        }
+
+        BatchPricer pricer(table, 4);
+        const std::vector<Money> totals = pricer.priceAll(carts);
+        EXPECT_EQ(totals.size(), carts.size());
+
+        int numberOfMismatches = 0;
+        for (std::size_t i = 0; i < carts.size(); ++i)
+        {
+            Checkout c(table);
+            for (const auto &id : carts[i])
+            {
+                c.scan(id);
+            }
+            numberOfMismatches += (totals[i] != Money(c.getTotal()));
+        }
+        EXPECT_EQ(numberOfMismatches, 0);
+    }
+};
+
+///@test Test Case for the vectorized simple line pricing kernel
+class LineKernelTest : public Testing::TestCaseBase
+{
+public:
+    LineKernelTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~LineKernelTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        std::cout << Testing::Const::INDENT.c_str() << "| Vectorized: " << LineKernel::isVectorized() << std::endl;
+
+        std::vector<std::int32_t> unitPrice{1549, 5, 5, 100, 1};
+        std::vector<std::int32_t> tax{925, 1000, 5000, 0, 10000};
+        std::vector<std::int32_t> quantity{3, 1, 1, 7, 1};
+        std::mt19937 random(2024);
+        for (int i = 0; i < 10001; ++i)
+        {
+            unitPrice.push_back(random() % 100000);
+            tax.push_back(random() % 2000);
+            quantity.push_back(random() % 17000);
+        }
+        unitPrice.push_back(1759218); //largest line that fits
+        tax.push_back(9999);
+        quantity.push_back(1000);
+
+        int numberOfMismatches = 0;
+        std::vector<std::int64_t> cost(unitPrice.size());
+        LineKernel::priceLines(unitPrice.data(), tax.data(), quantity.data(), unitPrice.size(), cost.data());
+        for (std::size_t i = 0; i < unitPrice.size(); ++i)
+        {
+            const Money costBeforeTax = Money(unitPrice[i]) * quantity[i];
+            const Money expected = costBeforeTax + TaxRate(tax[i]).taxOn(costBeforeTax);
+            numberOfMismatches += !LineKernel::fits(unitPrice[i], quantity[i], tax[i]);
+            numberOfMismatches += (expected != Money(cost[i]));
+        }
+        EXPECT_EQ(numberOfMismatches, 0);
+        EXPECT_EQ(cost[0], std::int64_t(5077));
+        EXPECT_EQ(LineKernel::fits(1759219, 1000, 0), false);
+    }
+};
+
+///@test Test Case for writing a binary catalog and serving it from a memory mapping
+class CatalogFileTest : public Testing::TestCaseBase
+{
+public:
+    CatalogFileTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~CatalogFileTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        PricingScheme ps;
+        ps.setTaxRate(TaxClass(1), TaxRate(925));
+        ps.addItem(Item("1983", Money(199), TaxClass(), {2, 1}));   //toothbrush
+        ps.addItem(Item("6732", Money(249), {"4900", Money(499)})); //chips
+        ps.addItem(Item("4900", Money(349), {"6732", Money(499)})); //salsa
+        ps.addItem(Item("8873", Money(249), TaxClass()));           //milk
+        ps.addItem(Item("0923", Money(1549), TaxClass(1)));        //wine
+
+        const std::string path = "CatalogFileTest.bin";
+        CatalogFile::write(ps.compile(), path);
+        {
+            std::shared_ptr<const PricingTable> table = CatalogFile::load(path);
+            EXPECT_EQ(table->size(), static_cast<std::size_t>(5));
+            EXPECT_EQ(table->getVersion(), ps.getVersion());
+            EXPECT_EQ(table->getBundlePartner(table->find("6732")), table->find("4900"));
+
+            Checkout c(table);
+            for (const auto &item : {"1983", "4900", "8873", "6732", "0923", "1983", "1983", "1983"})
+            {
+                c.scan(item);
+            }
+            EXPECT_EQ(c.getTotal(), 3037);
+        }
+
+        /// Corrupt one price, the checksum has to catch it
+        {
+            std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+            file.seekp(-1, std::ios::end);
+            file.put('X');
+        }
+        bool threw = false;
+        try
+        {
+            CatalogFile::load(path);
+        }
+        catch (std::runtime_error &)
+        {
+            threw = true;
+        }
+        EXPECT_EQ(threw, true);
+        std::remove(path.c_str());
+    }
+};
+
+///@test Test Case for streaming a scan event log into carts
+class ScanLogReaderTest : public Testing::TestCaseBase
+{
+public:
+    ScanLogReaderTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~ScanLogReaderTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        PricingScheme ps;
+        ps.setTaxRate(TaxClass(1), TaxRate(925));
+        ps.addItem(Item("1983", Money(199), TaxClass(), {2, 1}));   //toothbrush
+        ps.addItem(Item("6732", Money(249), {"4900", Money(499)})); //chips
+        ps.addItem(Item("4900", Money(349), {"6732", Money(499)})); //salsa
+        ps.addItem(Item("8873", Money(249), TaxClass()));           //milk
+        ps.addItem(Item("0923", Money(1549), TaxClass(1)));        //wine
+
+        const std::string path = "ScanLogReaderTest.log";
+        {
+            std::ofstream log(path, std::ios::binary);
+            log << "01,0001,1983,1,1700000000000\n"
+                << "02,0007,8873,2,1700000000100\r\n"
+                << "01,0001,4900,1,1700000000200\n"
+                << "this line is malformed\n"
+                << "01,0001,8873,1,1700000000300\n"
+                << "01,0001,6732,1,1700000000400\n"
+                << "01,0001,0923,1,1700000000500\n"
+                << "01,0001,1983,3,1700000000600\n"
+                << "01,0002,0923,1,1700000000700\n"
+                << "02,0008,1983,x,1700000000800\n"
+                << "02,0008,6732,1,1700000000900"; // no new line at the end
+        }
+
+        std::map<std::string, int> totals;
+        ScanLogReader reader(std::make_shared<const PricingTable>(ps.compile()), 64); // tiny chunks, lines get split
+        const ScanLogReader::Statistics statistics = reader.read(
+            path,
+            [&](std::string_view i_Lane, std::string_view i_Transaction, Checkout &io_Checkout) {
+                totals[std::string(i_Lane) + "/" + std::string(i_Transaction)] = io_Checkout.getTotal();
+            });
+        std::remove(path.c_str());
+
+        EXPECT_EQ(statistics.numberOfEvents, static_cast<std::size_t>(9));
+        EXPECT_EQ(statistics.numberOfCarts, static_cast<std::size_t>(4));
+        EXPECT_EQ(statistics.numberOfMalformedLines, static_cast<std::size_t>(2));
+        EXPECT_EQ(totals["01/0001"], 3037);
+        EXPECT_EQ(totals["01/0002"], 1692);
+        EXPECT_EQ(totals["02/0007"], 498);
+        EXPECT_EQ(totals["02/0008"], 249);
+
+        /// Milk is Buy 1 Get 1 from 1700000100 to 1700000200: carts are priced with the
+        /// deals of the time of their scans, whatever lane's checkout they reuse
+        ps.schedulePromotion("8873", BuyXGetY{1, 1}, PromotionWindow{1700000100, 1700000200});
+        {
+            std::ofstream log(path, std::ios::binary);
+            log << "01,0003,8873,2,1700000050000\n"
+                << "01,0004,8873,2,1700000150000\n"
+                << "01,0005,8873,2,1700000250000\n"
+                << "02,0009,8873,1,1700000099999\n"
+                << "02,0009,8873,1,1700000100000\n";
+        }
+        totals.clear();
+        ScanLogReader scheduledReader(std::make_shared<const PricingTable>(ps.compile()));
+        scheduledReader.read(
+            path,
+            [&](std::string_view i_Lane, std::string_view i_Transaction, Checkout &io_Checkout) {
+                totals[std::string(i_Lane) + "/" + std::string(i_Transaction)] = io_Checkout.getTotal();
+            });
+        std::remove(path.c_str());
+        EXPECT_EQ(totals["01/0003"], 498);
+        EXPECT_EQ(totals["01/0004"], 249);
+        EXPECT_EQ(totals["01/0005"], 498);
+        EXPECT_EQ(totals["02/0009"], 249);
+    }
+};
+
+///@test Test Case for the metrics counters, histograms and text export
+class MetricsTest : public Testing::TestCaseBase
+{
+public:
+    MetricsTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~MetricsTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        /// Every recorded value is within one bucket width (1/16th) of its bucket's bounds
+        for (std::uint64_t value : {0ull, 15ull, 16ull, 17ull, 1000ull, 123456789ull, ~0ull})
+        {
+            const std::size_t bucket = Metrics::Histogram::getBucket(value);
+            EXPECT_EQ(Metrics::Histogram::getBucketLowest(bucket) <= value, true);
+            EXPECT_EQ(Metrics::Histogram::getBucketHighest(bucket) >= value, true);
+            EXPECT_EQ(Metrics::Histogram::getBucketHighest(bucket) - Metrics::Histogram::getBucketLowest(bucket) <= value / 16, true);
+        }
+        Metrics::Histogram histogram;
+        for (std::uint64_t value = 1; value <= 1000; ++value)
+        {
+            histogram.record(value);
+        }
+        EXPECT_EQ(histogram.getCount(), static_cast<std::uint64_t>(1000));
+        EXPECT_EQ(histogram.getSum(), static_cast<std::uint64_t>(500500));
+        EXPECT_EQ(histogram.getPercentile(0.5) >= 500 && histogram.getPercentile(0.5) <= 531, true);
+        EXPECT_EQ(histogram.getPercentile(1.0), static_cast<std::uint64_t>(1000));
+
+        PricingScheme ps;
+        ps.addItem(Item("1983", Money(199), TaxClass(), {2, 1}));   //toothbrush
+        ps.addItem(Item("6732", Money(249), {"4900", Money(499)})); //chips
+        ps.addItem(Item("4900", Money(349), {"6732", Money(499)})); //salsa
+        const auto table = std::make_shared<const PricingTable>(ps.compile());
+
+        /// Nothing is recorded while metrics are off
+        Metrics::reset();
+        Checkout(table).scan("1983");
+        EXPECT_EQ(Metrics::snapshot().get(Metrics::SCANS), static_cast<std::uint64_t>(0));
+
+        /// Each thread records into its own shard, the snapshot adds them up
+        Metrics::setEnabled(true);
+        const int numberOfThreads = 4;
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < numberOfThreads; ++thread)
+        {
+            threads.emplace_back([&table] {
+                Checkout c(table);
+                c.scan("1983", 3); // Buy 2 get 1 applies
+                c.scan("6732");
+                c.scan("4900"); // bundle completed
+                c.scan("0000"); // unknown
+                (void)c.getTotal();
+                char receipt[1024]; // describes the deals again, without counting them
+                (void)c.writeReceipt(receipt, sizeof(receipt));
+            });
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+        Metrics::setEnabled(false);
+
+        const Metrics::Snapshot snapshot = Metrics::snapshot();
+        EXPECT_EQ(snapshot.get(Metrics::SCANS), static_cast<std::uint64_t>(4 * numberOfThreads));
+        EXPECT_EQ(snapshot.get(Metrics::LOOKUPS), static_cast<std::uint64_t>(4 * numberOfThreads));
+        EXPECT_EQ(snapshot.get(Metrics::LOOKUP_MISSES), static_cast<std::uint64_t>(numberOfThreads));
+        EXPECT_EQ(snapshot.get(Metrics::BUNDLE_MATCHES), static_cast<std::uint64_t>(numberOfThreads));
+        EXPECT_EQ(snapshot.get(Metrics::BUY_X_GET_Y_APPLICATIONS), static_cast<std::uint64_t>(numberOfThreads));
+        EXPECT_EQ(snapshot.get(Metrics::SCAN).getCount(), static_cast<std::uint64_t>(4 * numberOfThreads));
+        EXPECT_EQ(snapshot.get(Metrics::GET_TOTAL).getCount(), static_cast<std::uint64_t>(2 * numberOfThreads)); // and the receipt's
+
+        const std::string text = Metrics::exportText(snapshot);
+        EXPECT_EQ(text.find("# TYPE supermarket_scans_total counter\nsupermarket_scans_total 16\n") != std::string::npos, true);
+        EXPECT_EQ(text.find("supermarket_scan_duration_nanoseconds_count 16\n") != std::string::npos, true);
+
+        Metrics::reset();
+        EXPECT_EQ(Metrics::snapshot().get(Metrics::SCANS), static_cast<std::uint64_t>(0));
+    }
+};
+
+///@test Test Case for reusing a Checkout and its lane memory across transactions
+class PooledCheckoutTest : public Testing::TestCaseBase
+{
+public:
+    PooledCheckoutTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~PooledCheckoutTest() {}
+
+protected:
+    ///@brief Counts the allocations that reach the global heap
+    class CountingResource : public std::pmr::memory_resource
+    {
+    public:
+        std::size_t numberOfAllocations = 0;
+
+    private:
+        void *do_allocate(std::size_t i_Bytes, std::size_t i_Alignment) override
+        {
+            ++numberOfAllocations;
+            return std::pmr::new_delete_resource()->allocate(i_Bytes, i_Alignment);
+        }
+        void do_deallocate(void *i_Memory, std::size_t i_Bytes, std::size_t i_Alignment) override
+        {
+            std::pmr::new_delete_resource()->deallocate(i_Memory, i_Bytes, i_Alignment);
+        }
+        bool do_is_equal(const std::pmr::memory_resource &i_Other) const noexcept override
+        {
+            return this == &i_Other;
+        }
+    };
+
+    virtual void runTest() override
+    {
+        PricingScheme ps;
+        ps.setTaxRate(TaxClass(1), TaxRate(925));
+        ps.addItem(Item("1983", Money(199), TaxClass(), {2, 1}));   //toothbrush
+        ps.addItem(Item("6732", Money(249), {"4900", Money(499)})); //chips
+        ps.addItem(Item("4900", Money(349), {"6732", Money(499)})); //salsa
+        ps.addItem(Item("8873", Money(249), TaxClass()));           //milk
+        ps.addItem(Item("0923", Money(1549), TaxClass(1)));        //wine
+        const auto table = std::make_shared<const PricingTable>(ps.compile());
+
+        CountingResource heap;
+        std::pmr::unsynchronized_pool_resource lanePool(&heap);
+        Checkout c(table, &lanePool);
+        for (const char *id : {"1983", "4900", "8873", "6732", "0923", "1983", "1983", "1983"})
+        {
+            c.scan(id);
+        }
+        EXPECT_EQ(c.getTotal(), 3037);
+
+        /// The next customers reuse the cart's nodes, nothing more comes from the heap
+        const std::size_t numberOfAllocations = heap.numberOfAllocations;
+        for (int customer = 0; customer < 3; ++customer)
+        {
+            c.reset();
+            EXPECT_EQ(c.getTotal(), 0);
+            for (const char *id : {"0923", "8873", "6732", "4900", "1983"})
+            {
+                c.scan(id);
+            }
+            EXPECT_EQ(c.getTotal(), 2639);
+        }
+        EXPECT_EQ(heap.numberOfAllocations, numberOfAllocations);
+
+        /// Switching to a newer snapshot between transactions
+        ps.addItem(Item("8873", Money(299), TaxClass())); //milk
+        c.reset(std::make_shared<const PricingTable>(ps.compile()));
+        c.scan("8873");
+        EXPECT_EQ(c.getTotal(), 299);
+    }
+};
+
+///@test Test Case for promotions as a closed set of kinds
+class PromotionKindTest : public Testing::TestCaseBase
+{
+public:
+    PromotionKindTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~PromotionKindTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        PricingScheme ps;
+        ps.addItem(Item("1983", Money(199), BuyXGetY{2, 1}, TaxClass()));   //toothbrush
+        ps.addItem(Item("6732", Money(249), Bundle{"4900", Money(499)}));   //chips
+        ps.addItem(Item("4900", Money(349), Bundle{"6732", Money(499)}));   //salsa
+        ps.addItem(Item("8873", Money(249), SimplePrice(), TaxClass()));    //milk
+        ps.addItem(Item("5555", Money(100), Bundle{"0000", Money(50)}));    //no partner
+        ps.addItem(Item("7777", Money(100), TaxClass(), {0, 0}));           //old style, no deal
+
+        /// Every kind has to be handled, or this doesn't compile
+        auto describe = [](const Promotion &i_Promotion) {
+            return std::visit(Overloaded{
+                                  [](const SimplePrice &) { return std::string("simple"); },
+                                  [](const BuyXGetY &i_Deal) { return "buy " + std::to_string(i_Deal.buyX) + " get " + std::to_string(i_Deal.getY); },
+                                  [](const Bundle &i_Deal) { return "bundle with " + i_Deal.partnerId; }},
+                              i_Promotion);
+        };
+        EXPECT_EQ(describe(ps.getItemMap().at("1983").getPromotion()), std::string("buy 2 get 1"));
+        EXPECT_EQ(describe(ps.getItemMap().at("6732").getPromotion()), std::string("bundle with 4900"));
+        EXPECT_EQ(describe(ps.getItemMap().at("7777").getPromotion()), std::string("simple"));
+
+        const PricingTable table = ps.compile();
+        EXPECT_EQ(static_cast<int>(table.getPromotionKind(table.find("1983"))), static_cast<int>(PromotionKind::BUY_X_GET_Y));
+        EXPECT_EQ(static_cast<int>(table.getPromotionKind(table.find("4900"))), static_cast<int>(PromotionKind::BUNDLE));
+        EXPECT_EQ(static_cast<int>(table.getPromotionKind(table.find("8873"))), static_cast<int>(PromotionKind::SIMPLE_PRICE));
+        /// A bundle with an item that isn't in the catalog can't be completed
+        EXPECT_EQ(static_cast<int>(table.getPromotionKind(table.find("5555"))), static_cast<int>(PromotionKind::SIMPLE_PRICE));
+        EXPECT_EQ(table.getBundlePartner(table.find("5555")), PricingTable::NO_INDEX);
+
+        const PricingTable::Index chips = table.find("6732");
+        const PricingTable::Index partner = table.visitPromotion(
+            chips,
+            Overloaded{
+                [](const SimplePrice &) { return PricingTable::NO_INDEX; },
+                [](const BuyXGetY &) { return PricingTable::NO_INDEX; },
+                [](const PricingTable::BundleDeal &i_Deal) { return i_Deal.partner; }});
+        EXPECT_EQ(partner, table.find("4900"));
+
+        Checkout c(ps);
+        for (const char *id : {"1983", "1983", "1983", "6732", "4900", "8873", "5555"})
+        {
+            c.scan(id);
+        }
+        EXPECT_EQ(c.getTotal(), 398 + 499 + 249 + 100);
+    }
+};
+
+///@test Test Case for finding the best set of overlapping deals
+class PromotionEngineTest : public Testing::TestCaseBase
+{
+public:
+    PromotionEngineTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~PromotionEngineTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        PricingScheme ps;
+        ps.addItem(Item("0001", Money(500), TaxClass())); //sandwich
+        ps.addItem(Item("0002", Money(500), TaxClass())); //salad
+        ps.addItem(Item("0003", Money(500), TaxClass())); //soda
+        ps.addItem(Item("0004", Money(500), TaxClass())); //juice
+        ps.addItem(Item("1983", Money(199), TaxClass(), {2, 1})); //toothbrush
+        const auto table = std::make_shared<const PricingTable>(ps.compile());
+
+        /// Greedy takes the deal that saves the most (400) and then nothing else fits,
+        /// the two smaller deals together save more
+        const std::vector<DealRule> rules = {
+            {"sandwich and salad", {{{"0001"}, 1}, {{"0002"}, 1}}, Money(600)},
+            {"sandwich and soda", {{{"0001"}, 1}, {{"0003"}, 1}}, Money(700)},
+            {"salad and juice", {{{"0002"}, 1}, {{"0004"}, 1}}, Money(700)}};
+        PromotionEngine engine(table, rules);
+        const std::vector<std::string> cart = {"0001", "0002", "0003", "0004"};
+
+        const PromotionEngine::Result greedy = engine.price(cart, std::chrono::microseconds(0));
+        EXPECT_EQ(greedy.total, Money(1600));
+        EXPECT_EQ(greedy.isOptimal, false);
+
+        const PromotionEngine::Result optimal = engine.price(cart, std::chrono::seconds(1));
+        EXPECT_EQ(optimal.total, Money(1400));
+        EXPECT_EQ(optimal.isOptimal, true);
+        EXPECT_EQ(optimal.deals.size(), static_cast<std::size_t>(2));
+
+        /// Mix and match: any 3 for $10. Units outside deals keep their item promotions.
+        PromotionEngine mixAndMatch(table, {{"any 3 for $10", {{{"0001", "0002", "0003", "1983"}, 3}}, Money(1000)}});
+        EXPECT_EQ(mixAndMatch.price({"0001", "0002", "0003", "0001", "1983"}).total, Money(1000 + 500 + 199));
+        EXPECT_EQ(mixAndMatch.price({"1983", "1983", "1983"}).total, Money(398));
+        EXPECT_EQ(mixAndMatch.price({"0003", "1983", "1983", "1983", "0002"}).total, Money(1000 + 398));
+
+        /// A big basket with overlapping deals stays within a small budget, and is never
+        /// worse than greedy
+        std::vector<std::string> basket;
+        for (int i = 0; i < 300; ++i)
+        {
+            basket.push_back("000" + std::to_string(1 + i % 4));
+        }
+        std::vector<DealRule> overlapping = rules;
+        overlapping.push_back({"any 3", {{{"0001", "0002", "0003", "0004"}, 3}}, Money(1300)});
+        overlapping.push_back({"meal", {{{"0001", "0002"}, 1}, {{"0003", "0004"}, 1}}, Money(750)});
+        PromotionEngine busy(table, overlapping);
+        const auto start = std::chrono::steady_clock::now();
+        const PromotionEngine::Result bounded = busy.price(basket, std::chrono::milliseconds(5));
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        EXPECT_EQ(elapsed < std::chrono::milliseconds(500), true);
+        EXPECT_EQ(bounded.total < busy.price(basket, std::chrono::microseconds(0)).total ||
+                      bounded.total == busy.price(basket, std::chrono::microseconds(0)).total,
+                  true);
+    }
+};
+
+///@test Test Case for scanning into one cart from several threads
+class ConcurrentCheckoutTest : public Testing::TestCaseBase
+{
+public:
+    ConcurrentCheckoutTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~ConcurrentCheckoutTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        PricingScheme ps;
+        ps.setTaxRate(TaxClass(1), TaxRate(925));
+        ps.addItem(Item("1983", Money(199), TaxClass(), {2, 1}));   //toothbrush
+        ps.addItem(Item("6732", Money(249), {"4900", Money(499)})); //chips
+        ps.addItem(Item("4900", Money(349), {"6732", Money(499)})); //salsa
+        ps.addItem(Item("8873", Money(249), TaxClass()));           //milk
+        ps.addItem(Item("0923", Money(1549), TaxClass(1)));        //wine
+        ps.addItem(Item("3001", Money(899), TaxClass()));           //cheese, per kg
+        const auto table = std::make_shared<const PricingTable>(ps.compile());
+        const std::vector<std::string> ids = {"1983", "6732", "4900", "8873", "0923", "0000"};
+
+        /// Several devices scan into the same cart while someone watches the total
+        ConcurrentCheckout shared(table, 4);
+        const int numberOfThreads = 8;
+        const int numberOfScans = 2000;
+        std::vector<std::thread> scanners;
+        for (int thread = 0; thread < numberOfThreads; ++thread)
+        {
+            scanners.emplace_back([&, thread] {
+                for (int scan = 0; scan < numberOfScans; ++scan)
+                {
+                    shared.scan(ids[(thread + scan) % ids.size()]);
+                }
+                shared.scanWeight("3001", 250);
+            });
+        }
+        std::atomic<bool> isDone(false);
+        std::thread watcher([&] {
+            while (!isDone)
+            {
+                (void)shared.getTotal();
+            }
+        });
+        for (auto &scanner : scanners)
+        {
+            scanner.join();
+        }
+        isDone = true;
+        watcher.join();
+
+        Checkout single(table);
+        for (int thread = 0; thread < numberOfThreads; ++thread)
+        {
+            for (int scan = 0; scan < numberOfScans; ++scan)
+            {
+                single.scan(ids[(thread + scan) % ids.size()]);
+            }
+            single.scanWeight("3001", 250);
+        }
+        EXPECT_EQ(shared.getTotal(), single.getTotal());
+
+        shared.reset();
+        EXPECT_EQ(shared.getTotal(), 0);
+        shared.scan("6732");
+        shared.scan("4900");
+        EXPECT_EQ(shared.getTotal(), 499);
+    }
+};
+
+///@test Test Case for repricing open carts after a batch of catalog changes
+class DeltaRepricingTest : public Testing::TestCaseBase
+{
+public:
+    DeltaRepricingTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~DeltaRepricingTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        PricingScheme ps;
+        ps.setTaxRate(TaxClass(1), TaxRate(925));
+        ps.addItem(Item("1983", Money(199), TaxClass(), {2, 1}));   //toothbrush
+        ps.addItem(Item("6732", Money(249), {"4900", Money(499)})); //chips
+        ps.addItem(Item("4900", Money(349), {"6732", Money(499)})); //salsa
+        ps.addItem(Item("8873", Money(249), TaxClass()));           //milk
+        ps.addItem(Item("0923", Money(1549), TaxClass(1)));        //wine
+        const auto oldTable = std::make_shared<const PricingTable>(ps.compile());
+        const std::vector<std::vector<std::string>> carts = {
+            {"1983", "4900", "8873", "6732", "0923", "1983", "1983", "1983"},
+            {"8873", "8873"},
+            {"6732", "4900", "6732"},
+            {"0923"}};
+        std::vector<std::unique_ptr<Checkout>> openCarts;
+        for (const auto &cart : carts)
+        {
+            openCarts.push_back(std::make_unique<Checkout>(oldTable));
+            for (const auto &id : cart)
+            {
+                openCarts.back()->scan(id);
+            }
+        }
+
+        PricingScheme::Delta delta;
+        delta.items.push_back(Item("8873", Money(299), TaxClass()));           //milk price up
+        delta.items.push_back(Item("6732", Money(249), {"4900", Money(450)})); //bundle on sale
+        delta.items.push_back(Item("4900", Money(349), {"6732", Money(450)}));
+        delta.items.push_back(Item("5000", Money(100), TaxClass()));           //new item
+        delta.removedIds.push_back("0923");                                    //wine recalled
+        const std::uint64_t oldVersion = ps.getVersion();
+        ps.applyDelta(delta);
+        EXPECT_EQ(ps.getVersion(), oldVersion + 1);
+
+        std::vector<PricingTable::Index> changed;
+        EXPECT_EQ(ps.getChangesSince(oldVersion, changed), true);
+        EXPECT_EQ(changed.size(), static_cast<std::size_t>(5));
+        EXPECT_EQ(ps.getChangesSince(ps.getVersion(), changed), true);
+        EXPECT_EQ(changed.size(), static_cast<std::size_t>(0));
+
+        /// Items keep their index, removed items can't be found anymore
+        const auto newTable = std::make_shared<const PricingTable>(ps.compile());
+        EXPECT_EQ(newTable->find("8873"), oldTable->find("8873"));
+        EXPECT_EQ(newTable->find("0923"), PricingTable::NO_INDEX);
+        EXPECT_EQ(newTable->getId(oldTable->find("0923")), std::string_view("0923"));
+
+        /// Repricing only the changed lines gives the same total as scanning again
+        ps.getChangesSince(oldVersion, changed);
+        for (std::size_t cart = 0; cart < carts.size(); ++cart)
+        {
+            openCarts[cart]->update(newTable, changed);
+            EXPECT_EQ(openCarts[cart]->getVersion(), ps.getVersion());
+
+            Checkout fresh(newTable);
+            for (const auto &id : carts[cart])
+            {
+                fresh.scan(id);
+            }
+            EXPECT_EQ(openCarts[cart]->getTotal(), fresh.getTotal());
+        }
+        EXPECT_EQ(openCarts[2]->getTotal(), 450 + 249);
+
+        /// Once the journal is trimmed, old carts have to be repriced in full
+        ps.removeItem("1983");
+        ps.trimJournal(ps.getVersion());
+        EXPECT_EQ(ps.getChangesSince(oldVersion, changed), false);
+        openCarts[0]->update(std::make_shared<const PricingTable>(ps.compile()));
+        EXPECT_EQ(openCarts[0]->getTotal(), 450 + 299);
+    }
+};
+
+///@test Test Case for the itemized receipt adding up to the total
+class ReceiptTest : public Testing::TestCaseBase
+{
+public:
+    ReceiptTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~ReceiptTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        PricingScheme ps;
+        ps.setTaxRate(TaxClass(1), TaxRate(925));
+        ps.addItem(Item("1983", Money(199), TaxClass(), {2, 1}));   //toothbrush
+        ps.addItem(Item("6732", Money(249), {"4900", Money(499)})); //chips
+        ps.addItem(Item("4900", Money(349), {"6732", Money(499)})); //salsa
+        ps.addItem(Item("8873", Money(249), TaxClass()));           //milk
+        ps.addItem(Item("0923", Money(1549), TaxClass(1)));        //wine
+        ps.addItem(Item("3001", Money(899), TaxClass(1)));         //cheese, per kg
+        Checkout c(ps);
+        for (const char *id : {"1983", "4900", "8873", "6732", "0923", "1983", "1983", "1983", "4900"})
+        {
+            c.scan(id);
+        }
+        c.scanWeight("3001", 250);
+
+        char receipt[1024];
+        const std::size_t length = c.writeReceipt(receipt, sizeof(receipt));
+        EXPECT_EQ(length < sizeof(receipt), true);
+        EXPECT_EQ(std::strlen(receipt), length);
+
+        /// Every row is the same width, with the amount in the last column
+        const std::size_t rowLength = ReceiptFormatter::WIDTH + 1;
+        EXPECT_EQ(length % rowLength, static_cast<std::size_t>(0));
+        std::int64_t sum = 0;
+        std::int64_t total = -1;
+        for (std::size_t row = 0; row < length; row += rowLength)
+        {
+            const std::string text(receipt + row, rowLength - 1);
+            const std::size_t amountStart = text.find_last_of(' ') + 1;
+            if ('-' == text[0] && '-' == text[1])
+            {
+                continue;
+            }
+            const double amount = std::stod(text.substr(amountStart));
+            const std::int64_t cents = static_cast<std::int64_t>(amount * 100 + (amount < 0 ? -0.5 : 0.5));
+            if (0 == text.compare(0, 5, "TOTAL"))
+            {
+                total = cents;
+            }
+            else
+            {
+                sum += cents;
+            }
+        }
+        EXPECT_EQ(total, static_cast<std::int64_t>(c.getTotal()));
+        EXPECT_EQ(sum, static_cast<std::int64_t>(c.getTotal()));
+
+        const std::string text(receipt, length);
+        EXPECT_EQ(text.find("1983 x4 @ 1.99                      7.96\n") != std::string::npos, true);
+        EXPECT_EQ(text.find("  Buy 2 Get 1 Free (1 free)        -1.99\n") != std::string::npos, true);
+        EXPECT_EQ(text.find("  Bundle with ") != std::string::npos, true);
+        EXPECT_EQ(text.find("3001 0.250 kg @ 8.99/kg             2.25\n") != std::string::npos, true);
+        /// Wine and cheese are taxed together, once
+        EXPECT_EQ(text.find("Tax 9.25% on 17.74                  1.64\n") != std::string::npos, true);
+
+        /// A buffer that is too small gets as much as fits
+        char small[50];
+        EXPECT_EQ(c.writeReceipt(small, sizeof(small)), length);
+        EXPECT_EQ(std::string(small), text.substr(0, sizeof(small) - 1));
+    }
+};
+
+///@test Test Case for recovering a cart from the scan journal
+class ScanJournalTest : public Testing::TestCaseBase
+{
+public:
+    ScanJournalTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~ScanJournalTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        PricingScheme ps;
+        ps.setTaxRate(TaxClass(1), TaxRate(925));
+        ps.addItem(Item("1983", Money(199), TaxClass(), {2, 1}));   //toothbrush
+        ps.addItem(Item("6732", Money(249), {"4900", Money(499)})); //chips
+        ps.addItem(Item("4900", Money(349), {"6732", Money(499)})); //salsa
+        ps.addItem(Item("8873", Money(249), TaxClass()));           //milk
+        ps.addItem(Item("0923", Money(1549), TaxClass(1)));        //wine
+        const auto table = std::make_shared<const PricingTable>(ps.compile());
+        const std::string path = "ScanJournalTest.bin";
+        std::remove(path.c_str());
+
+        /// A lane scans more items than the journal has room for, then dies
+        int total = 0;
+        {
+            ScanJournal journal(path, 12, std::chrono::milliseconds(1));
+            EXPECT_EQ(journal.getRecovered().size(), static_cast<std::size_t>(0));
+            Checkout c(table);
+            c.scan("1983");
+            c.setJournal(&journal);
+            for (const char *id : {"4900", "8873", "6732", "0923", "1983", "1983", "1983"})
+            {
+                c.scan(id);
+            }
+            c.scanWeight("8873", 500);
+            for (int i = 0; i < 10; ++i)
+            {
+                c.scan("1983");
+            }
+            journal.commit();
+            EXPECT_EQ(journal.getNumberOfSyncs() > 0, true);
+            EXPECT_EQ(journal.size() < static_cast<std::size_t>(12), true);
+            total = c.getTotal();
+        }
+
+        /// The next lane process gets the same cart back
+        {
+            ScanJournal journal(path, 12, std::chrono::milliseconds(0));
+            Checkout c(table);
+            c.recover(journal);
+            EXPECT_EQ(c.getTotal(), total);
+            c.scan("6732");
+            total = c.getTotal();
+        }
+        {
+            ScanJournal journal(path, 12, std::chrono::milliseconds(0));
+            Checkout c(table);
+            c.recover(journal);
+            EXPECT_EQ(c.getTotal(), total);
+            c.reset();
+        }
+
+        /// A paid cart isn't brought back
+        {
+            ScanJournal journal(path, 12, std::chrono::milliseconds(0));
+            EXPECT_EQ(journal.getRecovered().size(), static_cast<std::size_t>(0));
+            Checkout c(table);
+            c.setJournal(&journal);
+            c.scan("0923");
+            c.scan("8873");
+        }
+
+        /// A record torn by a crash ends the transaction
+        {
+            std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+            file.seekp(ScanJournal::HEADER_SIZE + ScanJournal::RECORD_SIZE + 4);
+            file.put('X');
+        }
+        {
+            ScanJournal journal(path, 12, std::chrono::milliseconds(0));
+            EXPECT_EQ(journal.getRecovered().size(), static_cast<std::size_t>(1));
+            Checkout c(table);
+            c.recover(journal);
+            EXPECT_EQ(c.getTotal(), 1692);
+        }
+        std::remove(path.c_str());
+
+        /// Any other file (e.g., a mistyped path) is neither grown nor overwritten
+        {
+            std::ofstream file(path, std::ios::binary);
+            file << "receipt printer settings";
+        }
+        bool threw = false;
+        try
+        {
+            ScanJournal journal(path, 12, std::chrono::milliseconds(0));
+        }
+        catch (std::runtime_error &)
+        {
+            threw = true;
+        }
+        EXPECT_EQ(threw, true);
+        {
+            std::ifstream file(path, std::ios::binary);
+            std::string content;
+            std::getline(file, content);
+            EXPECT_EQ(content, std::string("receipt printer settings"));
+        }
+
+        /// An empty file is a new journal
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        }
+        {
+            ScanJournal journal(path, 12, std::chrono::milliseconds(0));
+            EXPECT_EQ(journal.getRecovered().size(), static_cast<std::size_t>(0));
+        }
+        std::remove(path.c_str());
+    }
+};
+
+///@test Test Case for scanning GTIN/EAN barcodes, incl. weight and price embedded codes
+class BarcodeTest : public Testing::TestCaseBase
+{
+public:
+    BarcodeTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~BarcodeTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        PricingScheme ps;
+        ps.addItem(Item("4006381333931", Money(250), TaxClass())); //EAN-13
+        ps.addItem(Item("036000291452", Money(100), TaxClass()));  //UPC-A
+        ps.addItem(Item("96385074", Money(75), TaxClass()));       //GTIN-8
+        ps.addItem(Item("2512345000000", Money(399), TaxClass())); //apples, per kg
+        ps.addItem(Item("2198765000000", Money(1), TaxClass()));   //deli counter, priced per label
+        ps.addItem(Item("1983", Money(199), TaxClass()));          //not a GTIN
+        const PricingTable table = ps.compile();
+
+        EXPECT_EQ(table.findBarcode(4006381333931ull), table.find("4006381333931"));
+        EXPECT_EQ(table.findBarcode(36000291452ull), table.find("036000291452"));
+        EXPECT_EQ(table.findBarcode(1983), PricingTable::NO_INDEX);
+        EXPECT_EQ(table.findBarcode(4006381333932ull), PricingTable::NO_INDEX);
+
+        const Barcode apples = Barcode::parse("2512345012504");
+        EXPECT_EQ(apples.isValid(), true);
+        EXPECT_EQ(apples.getEmbedded() == Barcode::Embedded::WEIGHT, true);
+        EXPECT_EQ(apples.getValue(), 1250);
+        EXPECT_EQ(apples.getItemKey(), static_cast<std::uint64_t>(2512345000000ull));
+        EXPECT_EQ(Barcode::parse("2512345012505").isValid(), false);
+        EXPECT_EQ(Barcode::parse("40063813339A1").isValid(), false);
+
+        Checkout c(ps);
+        c.scanBarcode("4006381333931");
+        c.scanBarcode("0036000291452"); //UPC-A as EAN-13
+        c.scanBarcode("96385074");
+        c.scanBarcode("2512345012504"); //1.250 kg
+        c.scanBarcode("2198765003492"); //3.49
+        c.scanBarcode("4006381333932"); //wrong check digit
+        c.scanBarcode("1983");
+        EXPECT_EQ(c.getTotal(), 250 + 100 + 75 + 499 + 349);
+
+        /// Every GTIN of a larger catalog is found with one probe, and no other number is
+        std::mt19937_64 random(1983);
+        std::uniform_int_distribution<std::uint64_t> gtins(1000000000000ull, 9999999999999ull);
+        PricingScheme large;
+        std::vector<std::uint64_t> keys;
+        for (int i = 0; i < 20000; ++i)
+        {
+            keys.push_back(gtins(random));
+            large.addItem(Item(std::to_string(keys.back()), Money(100), TaxClass()));
+        }
+        large.removeItem(std::to_string(keys[0]));
+        const PricingTable largeTable = large.compile();
+        int numberOfMismatches = 0;
+        for (std::size_t i = 1; i < keys.size(); ++i)
+        {
+            numberOfMismatches += largeTable.findBarcode(keys[i]) != largeTable.find(std::to_string(keys[i]));
+            numberOfMismatches += PricingTable::NO_INDEX != largeTable.findBarcode(gtins(random) * 10 + 1);
+        }
+        EXPECT_EQ(numberOfMismatches, 0);
+        EXPECT_EQ(largeTable.findBarcode(keys[0]), PricingTable::NO_INDEX);
+    }
+};
+
+///@test Test Case for the randomized differential test of the pricing engines
+class DifferentialTest : public Testing::TestCaseBase
+{
+public:
+    DifferentialTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~DifferentialTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        /// The reference agrees with the documented example
+        DifferentialTester::Case example;
+        example.items.push_back(Item("1983", Money(199), BuyXGetY{2, 1}, TaxClass()));
+        example.items.push_back(Item("6732", Money(249), Bundle{"4900", Money(499)}, TaxClass()));
+        example.items.push_back(Item("4900", Money(349), Bundle{"6732", Money(499)}, TaxClass()));
+        example.items.push_back(Item("0923", Money(1549), SimplePrice(), TaxClass(1)));
+        example.scans = {{"1983", 4, 0}, {"4900", 2, 0}, {"6732", 1, 0}, {"0923", 1, 0}, {"9999", 1, 0}};
+        example.taxRates = {TaxRate(0), TaxRate(925)};
+        EXPECT_EQ(DifferentialTester::priceReference(example), static_cast<std::int64_t>(199 * 3 + 499 + 349 + 1549 + 143));
+
+        /// Same cases from the same seed
+        DifferentialTester::Options options;
+        options.numberOfCases = 1500;
+        EXPECT_EQ(DifferentialTester::describe(DifferentialTester::generate(options, 42)), DifferentialTester::describe(DifferentialTester::generate(options, 42)));
+
+        DifferentialTester tester(options);
+        tester.addDefaultEngines();
+        const DifferentialTester::Report report = tester.run();
+        EXPECT_EQ(report.numberOfCases, options.numberOfCases);
+        EXPECT_EQ(report.numberOfComparisons > 4 * options.numberOfCases, true);
+        EXPECT_EQ(report.failures.size(), static_cast<std::size_t>(0));
+        for (const auto &failure : report.failures)
+        {
+            std::cout << failure.engine << ", case " << failure.caseNumber << ":\n" << DifferentialTester::describe(failure.shrunk);
+        }
+
+        /// An engine that forgets the tax is caught, on one taxed item scanned once
+        DifferentialTester broken(options);
+        broken.addEngine("No tax", [](const DifferentialTester::Case &i_Case) -> std::optional<std::int64_t> {
+            DifferentialTester::Case untaxed = i_Case;
+            untaxed.taxRates.clear();
+            return DifferentialTester::priceReference(untaxed);
+        });
+        const DifferentialTester::Report brokenReport = broken.run();
+        EXPECT_EQ(brokenReport.failures.size(), options.maxFailures);
+        EXPECT_EQ(brokenReport.failures.front().shrunk.items.size(), static_cast<std::size_t>(1));
+        EXPECT_EQ(brokenReport.failures.front().shrunk.scans.size(), static_cast<std::size_t>(1));
+        EXPECT_EQ(brokenReport.failures.front().expected != brokenReport.failures.front().actual, true);
+    }
+};
+
+///@test Test Case for tax classes, taxed once per class of a cart
+class TaxClassTest : public Testing::TestCaseBase
+{
+public:
+    TaxClassTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~TaxClassTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        PricingScheme ps;
+        ps.setTaxRate(TaxClass(1), TaxRate(925));  //alcohol
+        ps.setTaxRate(TaxClass(2), TaxRate(1000)); //household
+        ps.addItem(Item("0001", Money(6), TaxClass(1)));
+        ps.addItem(Item("0002", Money(6), TaxClass(1)));
+        ps.addItem(Item("0003", Money(6), TaxClass(2)));
+        ps.addItem(Item("0004", Money(6), TaxClass()));
+        EXPECT_EQ(ps.getTaxRate(TaxClass(1)), TaxRate(925));
+        EXPECT_EQ(ps.getTaxRate(TaxClass(3)), TaxRate(0));
+
+        /// 0.555 + 0.555 of tax would be 2 cents rounded per line, 1.11 is 1 cent per class
+        auto table = std::make_shared<const PricingTable>(ps.compile());
+        EXPECT_EQ(table->getTaxClass(table->find("0002")).getId(), TaxClass(1).getId());
+        EXPECT_EQ(table->getTaxRate(TaxClass(2)), TaxRate(1000));
+        Checkout c(table);
+        c.scan("0001");
+        c.scan("0002");
+        EXPECT_EQ(c.getTotal(), 12 + 1);
+        c.scan("0003");
+        c.scan("0004");
+        EXPECT_EQ(c.getTotal(), 24 + 1 + 1);
+
+        /// A rate change is one update that no item is part of, and open carts are taxed
+        /// at the new rate as soon as they move to the new table
+        const std::uint64_t version = ps.getVersion();
+        ps.setTaxRate(TaxClass(1), TaxRate(2500));
+        std::vector<PricingTable::Index> changed;
+        EXPECT_EQ(ps.getChangesSince(version, changed), true);
+        EXPECT_EQ(changed.size(), static_cast<std::size_t>(0));
+        EXPECT_EQ(ps.getVersion(), version + 1);
+        c.update(std::make_shared<const PricingTable>(ps.compile()), changed);
+        EXPECT_EQ(c.getTotal(), 24 + 3 + 1);
+
+        /// Moving an item to another class moves its line's taxable amount
+        PricingScheme::Delta delta;
+        delta.items.push_back(Item("0002", Money(6), TaxClass(2)));
+        delta.taxRates.emplace_back(TaxClass(0), TaxRate(5000));
+        ps.applyDelta(delta);
+        EXPECT_EQ(ps.getVersion(), version + 2);
+        EXPECT_EQ(ps.getChangesSince(version + 1, changed), true);
+        c.update(std::make_shared<const PricingTable>(ps.compile()), changed);
+        EXPECT_EQ(c.getTotal(), 24 + 2 + 1 + 3);
+        Checkout fresh(ps);
+        for (const char *id : {"0001", "0002", "0003", "0004"})
+        {
+            fresh.scan(id);
+        }
+        EXPECT_EQ(fresh.getTotal(), c.getTotal());
+
+        /// Classes past the end of the tax table are rejected
+        bool threw = false;
+        try
+        {
+            ps.addItem(Item("0005", Money(6), TaxClass(TaxClass::COUNT)));
+        }
+        catch (std::runtime_error &)
+        {
+            threw = true;
+        }
+        EXPECT_EQ(threw, true);
+        EXPECT_EQ(ps.getItemMap().count("0005"), static_cast<std::size_t>(0));
+    }
+};
+
+///@test Test Case for deals scheduled for windows of time
+class ScheduledPromotionTest : public Testing::TestCaseBase
+{
+public:
+    ScheduledPromotionTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~ScheduledPromotionTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        const std::int64_t hour = 3600;
+        const std::int64_t day = 24 * hour;
+        const std::int64_t june1 = 1748736000; /// 2025-06-01 00:00 UTC
+
+        PricingScheme ps;
+        ps.addItem(Item("beer", Money(300), TaxClass()));
+        ps.addItem(Item("chips", Money(200), TaxClass(), {2, 1}));
+        ps.addItem(Item("salsa", Money(150), TaxClass()));
+        /// Happy hour on beer, 17:00 to 19:00 the first 3 days of June
+        ps.schedulePromotion("beer", BuyXGetY{1, 1}, PromotionWindow{june1 + 17 * hour, june1 + 19 * hour, day, june1 + 3 * day});
+        /// Chips and salsa go together on June 2nd, instead of the chips' own deal
+        ps.schedulePromotion("chips", Bundle{"salsa", Money(250)}, PromotionWindow{june1 + day, june1 + 2 * day});
+        ps.schedulePromotion("salsa", Bundle{"chips", Money(250)}, PromotionWindow{june1 + day, june1 + 2 * day});
+
+        auto table = std::make_shared<const PricingTable>(ps.compile());
+        const PricingTable::Index beer = table->find("beer");
+        EXPECT_EQ(table->findDeal(beer, june1 + 16 * hour), beer);
+        EXPECT_EQ(table->hasBuyXGetY(table->findDeal(beer, june1 + 17 * hour)), true);
+        EXPECT_EQ(table->findDeal(beer, june1 + 19 * hour), beer);
+        EXPECT_EQ(table->hasBuyXGetY(table->findDeal(beer, june1 + 2 * day + 18 * hour)), true);
+        EXPECT_EQ(table->findDeal(beer, june1 + 3 * day + 18 * hour), beer);
+        EXPECT_EQ(table->getScheduleSegment(june1 + 12 * hour).second, june1 + 17 * hour);
+        EXPECT_EQ(table->getScheduleSegment(june1 + 17 * hour).first, june1 + 17 * hour);
+        EXPECT_EQ(table->getScheduleSegment(june1 + 10 * day).second, INT64_MAX);
+
+        Checkout c(table);
+        c.setTime(june1 + 16 * hour);
+        c.scan("beer", 2);
+        c.scan("chips", 3);
+        c.scan("salsa");
+        EXPECT_EQ(c.getTotal(), 600 + 400 + 150);
+
+        /// Happy hour starts while the customer is still scanning
+        c.setTime(june1 + 17 * hour);
+        EXPECT_EQ(c.getTotal(), 300 + 400 + 150);
+        c.setTime(june1 + 19 * hour - 1);
+        EXPECT_EQ(c.getTotal(), 300 + 400 + 150);
+        c.setTime(june1 + 19 * hour);
+        EXPECT_EQ(c.getTotal(), 600 + 400 + 150);
+
+        /// On June 2nd, 1 chips and salsa bundle and 2 chips at the unit price
+        c.setTime(june1 + day + 12 * hour);
+        EXPECT_EQ(c.getTotal(), 600 + 250 + 400);
+        c.setTime(june1 + day + 18 * hour);
+        EXPECT_EQ(c.getTotal(), 300 + 250 + 400);
+        char receipt[512];
+        c.writeReceipt(receipt, sizeof(receipt));
+        EXPECT_EQ(std::string(receipt).find("Bundle with salsa (x1)") != std::string::npos, true);
+        EXPECT_EQ(std::string(receipt).find("Buy 1 Get 1 Free (1 free)") != std::string::npos, true);
+        c.setTime(june1 + 5 * day);
+        EXPECT_EQ(c.getTotal(), 600 + 400 + 150);
+
+        /// The schedule is part of the binary image
+        const PricingTable copy = PricingTable::fromImage(table, table->getImage(), table->getImageSize());
+        EXPECT_EQ(copy.findDeal(beer, june1 + 18 * hour), table->findDeal(beer, june1 + 18 * hour));
+        EXPECT_EQ(copy.getBundlePartner(copy.findDeal(table->find("salsa"), june1 + day)), table->find("chips"));
+
+        /// Scheduling a deal is a change of the item, so open carts can pick it up
+        const std::uint64_t version = ps.getVersion();
+        ps.schedulePromotion("beer", BuyXGetY{2, 1}, PromotionWindow{june1 + 10 * day, june1 + 11 * day});
+        std::vector<PricingTable::Index> changed;
+        EXPECT_EQ(ps.getChangesSince(version, changed), true);
+        EXPECT_EQ(changed.size(), static_cast<std::size_t>(1));
+        EXPECT_EQ(changed[0], beer);
+        c.setTime(june1 + 10 * day);
+        c.scan("beer");
+        c.update(std::make_shared<const PricingTable>(ps.compile()), changed);
+        EXPECT_EQ(c.getTotal(), 600 + 400 + 150);
+
+        /// Windows of an item can't overlap, and must be scheduled for an item of the scheme
+        int numberOfThrows = 0;
+        for (const PromotionWindow &window : {PromotionWindow{june1 + 18 * hour, june1 + 20 * hour},
+                                              PromotionWindow{june1 + 2 * hour, june1 + hour},
+                                              PromotionWindow{june1, june1 + 2 * hour, hour, june1 + day}})
+        {
+            try
+            {
+                ps.schedulePromotion("beer", SimplePrice(), window);
+            }
+            catch (std::runtime_error &)
+            {
+                ++numberOfThrows;
+            }
+        }
+        try
+        {
+            ps.schedulePromotion("wine", SimplePrice(), PromotionWindow{june1, june1 + hour});
+        }
+        catch (std::runtime_error &)
+        {
+            ++numberOfThrows;
+        }
+        EXPECT_EQ(numberOfThrows, 4);
+        EXPECT_EQ(ps.getVersion(), version + 1);
+
+        ps.clearSchedule("beer");
+        EXPECT_EQ(ps.compile().findDeal(beer, june1 + 18 * hour), beer);
+
+        /// The next customer on the lane isn't priced at the previous customer's time
+        Checkout lane(table);
+        lane.setTime(june1 + 18 * hour);
+        lane.scan("beer", 2);
+        EXPECT_EQ(lane.getTotal(), 300);
+        const std::int64_t before = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        lane.reset();
+        EXPECT_EQ(lane.getTime() >= before, true);
+        lane.scan("beer", 2);
+        EXPECT_EQ(lane.getTotal(), 600);
+    }
+};
+
+///@test Test Case for customer prices layered over a shared catalog
+class PricingOverlayTest : public Testing::TestCaseBase
+{
+public:
+    PricingOverlayTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~PricingOverlayTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        PricingScheme ps;
+        ps.addItem(Item("milk", Money(300), TaxClass()));
+        ps.addItem(Item("bread", Money(200), TaxClass(), {2, 1}));
+        ps.addItem(Item("eggs", Money(400), TaxClass()));
+        Catalog catalog(ps);
+        const std::shared_ptr<const PricingTable> base = catalog.snapshot();
+        const PricingTable::Index milk = base->find("milk");
+        const PricingTable::Index eggs = base->find("eggs");
+
+        /// Member price on milk and a coupon on eggs, caviar isn't in the catalog
+        PricingOverlay member;
+        member.setUnitPrice("milk", Money(250));
+        member.setPromotion("eggs", BuyXGetY{1, 1});
+        member.setUnitPrice("caviar", Money(1));
+        EXPECT_EQ(member.size(), static_cast<std::size_t>(3));
+        std::vector<PricingTable::Index> changed;
+        const PricingTable overlaid = member.compile(*base, changed);
+        EXPECT_EQ(changed.size(), static_cast<std::size_t>(2));
+        EXPECT_EQ(changed[0], milk);
+        EXPECT_EQ(changed[1], eggs);
+        EXPECT_EQ(overlaid.getNumberOfOverrides(), static_cast<std::size_t>(2));
+        EXPECT_EQ(overlaid.getImage(), base->getImage());
+        EXPECT_EQ(overlaid.getUnitPrice(milk), Money(250));
+        EXPECT_EQ(overlaid.hasBuyXGetY(eggs), true);
+        EXPECT_EQ(overlaid.getUnitPrice(eggs), Money(400));
+        EXPECT_EQ(overlaid.hasBuyXGetY(base->find("bread")), true);
+        EXPECT_EQ(base->getUnitPrice(milk), Money(300));
+        EXPECT_EQ(base->hasBuyXGetY(eggs), false);
+        EXPECT_EQ(base->getNumberOfOverrides(), static_cast<std::size_t>(0));
+
+        /// The customer taps their card halfway through the transaction
+        Checkout c(base);
+        c.scan("milk");
+        c.scan("bread", 3);
+        c.scan("eggs", 2);
+        EXPECT_EQ(c.getTotal(), 300 + 400 + 800);
+        c.applyOverlay(member);
+        EXPECT_EQ(c.getTotal(), 250 + 400 + 400);
+        Checkout other(base);
+        other.scan("milk");
+        EXPECT_EQ(other.getTotal(), 300);
+
+        /// Overlays stack: a bundle coupon on top of the member prices
+        PricingOverlay coupon;
+        coupon.setPromotion("milk", Bundle{"eggs", Money(500)});
+        coupon.setPromotion("eggs", Bundle{"milk", Money(500)});
+        c.applyOverlay(coupon);
+        EXPECT_EQ(c.getTotal(), 500 + 400 + 400);
+        c.scan("milk");
+        EXPECT_EQ(c.getTotal(), 1000 + 400);
+
+        /// The next customer starts from the catalog again
+        c.reset(catalog.snapshot());
+        c.scan("milk");
+        EXPECT_EQ(c.getTotal(), 300);
+    }
+};
+
+///@test Test Case for checkouts that fetch items from a catalog backend, many carts per thread
+class AsyncCheckoutTest : public Testing::TestCaseBase
+{
+public:
+    AsyncCheckoutTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~AsyncCheckoutTest() {}
+
+protected:
+    ///@brief Scans a cart, then stores its total
+    static CheckoutTask priceCart(AsyncCheckoutLoop &io_Loop, std::vector<std::string> i_Cart, int &o_Total)
+    {
+        AsyncCheckout checkout(io_Loop);
+        for (const auto &id : i_Cart)
+        {
+            co_await checkout.scan(id);
+        }
+        co_await checkout.scanWeight("3001", 250);
+        o_Total = checkout.getTotal();
+    }
+
+    ///@brief Fails after its first scan
+    static CheckoutTask failCart(AsyncCheckoutLoop &io_Loop)
+    {
+        AsyncCheckout checkout(io_Loop);
+        co_await checkout.scan("8873");
+        throw std::runtime_error("lane closed");
+    }
+
+    virtual void runTest() override
+    {
+        PricingScheme ps;
+        ps.setTaxRate(TaxClass(1), TaxRate(925));
+        ps.addItem(Item("1983", Money(199), TaxClass(), {2, 1}));   //toothbrush
+        ps.addItem(Item("6732", Money(249), {"4900", Money(499)})); //chips
+        ps.addItem(Item("4900", Money(349), {"6732", Money(499)})); //salsa
+        ps.addItem(Item("8873", Money(249), TaxClass()));           //milk
+        ps.addItem(Item("0923", Money(1549), TaxClass(1)));        //wine
+        ps.addItem(Item("3001", Money(899), TaxClass()));           //cheese, per kg
+        const auto table = std::make_shared<const PricingTable>(ps.compile());
+        const std::vector<std::string> ids = {"1983", "6732", "4900", "8873", "0923", "0000"};
+        FakeCatalogBackend backend(ps, std::chrono::milliseconds(2));
+
+        /// A bundle whose partner arrives in a later batch is repriced in the carts that hold it
+        {
+            AsyncCheckoutLoop loop(backend);
+            int total = 0;
+            loop.spawn(priceCart(loop, {"6732", "4900"}, total));
+            loop.run();
+            Checkout single(table);
+            single.scan("6732");
+            single.scan("4900");
+            single.scanWeight("3001", 250);
+            EXPECT_EQ(total, single.getTotal());
+            EXPECT_EQ(loop.getNumberOfBatches(), std::size_t(3));
+        }
+
+        /// Two lanes, each running many carts on one thread
+        const int numberOfThreads = 2;
+        const int numberOfCarts = 50;
+        std::vector<std::vector<std::string>> carts;
+        for (int cart = 0; cart < numberOfCarts; ++cart)
+        {
+            std::vector<std::string> scans;
+            for (int scan = 0; scan < 1 + cart % 7; ++scan)
+            {
+                scans.push_back(ids[(cart + 3 * scan) % ids.size()]);
+            }
+            carts.push_back(scans);
+        }
+        const std::size_t numberOfRequests = backend.getNumberOfRequests();
+        const std::size_t numberOfIdsRequested = backend.getNumberOfIdsRequested();
+        std::vector<std::vector<int>> totals(numberOfThreads, std::vector<int>(numberOfCarts, -1));
+        std::vector<std::size_t> numberOfBatches(numberOfThreads, 0);
+        std::vector<std::thread> lanes;
+        for (int thread = 0; thread < numberOfThreads; ++thread)
+        {
+            lanes.emplace_back([&, thread] {
+                AsyncCheckoutLoop loop(backend, 4);
+                for (int cart = 0; cart < numberOfCarts; ++cart)
+                {
+                    loop.spawn(priceCart(loop, carts[cart], totals[thread][cart]));
+                }
+                loop.run();
+                numberOfBatches[thread] = loop.getNumberOfBatches();
+            });
+        }
+        for (auto &lane : lanes)
+        {
+            lane.join();
+        }
+        for (int cart = 0; cart < numberOfCarts; ++cart)
+        {
+            Checkout single(table);
+            for (const auto &id : carts[cart])
+            {
+                single.scan(id);
+            }
+            single.scanWeight("3001", 250);
+            for (int thread = 0; thread < numberOfThreads; ++thread)
+            {
+                EXPECT_EQ(totals[thread][cart], single.getTotal());
+            }
+        }
+
+        /// Each lane requests each ID once, however many carts miss it, and batches the misses
+        EXPECT_EQ(backend.getNumberOfIdsRequested() - numberOfIdsRequested, std::size_t(numberOfThreads * (ids.size() + 1)));
+        EXPECT_EQ(backend.getNumberOfRequests() - numberOfRequests, numberOfBatches[0] + numberOfBatches[1]);
+        for (int thread = 0; thread < numberOfThreads; ++thread)
+        {
+            EXPECT_EQ(numberOfBatches[thread] <= ids.size() + 1, true);
+        }
+
+        /// What a cart throws is rethrown by run()
+        {
+            AsyncCheckoutLoop loop(backend);
+            loop.spawn(failCart(loop));
+            bool threw = false;
+            try
+            {
+                loop.run();
+            }
+            catch (std::runtime_error &)
+            {
+                threw = true;
+            }
+            EXPECT_EQ(threw, true);
+        }
+
+        /// A loop destroyed right after run() while the backend's thread is still finishing
+        /// the last callback (run under a sanitizer to catch a use after free)
+        FakeCatalogBackend instantBackend(ps, std::chrono::microseconds(0));
+        for (int cart = 0; cart < 200; ++cart)
+        {
+            int total = 0;
+            auto loop = std::make_unique<AsyncCheckoutLoop>(instantBackend);
+            loop->spawn(priceCart(*loop, {ids[cart % ids.size()]}, total));
+            loop->run();
+            loop.reset();
+            EXPECT_EQ(total > 0, true);
+        }
+    }
+};
+
+///@test Test Case for summing the deal outcomes of a batch of carts per item and per promotion
+class PromotionAnalyticsTest : public Testing::TestCaseBase
+{
+public:
+    PromotionAnalyticsTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~PromotionAnalyticsTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        PricingScheme ps;
+        ps.addItem(Item("1983", Money(199), TaxClass(), {2, 1}));   //toothbrush
+        ps.addItem(Item("6732", Money(249), {"4900", Money(499)})); //chips
+        ps.addItem(Item("4900", Money(349), {"6732", Money(499)})); //salsa
+        ps.addItem(Item("8873", Money(249), TaxClass()));           //milk
+        std::shared_ptr<const PricingTable> table = std::make_shared<const PricingTable>(ps.compile());
+        const PricingTable::Index toothbrush = table->find("1983");
+        const PricingTable::Index chips = table->find("6732");
+        const PricingTable::Index salsa = table->find("4900");
+        const PricingTable::Index milk = table->find("8873");
+
+        BatchPricer pricer(table, 4);
+        BatchPricer::PromotionReport report;
+        pricer.analyzeAll({{"1983", "1983", "1983", "8873"}, {"6732", "4900", "6732"}, {"9999"}}, report);
+        EXPECT_EQ(report.numberOfCarts, std::uint64_t(3));
+        EXPECT_EQ(report.items[toothbrush].numberOfUnits, std::uint64_t(3));
+        EXPECT_EQ(report.items[toothbrush].numberOfFreeUnits, std::uint64_t(1));
+        EXPECT_EQ(report.items[toothbrush].freeSavings, std::int64_t(199));
+        EXPECT_EQ(report.items[toothbrush].revenue, std::int64_t(398));
+        EXPECT_EQ(report.items[milk].numberOfLines, std::uint64_t(1));
+        EXPECT_EQ(report.items[milk].revenue, std::int64_t(249));
+        EXPECT_EQ(report.items[chips].numberOfBundles, std::uint64_t(1));
+        EXPECT_EQ(report.items[salsa].numberOfBundles, std::uint64_t(1));
+        EXPECT_EQ(report.promotions[static_cast<std::size_t>(PromotionKind::BUNDLE)].numberOfBundles, std::uint64_t(1));
+        EXPECT_EQ(report.items[chips].bundleSavings + report.items[salsa].bundleSavings, std::int64_t(249 + 349 - 499));
+        EXPECT_EQ(report.promotions[static_cast<std::size_t>(PromotionKind::BUNDLE)].revenue, std::int64_t(499 + 249));
+        EXPECT_EQ(report.promotions[static_cast<std::size_t>(PromotionKind::SIMPLE_PRICE)].numberOfUnits, std::uint64_t(1));
+
+        /// Batches add up into the same report, whatever the # of threads
+        std::mt19937 random(1983);
+        const std::vector<std::string> ids{"1983", "6732", "4900", "8873", "9999"};
+        std::vector<BatchPricer::Cart> carts(3000);
+        for (auto &cart : carts)
+        {
+            cart.resize(random() % 20);
+            for (auto &id : cart)
+            {
+                id = ids[random() % ids.size()];
+            }
+        }
+        BatchPricer::PromotionReport parallel;
+        pricer.analyzeAll(std::vector<BatchPricer::Cart>(carts.begin(), carts.begin() + 1000), parallel);
+        pricer.analyzeAll(std::vector<BatchPricer::Cart>(carts.begin() + 1000, carts.end()), parallel);
+        BatchPricer single(table, 1);
+        BatchPricer::PromotionReport sequential;
+        single.analyzeAll(carts, sequential);
+        EXPECT_EQ(parallel.numberOfCarts, sequential.numberOfCarts);
+        std::int64_t revenue = 0;
+        for (std::size_t item = 0; item < table->size(); ++item)
+        {
+            EXPECT_EQ(parallel.items[item].numberOfFreeUnits, sequential.items[item].numberOfFreeUnits);
+            EXPECT_EQ(parallel.items[item].numberOfBundles, sequential.items[item].numberOfBundles);
+            EXPECT_EQ(parallel.items[item].revenue, sequential.items[item].revenue);
+            revenue += parallel.items[item].revenue;
+        }
+
+        /// Without tax, the revenue is the total of the carts
+        Money total;
+        for (const Money cartTotal : pricer.priceAll(carts))
+        {
+            total += cartTotal;
+        }
+        EXPECT_EQ(revenue, total.getCents());
+
+        PricingScheme other;
+        other.addItem(Item("8873", Money(249), TaxClass()));
+        BatchPricer otherPricer(std::make_shared<const PricingTable>(other.compile()), 1);
+        bool threw = false;
+        try
+        {
+            otherPricer.analyzeAll(carts, parallel);
+        }
+        catch (std::runtime_error &)
+        {
+            threw = true;
+        }
+        EXPECT_EQ(threw, true);
+    }
+};
+
+///@test Test Case for rejecting Buy X Get Y deals that can't be priced
+class BuyXGetYValidationTest : public Testing::TestCaseBase
+{
+public:
+    BuyXGetYValidationTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~BuyXGetYValidationTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        const auto throws = [](const std::function<void()> &i_Function) {
+            try
+            {
+                i_Function();
+            }
+            catch (std::runtime_error &)
+            {
+                return true;
+            }
+            return false;
+        };
+        EXPECT_EQ(throws([] { Item("1983", Money(199), TaxClass(), {0, 1}); }), true);
+        EXPECT_EQ(throws([] { Item("1983", Money(199), TaxClass(), {-1, 2}); }), true);
+        EXPECT_EQ(throws([] { Item("1983", Money(199), TaxClass(), {2, -1}); }), true);
+        EXPECT_EQ(throws([] { Item("1983", Money(199), BuyXGetY{0, 0}); }), true);
+        /// {0, 0} is still no deal, and a deal with nothing free is every unit paid
+        EXPECT_EQ(throws([] { Item("1983", Money(199), TaxClass(), {0, 0}); }), false);
+        EXPECT_EQ(throws([] { Item("1983", Money(199), TaxClass(), {1, 0}); }), false);
+
+        PricingScheme ps;
+        ps.addItem(Item("1983", Money(199), TaxClass(), {1, 0})); //toothbrush
+        EXPECT_EQ(throws([&] { ps.schedulePromotion("1983", BuyXGetY{2, -3}, PromotionWindow{100, 200, 0, 0}); }), true);
+        EXPECT_EQ(throws([&] { ps.schedulePromotion("1983", BuyXGetY{0, 0}, PromotionWindow{100, 200, 0, 0}); }), true);
+
+        PricingOverlay overlay;
+        EXPECT_EQ(throws([&] { overlay.setPromotion("1983", BuyXGetY{0, 5}); }), true);
+        EXPECT_EQ(overlay.size(), static_cast<std::size_t>(0));
+
+        Checkout c(ps);
+        c.scan("1983");
+        c.scan("1983");
+        EXPECT_EQ(c.getTotal(), 398);
+    }
+};
+
+///@test Test Case for bundles the partner doesn't have
+class OneSidedBundleTest : public Testing::TestCaseBase
+{
+public:
+    OneSidedBundleTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~OneSidedBundleTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        /// Salsa is added before chips, and after, so each side has the lower index once
+        for (const bool isSalsaFirst : {true, false})
+        {
+            PricingScheme ps;
+            if (isSalsaFirst)
+            {
+                ps.addItem(Item("4900", Money(349), TaxClass()));       //salsa
+            }
+            ps.addItem(Item("6732", Money(249), {"4900", Money(499)})); //chips
+            if (!isSalsaFirst)
+            {
+                ps.addItem(Item("4900", Money(349), TaxClass()));       //salsa
+            }
+            ps.addItem(Item("1111", Money(100), {"6732", Money(50)}));  //dip, chips bundle with salsa
+            const auto table = std::make_shared<const PricingTable>(ps.compile());
+            EXPECT_EQ(table->findBundlePartner(table->find("6732"), table->find("6732"), 0), PricingTable::NO_INDEX);
+
+            /// Salsa doesn't name chips back, so chips are priced at their unit price, in
+            /// whichever order they are scanned
+            const std::vector<std::string> cart = {"4900", "6732", "1111", "6732", "4900"};
+            Checkout inOrder(table);
+            Checkout reversed(table);
+            ConcurrentCheckout shared(table, 2);
+            for (std::size_t i = 0; i < cart.size(); ++i)
+            {
+                inOrder.scan(cart[i]);
+                reversed.scan(cart[cart.size() - 1 - i]);
+                shared.scan(cart[i]);
+            }
+            const int total = 2 * 349 + 2 * 249 + 100;
+            EXPECT_EQ(inOrder.getTotal(), total);
+            EXPECT_EQ(reversed.getTotal(), total);
+            EXPECT_EQ(shared.getTotal(), total);
+            BatchPricer pricer(table, 1);
+            EXPECT_EQ(pricer.priceAll({cart})[0], Money(total));
+
+            /// Once salsa has the bundle too, it is in effect for the open cart
+            const std::uint64_t version = ps.getVersion();
+            ps.addItem(Item("4900", Money(349), {"6732", Money(499)}));
+            std::vector<PricingTable::Index> changed;
+            EXPECT_EQ(ps.getChangesSince(version, changed), true);
+            inOrder.update(std::make_shared<const PricingTable>(ps.compile()), changed);
+            EXPECT_EQ(inOrder.getTotal(), 2 * 499 + 100);
+
+            /// And priced at unit prices again once it drops it
+            ps.addItem(Item("4900", Money(349), TaxClass()));
+            EXPECT_EQ(ps.getChangesSince(version + 1, changed), true);
+            inOrder.update(std::make_shared<const PricingTable>(ps.compile()), changed);
+            EXPECT_EQ(inOrder.getTotal(), total);
+        }
+    }
+};
+
+///@test Test Case for open carts with an item that is removed from the catalog
+class RemovedItemTest : public Testing::TestCaseBase
+{
+public:
+    RemovedItemTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~RemovedItemTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        PricingScheme ps;
+        ps.setTaxRate(TaxClass(1), TaxRate(1000));
+        ps.addItem(Item("6732", Money(249), {"4900", Money(499)})); //chips
+        ps.addItem(Item("4900", Money(349), {"6732", Money(499)})); //salsa
+        ps.addItem(Item("8873", Money(250), TaxClass(1)));          //milk
+        const auto table = std::make_shared<const PricingTable>(ps.compile());
+
+        Checkout changedOnly(table);
+        Checkout everyLine(table);
+        for (Checkout *c : {&changedOnly, &everyLine})
+        {
+            for (const char *id : {"6732", "4900", "8873", "8873"})
+            {
+                c->scan(id);
+            }
+            EXPECT_EQ(c->getTotal(), 499 + 500 + 50);
+        }
+
+        /// Milk and salsa are taken off the shelves while the carts are open: their lines
+        /// are dropped rather than sold for nothing, and chips lose their bundle
+        const std::uint64_t version = ps.getVersion();
+        ps.removeItem("8873");
+        ps.removeItem("4900");
+        std::vector<PricingTable::Index> changed;
+        EXPECT_EQ(ps.getChangesSince(version, changed), true);
+        const auto newTable = std::make_shared<const PricingTable>(ps.compile());
+        EXPECT_EQ(newTable->isRemoved(table->find("4900")), true);
+        EXPECT_EQ(newTable->isRemoved(table->find("6732")), false);
+        changedOnly.update(newTable, changed);
+        everyLine.update(newTable);
+        EXPECT_EQ(changedOnly.getTotal(), 249);
+        EXPECT_EQ(everyLine.getTotal(), 249);
+
+        /// Same as the cart scanned again at the new table, where they aren't found
+        Checkout rescanned(newTable);
+        for (const char *id : {"6732", "4900", "8873", "8873"})
+        {
+            rescanned.scan(id);
+        }
+        EXPECT_EQ(rescanned.getTotal(), changedOnly.getTotal());
+
+        /// Once added back, they can be sold again
+        ps.addItem(Item("4900", Money(349), {"6732", Money(499)}));
+        EXPECT_EQ(ps.getChangesSince(version + 2, changed), true);
+        changedOnly.update(std::make_shared<const PricingTable>(ps.compile()), changed);
+        changedOnly.scan("4900");
+        EXPECT_EQ(changedOnly.getTotal(), 499);
+    }
+};
+
+///@test Test Case for loading corrupt catalog images without verifying the checksum
+class CorruptImageTest : public Testing::TestCaseBase
+{
+public:
+    CorruptImageTest() : Testing::TestCaseBase(__FUNCTION__) {}
+    virtual ~CorruptImageTest() {}
+
+protected:
+    virtual void runTest() override
+    {
+        PricingScheme ps;
+        ps.setTaxRate(TaxClass(1), TaxRate(925));
+        ps.addItem(Item("1983", Money(199), TaxClass(), {2, 1}));              //toothbrush
+        ps.addItem(Item("6732", Money(249), {"4900", Money(499)}));            //chips
+        ps.addItem(Item("4900", Money(349), {"6732", Money(499)}));            //salsa
+        ps.addItem(Item("4006381333931", Money(250), TaxClass(1)));            //EAN-13
+        ps.addItem(Item("036000291452", Money(100), TaxClass()));              //UPC-A
+        ps.schedulePromotion("4900", BuyXGetY{1, 1}, PromotionWindow{100, 200, 0, 0});
+        const PricingTable table = ps.compile();
+        const std::vector<std::string> ids = {"1983", "6732", "4900", "4006381333931", "036000291452", "0000"};
+        const std::size_t numberOfWords = table.getImageSize() / 8;
+
+        /// A corrupt image either throws, or every lookup stays within it (run under a
+        /// sanitizer to catch a read out of bounds) and terminates. Prices aren't checked,
+        /// so nothing is priced here
+        std::mt19937_64 random(1983);
+        int numberOfLoaded = 0;
+        for (int corruption = 0; corruption < 3000; ++corruption)
+        {
+            auto image = std::make_shared<std::vector<std::uint64_t>>(
+                static_cast<const std::uint64_t *>(table.getImage()),
+                static_cast<const std::uint64_t *>(table.getImage()) + numberOfWords);
+            unsigned char *bytes = reinterpret_cast<unsigned char *>(image->data());
+            for (std::uint64_t flip = 0; flip < 1 + random() % 4; ++flip)
+            {
+                bytes[random() % table.getImageSize()] ^= static_cast<unsigned char>(1 + random() % 255);
+            }
+            std::shared_ptr<const PricingTable> corrupt;
+            try
+            {
+                corrupt = std::make_shared<const PricingTable>(PricingTable::fromImage(image, image->data(), table.getImageSize(), false));
+            }
+            catch (std::runtime_error &)
+            {
+                continue;
+            }
+            ++numberOfLoaded;
+            for (PricingTable::Index index = 0; index < corrupt->size(); ++index)
+            {
+                corrupt->find(corrupt->getId(index));
+                corrupt->findBundlePartner(index, corrupt->findDeal(index, 150), 150);
+            }
+            corrupt->findBarcode(4006381333931ull);
+            corrupt->findBarcode(36000291452ull);
+            for (const auto &id : ids)
+            {
+                const PricingTable::Index index = corrupt->find(id);
+                if (PricingTable::NO_INDEX != index)
+                {
+                    corrupt->visitPromotion(corrupt->findDeal(index, 150), [](const auto &) {});
+                }
+            }
+        }
+        /// Most corruptions only change data the checksum would have caught
+        EXPECT_EQ(numberOfLoaded > 0, true);
+    }
+};
 #pragma endregion Testing_Namespace
 
 /// The following tests the Checkout, PricingScheme, and Item classes
@@ -399,6 +2304,62 @@ int main()
     superMarketTest.addTestCase(tc);
     tc = std::make_unique<BundledTest>();
     superMarketTest.addTestCase(tc);
+    tc = std::make_unique<CompiledPricingTableTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<CatalogSnapshotTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<RunningTotalTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<BulkQuantityTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<MoneyTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<BatchPricerTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<LineKernelTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<CatalogFileTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<ScanLogReaderTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<MetricsTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<PooledCheckoutTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<PromotionKindTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<PromotionEngineTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<ConcurrentCheckoutTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<DeltaRepricingTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<ReceiptTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<ScanJournalTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<BarcodeTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<DifferentialTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<TaxClassTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<ScheduledPromotionTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<PricingOverlayTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<AsyncCheckoutTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<PromotionAnalyticsTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<BuyXGetYValidationTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<OneSidedBundleTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<RemovedItemTest>();
+    superMarketTest.addTestCase(tc);
+    tc = std::make_unique<CorruptImageTest>();
+    superMarketTest.addTestCase(tc);
 
     superMarketTest.runAllTests();
     system("pause");
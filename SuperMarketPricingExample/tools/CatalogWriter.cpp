@@ -0,0 +1,149 @@
+// Local
+#include <CatalogFile.hpp>
+#include <Item.hpp>
+#include <PricingScheme.hpp>
+// Standard Library
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+///@brief Command line tool that compiles a catalog from a CSV export into the binary
+///       catalog format that lanes load with CatalogFile::load.
+///
+/// Usage: catalog_writer <catalog.csv> <catalog.bin>
+///
+/// One item per line, no header, integer fields:
+///     id,unitPriceCents,taxClass,buyX,getY,bundlePartnerId,bundlePriceCents
+/// e.g., "1983,199,0,2,1,," or "6732,249,0,0,0,4900,499", and the rate of each tax class
+/// (classes without a rate aren't taxed):
+///     tax,taxClass,taxBasisPoints
+/// e.g., "tax,1,925", and the deals scheduled for windows of time (see PromotionWindow,
+/// times in seconds since the epoch), after the line of their item:
+///     deal,id,start,end,period,until,buyX,getY,bundlePartnerId,bundlePriceCents
+/// e.g., "deal,1983,1748797200,1748804400,86400,1751328000,1,1,,". Lines starting with #
+/// are ignored.
+
+namespace
+{
+    ///@brief Splits a CSV line into its fields (no quoting support)
+    std::vector<std::string> splitFields(const std::string &i_Line)
+    {
+        std::vector<std::string> fields;
+        std::stringstream stream(i_Line);
+        std::string field;
+        while (std::getline(stream, field, ','))
+        {
+            fields.push_back(field);
+        }
+        if (!i_Line.empty() && ',' == i_Line.back())
+        {
+            fields.push_back(std::string());
+        }
+        return fields;
+    }
+
+    ///@brief Parses an integer field, empty fields are 0
+    long long toInteger(const std::string &i_Field)
+    {
+        return i_Field.empty() ? 0 : std::stoll(i_Field);
+    }
+
+    ///@brief Parses the promotion fields buyX,getY,bundlePartnerId,bundlePriceCents that
+    /// start at i_First
+    Promotion toPromotion(const std::vector<std::string> &i_Fields, const std::size_t i_First)
+    {
+        if (!i_Fields[i_First + 2].empty())
+        {
+            return Bundle{i_Fields[i_First + 2], Money(toInteger(i_Fields[i_First + 3]))};
+        }
+        const int buyX = static_cast<int>(toInteger(i_Fields[i_First]));
+        const int getY = static_cast<int>(toInteger(i_Fields[i_First + 1]));
+        return 0 == buyX && 0 == getY ? Promotion(SimplePrice()) : Promotion(BuyXGetY{buyX, getY});
+    }
+
+    ///@brief Parses a tax class field, empty fields are class 0
+    TaxClass toTaxClass(const std::string &i_Field)
+    {
+        const long long taxClass = toInteger(i_Field);
+        if (taxClass < 0 || taxClass >= static_cast<long long>(TaxClass::COUNT))
+        {
+            throw std::runtime_error("tax class out of range");
+        }
+        return TaxClass(static_cast<std::uint8_t>(taxClass));
+    }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (3 != argc)
+    {
+        std::cerr << "Usage: " << argv[0] << " <catalog.csv> <catalog.bin>" << std::endl;
+        return 1;
+    }
+
+    std::ifstream input(argv[1]);
+    if (!input)
+    {
+        std::cerr << "Can't open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    PricingScheme ps;
+    std::string line;
+    int lineNumber = 0;
+    try
+    {
+        while (std::getline(input, line))
+        {
+            ++lineNumber;
+            if (!line.empty() && '\r' == line.back())
+            {
+                line.pop_back();
+            }
+            if (line.empty() || '#' == line[0])
+            {
+                continue;
+            }
+
+            const std::vector<std::string> fields = splitFields(line);
+            if (!fields.empty() && "tax" == fields[0])
+            {
+                if (3 != fields.size())
+                {
+                    throw std::runtime_error("expected 3 fields");
+                }
+                ps.setTaxRate(toTaxClass(fields[1]), TaxRate(static_cast<std::int32_t>(toInteger(fields[2]))));
+                continue;
+            }
+            if (!fields.empty() && "deal" == fields[0])
+            {
+                if (10 != fields.size())
+                {
+                    throw std::runtime_error("expected 10 fields");
+                }
+                ps.schedulePromotion(
+                    fields[1],
+                    toPromotion(fields, 6),
+                    PromotionWindow{toInteger(fields[2]), toInteger(fields[3]), toInteger(fields[4]), toInteger(fields[5])});
+                continue;
+            }
+            if (7 != fields.size())
+            {
+                throw std::runtime_error("expected 7 fields");
+            }
+            ps.addItem(Item(fields[0], Money(toInteger(fields[1])), toPromotion(fields, 3), toTaxClass(fields[2])));
+        }
+
+        const PricingTable table = ps.compile();
+        CatalogFile::write(table, argv[2]);
+        std::cout << "Wrote " << table.size() << " items (" << table.getImageSize() << " bytes) to " << argv[2] << std::endl;
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << argv[1] << ":" << lineNumber << ": " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
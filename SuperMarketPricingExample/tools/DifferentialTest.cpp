@@ -0,0 +1,97 @@
+// Local
+#include <DifferentialTester.hpp>
+// Standard Library
+#include <chrono>
+#include <iostream>
+#include <string>
+
+///@brief Command line tool that runs the randomized differential test of the pricing
+///       engines (see DifferentialTester), e.g., a few million cases overnight.
+///
+/// Usage: difftest [--cases N] [--seed N] [--threads N] [--max-items N] [--max-scans N]
+///                 [--max-failures N]
+///
+/// Prints each failure shrunk to a minimal catalog and cart, and exits with 1 if any
+/// engine disagreed with the reference. A failure is reproduced with the same seed and
+/// options, its case # identifies it in the run.
+
+namespace
+{
+    ///@brief Parses the command line into o_Options
+    ///@return false if the command line is invalid
+    bool parseArguments(int argc, char *argv[], DifferentialTester::Options &o_Options)
+    {
+        for (int i = 1; i + 1 < argc; i += 2)
+        {
+            const std::string option = argv[i];
+            const std::string value = argv[i + 1];
+            if ("--cases" == option)
+            {
+                o_Options.numberOfCases = std::stoul(value);
+            }
+            else if ("--seed" == option)
+            {
+                o_Options.seed = std::stoull(value);
+            }
+            else if ("--threads" == option)
+            {
+                o_Options.numberOfThreads = static_cast<unsigned>(std::stoul(value));
+            }
+            else if ("--max-items" == option)
+            {
+                o_Options.maxItems = std::stoul(value);
+            }
+            else if ("--max-scans" == option)
+            {
+                o_Options.maxScans = std::stoul(value);
+            }
+            else if ("--max-failures" == option)
+            {
+                o_Options.maxFailures = std::stoul(value);
+            }
+            else
+            {
+                return false;
+            }
+        }
+        return 1 == argc % 2 && o_Options.maxItems > 0;
+    }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    DifferentialTester::Options options;
+    if (!parseArguments(argc, argv, options))
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--cases N] [--seed N] [--threads N] [--max-items N] [--max-scans N]"
+                     " [--max-failures N]"
+                  << std::endl;
+        return 1;
+    }
+
+    DifferentialTester tester(options);
+    tester.addDefaultEngines();
+    const auto start = std::chrono::steady_clock::now();
+    const DifferentialTester::Report report = tester.run();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << report.numberOfCases << " cases, " << report.numberOfComparisons << " comparisons in "
+              << seconds << " s (seed " << options.seed << ")" << std::endl;
+    for (const auto &failure : report.failures)
+    {
+        std::cout << std::endl
+                  << failure.engine << ", case " << failure.caseNumber << ": ";
+        if (failure.error.empty())
+        {
+            std::cout << "expected " << failure.expected << ", got " << failure.actual << std::endl;
+        }
+        else
+        {
+            std::cout << "threw \"" << failure.error << "\"" << std::endl;
+        }
+        std::cout << DifferentialTester::describe(failure.shrunk);
+    }
+    std::cout << (report.failures.empty() ? "No failures" : "FAILED") << std::endl;
+    return report.failures.empty() ? 0 : 1;
+}